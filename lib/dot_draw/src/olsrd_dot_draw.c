@@ -393,7 +393,7 @@ ipc_print_tc_link(struct autobuf *abuf, const struct tc_entry *entry, const stru
   struct lqtextbuffer lqbuffer;
 
   abuf_appendf(abuf, "\"%s\" -> \"%s\"[label=\"%s\"];\n", olsr_ip_to_string(&strbuf1, &entry->addr),
-               olsr_ip_to_string(&strbuf2, &dst_entry->T_dest_addr), get_linkcost_text(dst_entry->cost, false, &lqbuffer));
+               olsr_ip_to_string(&strbuf2, olsr_node_id_to_addr(dst_entry->T_dest_id)), get_linkcost_text(dst_entry->cost, false, &lqbuffer));
 }
 
 static void
@@ -1038,7 +1038,7 @@ build_topo_body(struct autobuf *abuf)
     OLSR_FOR_ALL_TC_EDGE_ENTRIES(tc, tc_edge) {
       if (tc_edge->edge_inv) {
         abuf_puts(abuf, "<tr>");
-        build_ipaddr_with_link(abuf, &tc_edge->T_dest_addr, -1);
+        build_ipaddr_with_link(abuf, olsr_node_id_to_addr(tc_edge->T_dest_id), -1);
         build_ipaddr_with_link(abuf, &tc->addr, -1);
         if (olsr_cnf->lq_level > 0) {
           struct lqtextbuffer lqbuffer1, lqbuffer2;
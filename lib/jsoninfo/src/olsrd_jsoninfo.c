@@ -86,6 +86,9 @@
 #include "lq_plugin.h"
 #include "common/autobuf.h"
 #include "gateway.h"
+#include "olsr_cookie.h"
+#include "parser.h"
+#include "lq_packet.h"
 
 #include "olsrd_jsoninfo.h"
 #include "olsrd_plugin.h"
@@ -123,6 +126,8 @@ static void ipc_print_mid(struct autobuf *);
 static void ipc_print_gateways(struct autobuf *);
 static void ipc_print_config(struct autobuf *);
 static void ipc_print_interfaces(struct autobuf *);
+static void ipc_print_memory(struct autobuf *);
+static void ipc_print_messages(struct autobuf *);
 static void ipc_print_plugins(struct autobuf *);
 static void ipc_print_olsrd_conf(struct autobuf *abuf);
 
@@ -137,19 +142,21 @@ static void ipc_print_olsrd_conf(struct autobuf *abuf);
 #define SIW_TOPOLOGY 0x0020
 #define SIW_GATEWAYS 0x0040
 #define SIW_INTERFACES 0x0080
-#define SIW_RUNTIME_ALL 0x00FF
+#define SIW_MEMORY 0x2000
+#define SIW_MESSAGES 0x4000
+#define SIW_RUNTIME_ALL 0x60FF
 
 /* these only change at olsrd startup */
 #define SIW_CONFIG 0x0100
 #define SIW_PLUGINS 0x0200
 #define SIW_STARTUP_ALL 0x0F00
 
-/* this is everything in JSON format */
-#define SIW_ALL 0x0FFF
-
 /* this data is not JSON format but olsrd.conf format */
 #define SIW_OLSRD_CONF 0x1000
 
+/* this is everything in JSON format */
+#define SIW_ALL ((SIW_RUNTIME_ALL | SIW_STARTUP_ALL) & ~SIW_OLSRD_CONF)
+
 #define MAX_CLIENTS 3
 
 static char *outbuffer[MAX_CLIENTS];
@@ -530,6 +537,8 @@ ipc_action(int fd, void *data __attribute__ ((unused)), unsigned int flags __att
         if (0 != strstr(requ, "/topology")) send_what |= SIW_TOPOLOGY;
         if (0 != strstr(requ, "/gateways")) send_what |= SIW_GATEWAYS;
         if (0 != strstr(requ, "/interfaces")) send_what |= SIW_INTERFACES;
+        if (0 != strstr(requ, "/memory")) send_what |= SIW_MEMORY;
+        if (0 != strstr(requ, "/messages")) send_what |= SIW_MESSAGES;
         if (0 != strstr(requ, "/config")) send_what |= SIW_CONFIG;
         if (0 != strstr(requ, "/plugins")) send_what |= SIW_PLUGINS;
       }
@@ -663,7 +672,7 @@ ipc_print_topology(struct autobuf *abuf)
         const char* lqs;
         abuf_json_open_array_entry(abuf);
         abuf_json_string(abuf, "destinationIP",
-                         olsr_ip_to_string(&dstbuf, &tc_edge->T_dest_addr));
+                         olsr_ip_to_string(&dstbuf, olsr_node_id_to_addr(tc_edge->T_dest_id)));
         abuf_json_string(abuf, "lastHopIP",
                          olsr_ip_to_string(&addrbuf, &tc->addr));
         lqs = get_tc_edge_entry_text(tc_edge, '\t', &lqbuffer1);
@@ -961,7 +970,22 @@ ipc_print_config(struct autobuf *abuf)
 
   // keep all time in ms, so convert these two, which are in seconds
   abuf_json_int(abuf, "pollRate", olsr_cnf->pollrate * 1000);
+  abuf_json_int(abuf, "inputBudget", olsr_cnf->input_budget);
   abuf_json_int(abuf, "nicChangePollInterval", olsr_cnf->nic_chgs_pollrate * 1000);
+  abuf_json_boolean(abuf, "linkFailureDetection", olsr_cnf->link_fail_detection);
+  abuf_json_int(abuf, "linkFailureDelay", olsr_cnf->link_fail_delay * 1000);
+  abuf_json_int(abuf, "adaptiveIntervals", olsr_cnf->adaptive_intervals);
+  abuf_json_int(abuf, "tcTriggerBurst", olsr_cnf->tc_trigger_burst);
+  abuf_json_int(abuf, "tcTriggerGap", olsr_cnf->tc_trigger_gap * 1000);
+  abuf_json_int(abuf, "memoryStatsInterval", olsr_cnf->mem_stats_interval);
+  abuf_json_int(abuf, "maxTcEntries", olsr_cnf->max_tc_entries);
+  abuf_json_int(abuf, "maxTcEdges", olsr_cnf->max_tc_edges);
+  abuf_json_int(abuf, "maxMidEntries", olsr_cnf->max_mid_entries);
+  abuf_json_int(abuf, "maxHnaNets", olsr_cnf->max_hna_nets);
+  abuf_json_int(abuf, "maxDupEntries", olsr_cnf->max_dup_entries);
+  abuf_json_int(abuf, "duplicateWindow", olsr_cnf->dup_window);
+  abuf_json_int(abuf, "tcDelta", olsr_cnf->tc_delta);
+  abuf_json_boolean(abuf, "compactAddresses", olsr_cnf->compact_addrs);
   abuf_json_boolean(abuf, "clearScreen", olsr_cnf->clear_screen);
   abuf_json_int(abuf, "tcRedundancy", olsr_cnf->tc_redundancy);
   abuf_json_int(abuf, "mprCoverage", olsr_cnf->mpr_coverage);
@@ -1116,9 +1140,21 @@ ipc_print_interfaces(struct autobuf *abuf)
       abuf_json_string(abuf, "nameFromKernel", rifs->int_name);
       abuf_json_int(abuf, "interfaceMode", rifs->mode);
       abuf_json_boolean(abuf, "emulatedHostClientInterface", rifs->is_hcif);
-      abuf_json_boolean(abuf, "sendTcImmediately", rifs->immediate_send_tc);
       abuf_json_int(abuf, "fishEyeTtlIndex", rifs->ttl_index);
-      abuf_json_int(abuf, "olsrForwardingTimeout", rifs->fwdtimer);
+      abuf_json_int(abuf, "olsrForwardingTimeout", rifs->netbuf.timer ? rifs->netbuf.deadline : 0);
+      abuf_json_int(abuf, "outputPackets", rifs->netbuf.packets);
+      abuf_json_int(abuf, "outputMessages", rifs->netbuf.messages);
+      abuf_json_float(abuf, "outputPacketsPerMessage",
+          rifs->netbuf.messages ? (float)rifs->netbuf.packets / rifs->netbuf.messages : 0);
+      abuf_json_int(abuf, "helloIntervalFactor", rifs->hello_factor);
+      abuf_json_int(abuf, "hellosSent", rifs->hello_sent);
+      abuf_json_int(abuf, "hellosFixedInterval", rifs->hello_nominal);
+      abuf_json_int(abuf, "tcIntervalFactor", rifs->tc_factor);
+      abuf_json_int(abuf, "tcsSent", rifs->tc_sent);
+      abuf_json_int(abuf, "tcsFixedInterval", rifs->tc_nominal);
+      abuf_json_int(abuf, "tcsTriggered", rifs->tc_triggered);
+      abuf_json_int(abuf, "tcsRateLimited", rifs->tc_limited);
+      abuf_json_int(abuf, "tcDelayAverage", rifs->tc_delay_count ? rifs->tc_delay_sum / rifs->tc_delay_count : 0);
       abuf_json_int(abuf, "olsrMessageSequenceNumber", rifs->olsr_seqnum);
       abuf_json_int(abuf, "olsrInterfaceMetric", rifs->int_metric);
       abuf_json_int(abuf, "olsrMTU", rifs->int_mtu);
@@ -1208,6 +1244,108 @@ ipc_print_interfaces(struct autobuf *abuf)
 }
 
 
+static void
+ipc_print_memory(struct autobuf *abuf)
+{
+  struct olsr_table_sizes sizes;
+  struct olsr_cookie_info *ci;
+  olsr_cookie_t ci_id;
+
+  abuf_json_open_array(abuf, "memory");
+  for (ci_id = 1; ci_id < COOKIE_ID_MAX; ci_id++) {
+    if ((ci = olsr_cookie_lookup(ci_id)) == NULL) {
+      continue;
+    }
+    abuf_json_open_array_entry(abuf);
+    abuf_json_string(abuf, "name", ci->ci_name);
+    abuf_json_string(abuf, "type", ci->ci_type == OLSR_COOKIE_TYPE_MEMORY ? "memory" : "timer");
+    abuf_json_int(abuf, "used", ci->ci_usage);
+    abuf_json_int(abuf, "peak", ci->ci_usage_peak);
+    abuf_json_int(abuf, "allocRate", ci->ci_alloc_rate);
+    if (ci->ci_type == OLSR_COOKIE_TYPE_MEMORY) {
+      abuf_json_int(abuf, "size", ci->ci_size);
+      abuf_json_int(abuf, "usedBytes", ci->ci_usage * ci->ci_size);
+      abuf_json_int(abuf, "free", ci->ci_free_list_usage);
+      abuf_json_int(abuf, "slabs", ci->ci_slab_count);
+      abuf_json_int(abuf, "bytes", olsr_cookie_mem_footprint(ci));
+      abuf_json_int(abuf, "budget", ci->ci_budget);
+      abuf_json_int(abuf, "refused", ci->ci_refused);
+      abuf_json_int(abuf, "evicted", ci->ci_evicted);
+    }
+    abuf_json_close_array_entry(abuf);
+  }
+  abuf_json_close_array(abuf);
+
+  olsr_get_table_sizes(&sizes);
+  abuf_json_open_array(abuf, "tableSizes");
+  abuf_json_open_array_entry(abuf);
+  abuf_json_int(abuf, "topology", sizes.tc);
+  abuf_json_int(abuf, "topologyEdges", sizes.tc_edge);
+  abuf_json_int(abuf, "mid", sizes.mid);
+  abuf_json_int(abuf, "midAliases", sizes.mid_alias);
+  abuf_json_int(abuf, "hnaGateways", sizes.hna_gw);
+  abuf_json_int(abuf, "hnaNetworks", sizes.hna_net);
+  abuf_json_int(abuf, "links", sizes.link);
+  abuf_json_int(abuf, "duplicates", sizes.dup);
+  abuf_json_int(abuf, "routes", sizes.rt);
+  abuf_json_int(abuf, "routePaths", sizes.rt_path);
+  abuf_json_close_array_entry(abuf);
+  abuf_json_close_array(abuf);
+}
+
+static void
+ipc_print_messages(struct autobuf *abuf)
+{
+  const struct parser_msg_stats *stats;
+  const struct parser_class_stats *cstats;
+  enum parser_class cls;
+  char key[32];
+  int type, bucket;
+
+  abuf_json_open_array(abuf, "messages");
+  for (type = 0; type < 256; type++) {
+    stats = olsr_parser_get_stats(type);
+    if (stats->received == 0) {
+      continue;
+    }
+    abuf_json_open_array_entry(abuf);
+    abuf_json_int(abuf, "type", type);
+    abuf_json_string(abuf, "name", olsr_msgtype_to_string(type));
+    abuf_json_int(abuf, "received", stats->received);
+    abuf_json_int(abuf, "processed", stats->processed);
+    for (bucket = 0; bucket < PARSER_HISTOGRAM_BUCKETS - 1; bucket++) {
+      snprintf(key, sizeof(key), "timeBelow%uus", 1U << (2 * bucket));
+      abuf_json_int(abuf, key, stats->histogram[bucket]);
+    }
+    snprintf(key, sizeof(key), "timeAbove%uus", 1U << (2 * (PARSER_HISTOGRAM_BUCKETS - 2)));
+    abuf_json_int(abuf, key, stats->histogram[bucket]);
+    abuf_json_close_array_entry(abuf);
+  }
+  abuf_json_close_array(abuf);
+
+  abuf_json_open_array(abuf, "input");
+  for (cls = 0; cls < PARSER_CLASSES; cls++) {
+    cstats = olsr_parser_get_class_stats(cls);
+    abuf_json_open_array_entry(abuf);
+    abuf_json_string(abuf, "class", olsr_parser_class_to_string(cls));
+    abuf_json_int(abuf, "queued", cstats->queued);
+    abuf_json_int(abuf, "processed", cstats->processed);
+    abuf_json_int(abuf, "rateDrops", cstats->rate_drops);
+    abuf_json_int(abuf, "queueDrops", cstats->full_drops);
+    abuf_json_int(abuf, "waiting", cstats->length);
+    abuf_json_close_array_entry(abuf);
+  }
+  abuf_json_close_array(abuf);
+
+  abuf_json_open_object(abuf, "tcAirtime");
+  abuf_json_int(abuf, "fullMessages", lq_tc_delta_stats.full_msgs);
+  abuf_json_int(abuf, "fullBytes", lq_tc_delta_stats.full_bytes);
+  abuf_json_int(abuf, "deltaMessages", lq_tc_delta_stats.delta_msgs);
+  abuf_json_int(abuf, "deltaBytes", lq_tc_delta_stats.delta_bytes);
+  abuf_json_int(abuf, "savedBytes", lq_tc_delta_stats.saved_bytes);
+  abuf_json_close_object(abuf);
+}
+
 static void
 ipc_print_olsrd_conf(struct autobuf *abuf)
 {
@@ -1293,6 +1431,8 @@ send_info(unsigned int send_what, int the_socket)
   if ((send_what & SIW_ROUTES) == SIW_ROUTES) ipc_print_routes(&abuf);
   if ((send_what & SIW_GATEWAYS) == SIW_GATEWAYS) ipc_print_gateways(&abuf);
   if ((send_what & SIW_INTERFACES) == SIW_INTERFACES) ipc_print_interfaces(&abuf);
+  if ((send_what & SIW_MEMORY) == SIW_MEMORY) ipc_print_memory(&abuf);
+  if ((send_what & SIW_MESSAGES) == SIW_MESSAGES) ipc_print_messages(&abuf);
   if ((send_what & SIW_CONFIG) == SIW_CONFIG) {
     if (send_what != SIW_CONFIG) abuf_puts(&abuf, ",");
     ipc_print_config(&abuf);
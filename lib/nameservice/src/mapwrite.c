@@ -157,7 +157,7 @@ mapwrite_work(FILE * fmap)
   OLSR_FOR_ALL_TC_ENTRIES(tc) {
     OLSR_FOR_ALL_TC_EDGE_ENTRIES(tc, tc_edge) {
       char *lla = lookup_position_latlon(&tc->addr);
-      char *llb = lookup_position_latlon(&tc_edge->T_dest_addr);
+      char *llb = lookup_position_latlon(olsr_node_id_to_addr(tc_edge->T_dest_id));
       if (NULL != lla && NULL != llb) {
         struct lqtextbuffer lqbuffer, lqbuffer2;
 
@@ -165,7 +165,7 @@ mapwrite_work(FILE * fmap)
          * To speed up processing, Links with both positions are named PLink()
          */
         if (0 >
-            fprintf(fmap, "PLink('%s','%s',%s,%s,%s,%s);\n", olsr_ip_to_string(&strbuf1, &tc_edge->T_dest_addr),
+            fprintf(fmap, "PLink('%s','%s',%s,%s,%s,%s);\n", olsr_ip_to_string(&strbuf1, olsr_node_id_to_addr(tc_edge->T_dest_id)),
                     olsr_ip_to_string(&strbuf2, &tc->addr), get_tc_edge_entry_text(tc_edge, ',', &lqbuffer2),
                     get_linkcost_text(tc_edge->cost, false, &lqbuffer), lla, llb)) {
           return;
@@ -177,7 +177,7 @@ mapwrite_work(FILE * fmap)
          * If one link end pos is unkown, only send Link()
          */
         if (0 >
-            fprintf(fmap, "Link('%s','%s',%s,%s);\n", olsr_ip_to_string(&strbuf1, &tc_edge->T_dest_addr),
+            fprintf(fmap, "Link('%s','%s',%s,%s);\n", olsr_ip_to_string(&strbuf1, olsr_node_id_to_addr(tc_edge->T_dest_id)),
                     olsr_ip_to_string(&strbuf2, &tc->addr), get_tc_edge_entry_text(tc_edge, ',', &lqbuffer2),
                     get_linkcost_text(tc_edge->cost, false, &lqbuffer))) {
           return;
@@ -81,6 +81,9 @@
 #include "lq_plugin.h"
 #include "common/autobuf.h"
 #include "gateway.h"
+#include "olsr_cookie.h"
+#include "parser.h"
+#include "lq_packet.h"
 
 #include "olsrd_txtinfo.h"
 #include "olsrd_plugin.h"
@@ -116,6 +119,10 @@ static void ipc_print_config(struct autobuf *);
 
 static void ipc_print_interface(struct autobuf *);
 
+static void ipc_print_memory(struct autobuf *);
+
+static void ipc_print_messages(struct autobuf *);
+
 #define TXT_IPC_BUFSIZE 256
 
 #define SIW_NEIGH 0x0001
@@ -129,6 +136,8 @@ static void ipc_print_interface(struct autobuf *);
 #define SIW_CONFIG 0x0100
 #define SIW_2HOP 0x0200
 #define SIW_VERSION 0x0400
+#define SIW_MEMORY 0x0800
+#define SIW_MESSAGES 0x1000
 
 /* ALL = neigh link route hna mid topo */
 #define SIW_ALL 0x003F
@@ -327,6 +336,8 @@ ipc_action(int fd, void *data __attribute__ ((unused)), unsigned int flags __att
         if (0 != strstr(requ, "/int")) send_what |= SIW_INTERFACE;
         if (0 != strstr(requ, "/2ho")) send_what |= SIW_2HOP;
         if (0 != strstr(requ, "/ver")) send_what |= SIW_VERSION;
+        if (0 != strstr(requ, "/mem")) send_what |= SIW_MEMORY;
+        if (0 != strstr(requ, "/msg")) send_what |= SIW_MESSAGES;
       }
     }
     if ( send_what == 0 ) send_what = SIW_ALL;
@@ -442,13 +453,13 @@ ipc_print_topology(struct autobuf *abuf)
 #ifdef ACTIVATE_VTIME_TXTINFO
         uint32_t vt = tc->validity_timer != NULL ? (tc->validity_timer->timer_clock - now_times) : 0;
         int diff = (int)(vt);
-        abuf_appendf(abuf, "%s\t%s\t%s\t%s\t%d.%03d\n", olsr_ip_to_string(&dstbuf, &tc_edge->T_dest_addr),
+        abuf_appendf(abuf, "%s\t%s\t%s\t%s\t%d.%03d\n", olsr_ip_to_string(&dstbuf, olsr_node_id_to_addr(tc_edge->T_dest_id)),
             olsr_ip_to_string(&addrbuf, &tc->addr),
             get_tc_edge_entry_text(tc_edge, '\t', &lqbuffer1),
             get_linkcost_text(tc_edge->cost, false, &lqbuffer2),
             diff/1000, diff%1000);
 #else /* ACTIVATE_VTIME_TXTINFO */
-        abuf_appendf(abuf, "%s\t%s\t%s\t%s\n", olsr_ip_to_string(&dstbuf, &tc_edge->T_dest_addr), olsr_ip_to_string(&addrbuf, &tc->addr),
+        abuf_appendf(abuf, "%s\t%s\t%s\t%s\n", olsr_ip_to_string(&dstbuf, olsr_node_id_to_addr(tc_edge->T_dest_id)), olsr_ip_to_string(&addrbuf, &tc->addr),
                   get_tc_edge_entry_text(tc_edge, '\t', &lqbuffer1), get_linkcost_text(tc_edge->cost, false, &lqbuffer2));
 #endif /* ACTIVATE_VTIME_TXTINFO */
       }
@@ -655,6 +666,107 @@ ipc_print_interface(struct autobuf *abuf)
   abuf_puts(abuf, "\n");
 }
 
+static void
+ipc_print_memory(struct autobuf *abuf)
+{
+  struct olsr_table_sizes sizes;
+  struct olsr_cookie_info *ci;
+  olsr_cookie_t ci_id;
+
+  abuf_puts(abuf, "Table: Memory\nName\tType\tSize\tUsed\tPeak\tFree\tSlabs\tBytes\tAllocs/s\tBudget\tRefused\tEvicted\n");
+  for (ci_id = 1; ci_id < COOKIE_ID_MAX; ci_id++) {
+    if ((ci = olsr_cookie_lookup(ci_id)) == NULL) {
+      continue;
+    }
+    if (ci->ci_type == OLSR_COOKIE_TYPE_MEMORY) {
+      abuf_appendf(abuf, "%s\tmemory\t%lu\t%u\t%u\t%u\t%u\t%lu\t%u\t%u\t%u\t%u\n", ci->ci_name, (unsigned long)ci->ci_size,
+                   ci->ci_usage, ci->ci_usage_peak, ci->ci_free_list_usage, ci->ci_slab_count,
+                   (unsigned long)olsr_cookie_mem_footprint(ci), ci->ci_alloc_rate, ci->ci_budget, ci->ci_refused,
+                   ci->ci_evicted);
+    } else {
+      abuf_appendf(abuf, "%s\ttimer\t-\t%u\t%u\t-\t-\t-\t%u\t-\t-\t-\n", ci->ci_name, ci->ci_usage, ci->ci_usage_peak,
+                   ci->ci_alloc_rate);
+    }
+  }
+  abuf_puts(abuf, "\n");
+
+  olsr_get_table_sizes(&sizes);
+  abuf_puts(abuf, "Table: Table sizes\nTable\tEntries\n");
+  abuf_appendf(abuf, "TC\t%u\n", sizes.tc);
+  abuf_appendf(abuf, "TC edges\t%u\n", sizes.tc_edge);
+  abuf_appendf(abuf, "MID\t%u\n", sizes.mid);
+  abuf_appendf(abuf, "MID aliases\t%u\n", sizes.mid_alias);
+  abuf_appendf(abuf, "HNA gateways\t%u\n", sizes.hna_gw);
+  abuf_appendf(abuf, "HNA networks\t%u\n", sizes.hna_net);
+  abuf_appendf(abuf, "Links\t%u\n", sizes.link);
+  abuf_appendf(abuf, "Duplicates\t%u\n", sizes.dup);
+  abuf_appendf(abuf, "Routes\t%u\n", sizes.rt);
+  abuf_appendf(abuf, "Route paths\t%u\n", sizes.rt_path);
+  abuf_puts(abuf, "\n");
+}
+
+static void
+ipc_print_messages(struct autobuf *abuf)
+{
+  const struct parser_msg_stats *stats;
+  const struct parser_class_stats *cstats;
+  const struct interface *ifn;
+  enum parser_class cls;
+  int type, bucket;
+
+  abuf_puts(abuf, "Table: Messages\nType\tName\tReceived\tProcessed");
+  for (bucket = 0; bucket < PARSER_HISTOGRAM_BUCKETS - 1; bucket++) {
+    abuf_appendf(abuf, "\t<%uus", 1U << (2 * bucket));
+  }
+  abuf_appendf(abuf, "\t>=%uus\n", 1U << (2 * (PARSER_HISTOGRAM_BUCKETS - 2)));
+
+  for (type = 0; type < 256; type++) {
+    stats = olsr_parser_get_stats(type);
+    if (stats->received == 0) {
+      continue;
+    }
+    abuf_appendf(abuf, "%d\t%s\t%u\t%u", type, olsr_msgtype_to_string(type), stats->received, stats->processed);
+    for (bucket = 0; bucket < PARSER_HISTOGRAM_BUCKETS; bucket++) {
+      abuf_appendf(abuf, "\t%u", stats->histogram[bucket]);
+    }
+    abuf_puts(abuf, "\n");
+  }
+  abuf_puts(abuf, "\n");
+
+  abuf_puts(abuf, "Table: Input\nClass\tQueued\tProcessed\tRate drops\tQueue drops\tWaiting\n");
+  for (cls = 0; cls < PARSER_CLASSES; cls++) {
+    cstats = olsr_parser_get_class_stats(cls);
+    abuf_appendf(abuf, "%s\t%u\t%u\t%u\t%u\t%u\n", olsr_parser_class_to_string(cls), cstats->queued,
+                 cstats->processed, cstats->rate_drops, cstats->full_drops, cstats->length);
+  }
+  abuf_puts(abuf, "\n");
+
+  abuf_puts(abuf, "Table: TC Airtime\nFull\tFull bytes\tDelta\tDelta bytes\tSaved bytes\n");
+  abuf_appendf(abuf, "%u\t%llu\t%u\t%llu\t%llu\n\n", lq_tc_delta_stats.full_msgs,
+               (unsigned long long)lq_tc_delta_stats.full_bytes, lq_tc_delta_stats.delta_msgs,
+               (unsigned long long)lq_tc_delta_stats.delta_bytes, (unsigned long long)lq_tc_delta_stats.saved_bytes);
+
+  abuf_puts(abuf, "Table: Output\nInterface\tPackets\tMessages\tPackets/Msg\n");
+  for (ifn = ifnet; ifn != NULL; ifn = ifn->int_next) {
+    abuf_appendf(abuf, "%s\t%u\t%u\t%.2f\n", ifn->int_name, ifn->netbuf.packets, ifn->netbuf.messages,
+                 ifn->netbuf.messages ? (double)ifn->netbuf.packets / ifn->netbuf.messages : 0.0);
+  }
+  abuf_puts(abuf, "\n");
+
+  abuf_puts(abuf, "Table: Intervals\nInterface\tHELLO factor\tHELLOs\tHELLOs fixed\tTC factor\tTCs\tTCs fixed\n");
+  for (ifn = ifnet; ifn != NULL; ifn = ifn->int_next) {
+    abuf_appendf(abuf, "%s\t%u\t%u\t%u\t%u\t%u\t%u\n", ifn->int_name, ifn->hello_factor, ifn->hello_sent,
+                 ifn->hello_nominal, ifn->tc_factor, ifn->tc_sent, ifn->tc_nominal);
+  }
+  abuf_puts(abuf, "\n");
+
+  abuf_puts(abuf, "Table: Triggered TCs\nInterface\tTriggered\tPeriodic\tRate limited\tAvg delay ms\n");
+  for (ifn = ifnet; ifn != NULL; ifn = ifn->int_next) {
+    abuf_appendf(abuf, "%s\t%u\t%u\t%u\t%u\n", ifn->int_name, ifn->tc_triggered, ifn->tc_sent - ifn->tc_triggered,
+                 ifn->tc_limited, ifn->tc_delay_count ? ifn->tc_delay_sum / ifn->tc_delay_count : 0);
+  }
+  abuf_puts(abuf, "\n");
+}
 
 static void
 txtinfo_write_data(void *foo __attribute__ ((unused))) {
@@ -743,6 +855,10 @@ send_info(unsigned int send_what, int the_socket)
   if ((send_what & SIW_2HOP) == SIW_2HOP) ipc_print_neigh(&abuf,true);
   /* version */
   if ((send_what & SIW_VERSION) == SIW_VERSION) ipc_print_version(&abuf);
+  /* memory statistics */
+  if ((send_what & SIW_MEMORY) == SIW_MEMORY) ipc_print_memory(&abuf);
+  /* message statistics */
+  if ((send_what & SIW_MESSAGES) == SIW_MESSAGES) ipc_print_messages(&abuf);
 
   assert(outbuffer_count < MAX_CLIENTS);
 
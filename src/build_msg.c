@@ -46,6 +46,7 @@
 #include "mantissa.h"
 #include "net_olsr.h"
 #include "gateway.h"
+#include "lq_packet.h"
 
 #define BMSG_DBGLVL 5
 
@@ -92,6 +93,12 @@ static bool serialize_mid6(struct interface *);
 
 static bool serialize_hna6(struct interface *);
 
+/* Any IP version, with compact addresses */
+
+static bool serialize_mid_compact(struct interface *);
+
+static bool serialize_hna_compact(struct interface *);
+
 /**
  * Set the timer that controls the generation of
  * empty TC messages
@@ -134,7 +141,7 @@ queue_hello(struct hello_message * message, struct interface * ifp)
   OLSR_PRINTF(BMSG_DBGLVL, "Building HELLO on %s\n-------------------\n", ifp->int_name);
 #endif /* DEBUG */
 
-  switch (olsr_cnf->ip_version) {
+  switch (OLSR_IP_VERSION) {
   case (AF_INET6):
     return serialize_hello6(message, ifp);
   case (AF_INET):
@@ -164,7 +171,7 @@ queue_tc(struct tc_message * message, struct interface * ifp)
   OLSR_PRINTF(BMSG_DBGLVL, "Building TC on %s\n-------------------\n", ifp->int_name);
 #endif /* DEBUG */
 
-  switch (olsr_cnf->ip_version) {
+  switch (OLSR_IP_VERSION) {
   case (AF_INET6):
     return serialize_tc6(message, ifp);
   case (AF_INET):
@@ -189,7 +196,11 @@ queue_mid(struct interface * ifp)
   OLSR_PRINTF(BMSG_DBGLVL, "Building MID on %s\n-------------------\n", ifp->int_name);
 #endif /* DEBUG */
 
-  switch (olsr_cnf->ip_version) {
+  if (olsr_cnf->compact_addrs && serialize_mid_compact(ifp)) {
+    return true;
+  }
+
+  switch (OLSR_IP_VERSION) {
   case (AF_INET6):
     return serialize_mid6(ifp);
   case (AF_INET):
@@ -213,7 +224,12 @@ queue_hna(struct interface * ifp)
   OLSR_PRINTF(BMSG_DBGLVL, "Building HNA on %s\n-------------------\n", ifp->int_name);
 #endif /* DEBUG */
 
-  switch (olsr_cnf->ip_version) {
+  /* like serialize_hna4() and serialize_hna6() */
+  if (olsr_cnf->compact_addrs && serialize_hna_compact(ifp)) {
+    return false;
+  }
+
+  switch (OLSR_IP_VERSION) {
   case (AF_INET6):
     return serialize_hna6(ifp);
   case (AF_INET):
@@ -237,6 +253,51 @@ check_buffspace(int msgsize, int buffsize, const char *type)
   }
 }
 
+/*
+ * The netmask advertised for a HNA entry
+ */
+static void
+hna_netmask(struct ip_prefix_list *h, union olsr_ip_addr *netmask)
+{
+  olsr_prefix_to_netmask(netmask, h->net.prefix_len);
+#ifdef __linux__
+  if (olsr_cnf->smart_gw_active && is_prefix_inetgw(&h->net)) {
+    /* this is the default route, overwrite it with the smart gateway */
+    olsr_modifiy_inetgw_netmask(netmask, h->net.prefix_len);
+  }
+#endif /* __linux__ */
+}
+
+/*
+ * Fill the header of a message with compact addresses,
+ * returns the start of its body.
+ */
+static uint8_t *
+serialize_compact_header(uint8_t type, uint8_t vtime, int size)
+{
+  union olsr_message *m = (union olsr_message *)msg_buffer;
+
+  if (OLSR_IP_VERSION == AF_INET) {
+    m->v4.olsr_msgtype = type;
+    m->v4.olsr_vtime = vtime;
+    m->v4.olsr_msgsize = htons(size);
+    m->v4.originator = olsr_cnf->main_addr.v4.s_addr;
+    m->v4.ttl = MAX_TTL;
+    m->v4.hopcnt = 0;
+    m->v4.seqno = htons(get_msg_seqno());
+    return msg_buffer + OLSR_IPV4_HDRSIZE;
+  }
+
+  m->v6.olsr_msgtype = type;
+  m->v6.olsr_vtime = vtime;
+  m->v6.olsr_msgsize = htons(size);
+  m->v6.originator = olsr_cnf->main_addr.v6;
+  m->v6.ttl = MAX_TTL;
+  m->v6.hopcnt = 0;
+  m->v6.seqno = htons(get_msg_seqno());
+  return msg_buffer + OLSR_IPV6_HDRSIZE;
+}
+
 /**
  * IP version 4
  *
@@ -259,7 +320,7 @@ serialize_hello4(struct hello_message *message, struct interface *ifp)
   int i, j;
   bool first_entry;
 
-  if ((!message) || (!ifp) || (olsr_cnf->ip_version != AF_INET))
+  if ((!message) || (!ifp) || (OLSR_IP_VERSION != AF_INET))
     return false;
 
   remainsize = net_outbuffer_bytes_left(ifp);
@@ -336,7 +397,7 @@ serialize_hello4(struct hello_message *message, struct interface *ifp)
          * a group, we must check for an extra
          * 4 bytes
          */
-        if ((curr_size + olsr_cnf->ipsize + (first_entry ? 4 : 0)) > remainsize) {
+        if ((curr_size + OLSR_IPSIZE + (first_entry ? 4 : 0)) > remainsize) {
           /* Only send partial HELLO if it contains data */
           if (curr_size > OLSR_HELLO_IPV4_HDRSIZE) {
 #ifdef DEBUG
@@ -365,7 +426,7 @@ serialize_hello4(struct hello_message *message, struct interface *ifp)
           remainsize = net_outbuffer_bytes_left(ifp);
 
           /* Sanity check */
-          check_buffspace(curr_size + olsr_cnf->ipsize + 4, remainsize, "HELLO2");
+          check_buffspace(curr_size + OLSR_IPSIZE + 4, remainsize, "HELLO2");
         }
 
         if (first_entry) {
@@ -378,8 +439,8 @@ serialize_hello4(struct hello_message *message, struct interface *ifp)
         memcpy(haddr, &nb->address, sizeof(union olsr_ip_addr));
 
         /* Point to next address */
-        haddr += olsr_cnf->ipsize;
-        curr_size += olsr_cnf->ipsize;  /* IP address added */
+        haddr += OLSR_IPSIZE;
+        curr_size += OLSR_IPSIZE;  /* IP address added */
 
         first_entry = false;
       }
@@ -425,7 +486,7 @@ serialize_hello6(struct hello_message *message, struct interface *ifp)
   int i, j;
   bool first_entry;
 
-  if ((!message) || (!ifp) || (olsr_cnf->ip_version != AF_INET6))
+  if ((!message) || (!ifp) || (OLSR_IP_VERSION != AF_INET6))
     return false;
 
   remainsize = net_outbuffer_bytes_left(ifp);
@@ -438,7 +499,7 @@ serialize_hello6(struct hello_message *message, struct interface *ifp)
     net_output(ifp);
     remainsize = net_outbuffer_bytes_left(ifp);
   }
-  check_buffspace(curr_size + olsr_cnf->ipsize + 4, remainsize, "HELLO");
+  check_buffspace(curr_size + OLSR_IPSIZE + 4, remainsize, "HELLO");
 
   h6 = &m->v6.message.hello;
   hinfo6 = h6->hell_info;
@@ -493,7 +554,7 @@ serialize_hello6(struct hello_message *message, struct interface *ifp)
          * a group, we must check for an extra
          * 4 bytes
          */
-        if ((curr_size + olsr_cnf->ipsize + (first_entry ? 4 : 0)) > remainsize) {
+        if ((curr_size + OLSR_IPSIZE + (first_entry ? 4 : 0)) > remainsize) {
           /* Only send partial HELLO if it contains data */
           if (curr_size > OLSR_HELLO_IPV6_HDRSIZE) {
 #ifdef DEBUG
@@ -520,7 +581,7 @@ serialize_hello6(struct hello_message *message, struct interface *ifp)
           /* Reset size and pointers */
           remainsize = net_outbuffer_bytes_left(ifp);
 
-          check_buffspace(curr_size + olsr_cnf->ipsize + 4, remainsize, "HELLO2");
+          check_buffspace(curr_size + OLSR_IPSIZE + 4, remainsize, "HELLO2");
 
         }
 
@@ -535,7 +596,7 @@ serialize_hello6(struct hello_message *message, struct interface *ifp)
 
         /* Point to next address */
         haddr++;
-        curr_size += olsr_cnf->ipsize;  /* IP address added */
+        curr_size += OLSR_IPSIZE;  /* IP address added */
 
         first_entry = false;
       }                         /* looping trough neighbors */
@@ -581,7 +642,7 @@ serialize_tc4(struct tc_message *message, struct interface *ifp)
   struct neigh_info *mprsaddr;
   bool found = false, partial_sent = false;
 
-  if ((!message) || (!ifp) || (olsr_cnf->ip_version != AF_INET))
+  if ((!message) || (!ifp) || (OLSR_IP_VERSION != AF_INET))
     return false;
 
   remainsize = net_outbuffer_bytes_left(ifp);
@@ -614,7 +675,7 @@ serialize_tc4(struct tc_message *message, struct interface *ifp)
   /*Looping trough MPR selectors */
   for (mprs = message->multipoint_relay_selector_address; mprs != NULL; mprs = mprs->next) {
     /*If packet is to be chomped */
-    if ((curr_size + olsr_cnf->ipsize) > remainsize) {
+    if ((curr_size + OLSR_IPSIZE) > remainsize) {
 
       /* Only add TC message if it contains data */
       if (curr_size > OLSR_TC_IPV4_HDRSIZE) {
@@ -636,7 +697,7 @@ serialize_tc4(struct tc_message *message, struct interface *ifp)
 
       net_output(ifp);
       remainsize = net_outbuffer_bytes_left(ifp);
-      check_buffspace(curr_size + olsr_cnf->ipsize, remainsize, "TC2");
+      check_buffspace(curr_size + OLSR_IPSIZE, remainsize, "TC2");
 
     }
     found = true;
@@ -644,7 +705,7 @@ serialize_tc4(struct tc_message *message, struct interface *ifp)
     OLSR_PRINTF(BMSG_DBGLVL, "\t%s\n", olsr_ip_to_string(&buf, &mprs->address));
 #endif /* DEBUG */
     mprsaddr->addr = mprs->address.v4.s_addr;
-    curr_size += olsr_cnf->ipsize;
+    curr_size += OLSR_IPSIZE;
     mprsaddr++;
   }
 
@@ -696,7 +757,7 @@ serialize_tc6(struct tc_message *message, struct interface *ifp)
   struct neigh_info6 *mprsaddr6;
   bool found = false, partial_sent = false;
 
-  if ((!message) || (!ifp) || (olsr_cnf->ip_version != AF_INET6))
+  if ((!message) || (!ifp) || (OLSR_IP_VERSION != AF_INET6))
     return false;
 
   remainsize = net_outbuffer_bytes_left(ifp);
@@ -730,7 +791,7 @@ serialize_tc6(struct tc_message *message, struct interface *ifp)
   for (mprs = message->multipoint_relay_selector_address; mprs != NULL; mprs = mprs->next) {
 
     /*If packet is to be chomped */
-    if ((curr_size + olsr_cnf->ipsize) > remainsize) {
+    if ((curr_size + OLSR_IPSIZE) > remainsize) {
       /* Only add TC message if it contains data */
       if (curr_size > OLSR_TC_IPV6_HDRSIZE) {
 #ifdef DEBUG
@@ -747,7 +808,7 @@ serialize_tc6(struct tc_message *message, struct interface *ifp)
       }
       net_output(ifp);
       remainsize = net_outbuffer_bytes_left(ifp);
-      check_buffspace(curr_size + olsr_cnf->ipsize, remainsize, "TC2");
+      check_buffspace(curr_size + OLSR_IPSIZE, remainsize, "TC2");
 
     }
     found = true;
@@ -755,7 +816,7 @@ serialize_tc6(struct tc_message *message, struct interface *ifp)
     OLSR_PRINTF(BMSG_DBGLVL, "\t%s\n", olsr_ip_to_string(&buf, &mprs->address));
 #endif /* DEBUG */
     mprsaddr6->addr = mprs->address.v6;
-    curr_size += olsr_cnf->ipsize;
+    curr_size += OLSR_IPSIZE;
 
     mprsaddr6++;
   }
@@ -799,7 +860,7 @@ serialize_mid4(struct interface *ifp)
   struct midaddr *addrs;
   struct interface *ifs;
 
-  if ((olsr_cnf->ip_version != AF_INET) || (!ifp) || (ifnet == NULL) || ((ifnet->int_next == NULL) && (ipequal(&olsr_cnf->main_addr, &ifnet->ip_addr))))
+  if ((OLSR_IP_VERSION != AF_INET) || (!ifp) || (ifnet == NULL) || ((ifnet->int_next == NULL) && (ipequal(&olsr_cnf->main_addr, &ifnet->ip_addr))))
     return false;
 
   remainsize = net_outbuffer_bytes_left(ifp);
@@ -811,7 +872,7 @@ serialize_mid4(struct interface *ifp)
   /* calculate size needed for HNA */
   needsize = curr_size;
   for (ifs = ifnet; ifs != NULL; ifs = ifs->int_next) {
-    needsize += olsr_cnf->ipsize*2;
+    needsize += OLSR_IPSIZE*2;
   }
 
   /* Send pending packet if not room in buffer */
@@ -838,7 +899,7 @@ serialize_mid4(struct interface *ifp)
       struct ipaddr_str buf;
 #endif /* DEBUG */
 
-      if ((curr_size + olsr_cnf->ipsize) > remainsize) {
+      if ((curr_size + OLSR_IPSIZE) > remainsize) {
         /* Only add MID message if it contains data */
         if (curr_size > OLSR_MID_IPV4_HDRSIZE) {
 #ifdef DEBUG
@@ -862,7 +923,7 @@ serialize_mid4(struct interface *ifp)
 
       addrs->addr = ifs->ip_addr.v4.s_addr;
       addrs++;
-      curr_size += olsr_cnf->ipsize;
+      curr_size += OLSR_IPSIZE;
     }
   }
 
@@ -895,7 +956,7 @@ serialize_mid6(struct interface *ifp)
 
   //printf("\t\tGenerating mid on %s\n", ifn->int_name);
 
-  if ((olsr_cnf->ip_version != AF_INET6) || (!ifp) || (ifnet == NULL) || ((ifnet->int_next == NULL) && (ipequal(&olsr_cnf->main_addr, &ifnet->ip_addr))))
+  if ((OLSR_IP_VERSION != AF_INET6) || (!ifp) || (ifnet == NULL) || ((ifnet->int_next == NULL) && (ipequal(&olsr_cnf->main_addr, &ifnet->ip_addr))))
     return false;
 
   remainsize = net_outbuffer_bytes_left(ifp);
@@ -905,7 +966,7 @@ serialize_mid6(struct interface *ifp)
   /* calculate size needed for HNA */
   needsize = curr_size;
   for (ifs = ifnet; ifs != NULL; ifs = ifs->int_next) {
-    needsize += olsr_cnf->ipsize*2;
+    needsize += OLSR_IPSIZE*2;
   }
 
   /* Send pending packet if not room in buffer */
@@ -933,7 +994,7 @@ serialize_mid6(struct interface *ifp)
 #ifdef DEBUG
       struct ipaddr_str buf;
 #endif /* DEBUG */
-      if ((curr_size + olsr_cnf->ipsize) > remainsize) {
+      if ((curr_size + OLSR_IPSIZE) > remainsize) {
         /* Only add MID message if it contains data */
         if (curr_size > OLSR_MID_IPV6_HDRSIZE) {
 #ifdef DEBUG
@@ -949,7 +1010,7 @@ serialize_mid6(struct interface *ifp)
         }
         net_output(ifp);
         remainsize = net_outbuffer_bytes_left(ifp);
-        check_buffspace(curr_size + olsr_cnf->ipsize, remainsize, "MID2");
+        check_buffspace(curr_size + OLSR_IPSIZE, remainsize, "MID2");
       }
 #ifdef DEBUG
       OLSR_PRINTF(BMSG_DBGLVL, "\t%s(%s)\n", olsr_ip_to_string(&buf, &ifs->ip_addr), ifs->int_name);
@@ -957,7 +1018,7 @@ serialize_mid6(struct interface *ifp)
 
       addrs6->addr = ifs->ip_addr.v6;
       addrs6++;
-      curr_size += olsr_cnf->ipsize;
+      curr_size += OLSR_IPSIZE;
     }
   }
 
@@ -990,7 +1051,7 @@ serialize_hna4(struct interface *ifp)
   if (ifp == NULL) {
     return false;
   }
-  if (olsr_cnf->ip_version != AF_INET) {
+  if (OLSR_IP_VERSION != AF_INET) {
     return false;
   }
   h = olsr_cnf->hna_entries;
@@ -1005,7 +1066,7 @@ serialize_hna4(struct interface *ifp)
   /* calculate size needed for HNA */
   needsize = curr_size;
   while (h) {
-    needsize += olsr_cnf->ipsize*2;
+    needsize += OLSR_IPSIZE*2;
     h = h->next;
   }
 
@@ -1031,7 +1092,7 @@ serialize_hna4(struct interface *ifp)
 
   for (; h != NULL; h = h->next) {
     union olsr_ip_addr ip_addr;
-    if ((curr_size + (2 * olsr_cnf->ipsize)) > remainsize) {
+    if ((curr_size + (2 * OLSR_IPSIZE)) > remainsize) {
       /* Only add HNA message if it contains data */
       if (curr_size > OLSR_HNA_IPV4_HDRSIZE) {
 #ifdef DEBUG
@@ -1045,23 +1106,17 @@ serialize_hna4(struct interface *ifp)
       }
       net_output(ifp);
       remainsize = net_outbuffer_bytes_left(ifp);
-      check_buffspace(curr_size + (2 * olsr_cnf->ipsize), remainsize, "HNA2");
+      check_buffspace(curr_size + (2 * OLSR_IPSIZE), remainsize, "HNA2");
     }
 #ifdef DEBUG
     OLSR_PRINTF(BMSG_DBGLVL, "\tNet: %s\n", olsr_ip_prefix_to_string(&h->net));
 #endif /* DEBUG */
 
-    olsr_prefix_to_netmask(&ip_addr, h->net.prefix_len);
-#ifdef __linux__
-    if (olsr_cnf->smart_gw_active && is_prefix_inetgw(&h->net)) {
-      /* this is the default route, overwrite it with the smart gateway */
-      olsr_modifiy_inetgw_netmask(&ip_addr, h->net.prefix_len);
-    }
-#endif /* __linux__ */
+    hna_netmask(h, &ip_addr);
     pair->addr = h->net.prefix.v4.s_addr;
     pair->netmask = ip_addr.v4.s_addr;
     pair++;
-    curr_size += (2 * olsr_cnf->ipsize);
+    curr_size += (2 * OLSR_IPSIZE);
   }
 
   m->v4.seqno = htons(get_msg_seqno());
@@ -1090,7 +1145,7 @@ serialize_hna6(struct interface *ifp)
   struct ip_prefix_list *h = olsr_cnf->hna_entries;
 
   /* No hna nets */
-  if ((olsr_cnf->ip_version != AF_INET6) || (!ifp) || h == NULL)
+  if ((OLSR_IP_VERSION != AF_INET6) || (!ifp) || h == NULL)
     return false;
 
   remainsize = net_outbuffer_bytes_left(ifp);
@@ -1100,7 +1155,7 @@ serialize_hna6(struct interface *ifp)
   /* calculate size needed for HNA */
   needsize = curr_size;
   while (h) {
-    needsize += olsr_cnf->ipsize*2;
+    needsize += OLSR_IPSIZE*2;
     h = h->next;
   }
 
@@ -1125,7 +1180,7 @@ serialize_hna6(struct interface *ifp)
   pair6 = m->v6.message.hna.hna_net;
 
   while (h) {
-    if ((curr_size + (2 * olsr_cnf->ipsize)) > remainsize) {
+    if ((curr_size + (2 * OLSR_IPSIZE)) > remainsize) {
       /* Only add HNA message if it contains data */
       if (curr_size > OLSR_HNA_IPV6_HDRSIZE) {
 #ifdef DEBUG
@@ -1139,22 +1194,16 @@ serialize_hna6(struct interface *ifp)
       }
       net_output(ifp);
       remainsize = net_outbuffer_bytes_left(ifp);
-      check_buffspace(curr_size + (2 * olsr_cnf->ipsize), remainsize, "HNA2");
+      check_buffspace(curr_size + (2 * OLSR_IPSIZE), remainsize, "HNA2");
     }
 #ifdef DEBUG
     OLSR_PRINTF(BMSG_DBGLVL, "\tNet: %s\n", olsr_ip_prefix_to_string(&h->net));
 #endif /* DEBUG */
-    olsr_prefix_to_netmask(&tmp_netmask, h->net.prefix_len);
-#ifdef __linux__
-    if (olsr_cnf->smart_gw_active && is_prefix_inetgw(&h->net)) {
-      /* this is the default gateway, so overwrite it with the smart one */
-      olsr_modifiy_inetgw_netmask(&tmp_netmask, h->net.prefix_len);
-    }
-#endif /* __linux__ */
+    hna_netmask(h, &tmp_netmask);
     pair6->addr = h->net.prefix.v6;
     pair6->netmask = tmp_netmask.v6;
     pair6++;
-    curr_size += (2 * olsr_cnf->ipsize);
+    curr_size += (2 * OLSR_IPSIZE);
     h = h->next;
   }
 
@@ -1166,6 +1215,121 @@ serialize_hna6(struct interface *ifp)
 
 }
 
+/**
+ *MID with compact addresses, the aliases are one address block
+ *
+ *@param ifp the interface to send on
+ *@return false if the aliases do not fit into one message
+ */
+static bool
+serialize_mid_compact(struct interface *ifp)
+{
+  const union olsr_ip_addr *head = NULL;
+  struct interface *ifs;
+  uint8_t *curr;
+  int count = 0, head_len = OLSR_IPSIZE, size;
+
+  if ((!ifp) || (ifnet == NULL) || ((ifnet->int_next == NULL) && (ipequal(&olsr_cnf->main_addr, &ifnet->ip_addr))))
+    return false;
+
+  /* Don't add the main address... it's already there */
+  for (ifs = ifnet; ifs != NULL; ifs = ifs->int_next) {
+    if (!ipequal(&olsr_cnf->main_addr, &ifs->ip_addr)) {
+      if (head == NULL)
+        head = &ifs->ip_addr;
+      head_len = olsr_addr_block_head(head, &ifs->ip_addr, head_len);
+      count++;
+    }
+  }
+
+  /* Only add MID message if it contains data */
+  if (count == 0)
+    return true;
+  head_len = olsr_addr_block_head_max(count, head_len);
+
+  size = (OLSR_IP_VERSION == AF_INET ? OLSR_MID_IPV4_HDRSIZE : OLSR_MID_IPV6_HDRSIZE) + olsr_addr_block_size(count, head_len);
+
+  /* Send pending packet if not room in buffer */
+  if (size > net_outbuffer_bytes_left(ifp))
+    net_output(ifp);
+  if (size > net_outbuffer_bytes_left(ifp))
+    return false;
+
+  curr = serialize_compact_header(MID_COMPACT_MESSAGE, ifp->valtimes.mid, size);
+
+  pkt_put_addr_block_header(&curr, count, head, head_len);
+  for (ifs = ifnet; ifs != NULL; ifs = ifs->int_next) {
+    if (!ipequal(&olsr_cnf->main_addr, &ifs->ip_addr))
+      pkt_put_addr_suffix(&curr, &ifs->ip_addr, head_len);
+  }
+  pkt_put_addr_block_pad(&curr, count, head_len);
+
+  net_outbuffer_push(ifp, msg_buffer, size);
+  return true;
+}
+
+/**
+ *HNA with compact addresses, the networks and their
+ *netmasks are two address blocks
+ *
+ *@param ifp the interface to send on
+ *@return false if the entries do not fit into one message
+ */
+static bool
+serialize_hna_compact(struct interface *ifp)
+{
+  union olsr_ip_addr net_head, mask_head, netmask;
+  struct ip_prefix_list *h;
+  uint8_t *curr;
+  int count = 0, net_len = OLSR_IPSIZE, mask_len = OLSR_IPSIZE, size;
+
+  /* No hna nets */
+  if (ifp == NULL || olsr_cnf->hna_entries == NULL)
+    return false;
+
+  for (h = olsr_cnf->hna_entries; h != NULL; h = h->next) {
+    hna_netmask(h, &netmask);
+    if (count++ == 0) {
+      net_head = h->net.prefix;
+      mask_head = netmask;
+    }
+    net_len = olsr_addr_block_head(&net_head, &h->net.prefix, net_len);
+    mask_len = olsr_addr_block_head(&mask_head, &netmask, mask_len);
+  }
+  net_len = olsr_addr_block_head_max(count, net_len);
+  mask_len = olsr_addr_block_head_max(count, mask_len);
+
+  size = (OLSR_IP_VERSION == AF_INET ? OLSR_HNA_IPV4_HDRSIZE : OLSR_HNA_IPV6_HDRSIZE)
+    + olsr_addr_block_size(count, net_len) + olsr_addr_block_size(count, mask_len);
+
+  /* Send pending packet if not room in buffer */
+  if (size > net_outbuffer_bytes_left(ifp))
+    net_output(ifp);
+  if (size > net_outbuffer_bytes_left(ifp))
+    return false;
+
+  curr = serialize_compact_header(HNA_COMPACT_MESSAGE, ifp->valtimes.hna, size);
+
+  pkt_put_addr_block_header(&curr, count, &net_head, net_len);
+  for (h = olsr_cnf->hna_entries; h != NULL; h = h->next) {
+#ifdef DEBUG
+    OLSR_PRINTF(BMSG_DBGLVL, "\tNet: %s\n", olsr_ip_prefix_to_string(&h->net));
+#endif /* DEBUG */
+    pkt_put_addr_suffix(&curr, &h->net.prefix, net_len);
+  }
+  pkt_put_addr_block_pad(&curr, count, net_len);
+
+  pkt_put_addr_block_header(&curr, count, &mask_head, mask_len);
+  for (h = olsr_cnf->hna_entries; h != NULL; h = h->next) {
+    hna_netmask(h, &netmask);
+    pkt_put_addr_suffix(&curr, &netmask, mask_len);
+  }
+  pkt_put_addr_block_pad(&curr, count, mask_len);
+
+  net_outbuffer_push(ifp, msg_buffer, size);
+  return true;
+}
+
 /*
  * Local Variables:
  * c-basic-offset: 2
@@ -320,15 +320,149 @@ void olsrd_write_cnf_autobuf(struct autobuf *out, struct olsrd_config *cnf) {
   abuf_appendf(out, "%sPollrate  %.2f\n",
       cnf->pollrate == (float)DEF_POLLRATE ? "# " : "",
       (double)cnf->pollrate);
+  abuf_puts(out,
+    "\n"
+    "# Share of the polling interval (in percent) which may be spent on\n"
+    "# processing received messages. Messages which do not fit are kept\n"
+    "# for the next poll, HELLOs and the TCs of MPR selectors first. If\n"
+    "# the queue grows, the messages of originators which send more than\n"
+    "# their share are dropped.\n"
+    "# (Default is 50)\n"
+    "\n");
+  abuf_appendf(out, "%sInputBudget  %d\n",
+      cnf->input_budget == DEF_INPUT_BUDGET ? "# " : "",
+      cnf->input_budget);
   abuf_puts(out,
     "\n"
     "# Interval to poll network interfaces for configuration changes (in seconds).\n"
-    "# Linux systems can detect interface statechange via netlink sockets.\n"
+    "# Not used on Linux, which detects interface changes via netlink events.\n"
     "# (Defaults is 2.5)\n"
     "\n");
   abuf_appendf(out, "%sNicChgsPollInt  %.1f\n",
       cnf->nic_chgs_pollrate == (float)DEF_NICCHGPOLLRT ? "# " : "",
       (double)cnf->nic_chgs_pollrate);
+  abuf_puts(out,
+    "\n"
+    "# Declare links lost as soon as the kernel reports the carrier of\n"
+    "# the interface or the neighbor as down, instead of waiting for\n"
+    "# the HELLOs to time out (Linux only).\n"
+    "# (Default is yes)\n"
+    "\n");
+  abuf_appendf(out, "%sLinkFailureDetection  %s\n",
+      cnf->link_fail_detection == DEF_LINK_FAIL_DETECT ? "# " : "",
+      cnf->link_fail_detection ? "yes" : "no");
+  abuf_puts(out,
+    "\n"
+    "# Time (in seconds) a link has to stay down in the kernel before it\n"
+    "# is declared lost. A HELLO received in between cancels it.\n"
+    "# (Default is 0.5)\n"
+    "\n");
+  abuf_appendf(out, "%sLinkFailureDelay  %.1f\n",
+      cnf->link_fail_delay == (float)DEF_LINK_FAIL_DELAY ? "# " : "",
+      (double)cnf->link_fail_delay);
+  abuf_puts(out,
+    "\n"
+    "# Upper bound for stretching the HELLO and TC intervals while the\n"
+    "# neighborhood is stable, as a multiple of the configured intervals.\n"
+    "# Every emission without link, neighbor, MPR or MPR selector changes\n"
+    "# doubles the interval up to this bound, any change falls back to the\n"
+    "# configured interval immediately. Link cost changes do not count.\n"
+    "# The advertised validity times are scaled by the same factor. 1 keeps\n"
+    "# the intervals fixed.\n"
+    "# (Default is 1)\n"
+    "\n");
+  abuf_appendf(out, "%sAdaptiveIntervals  %d\n",
+      cnf->adaptive_intervals == DEF_ADAPTIVE_INTERVALS ? "# " : "",
+      cnf->adaptive_intervals);
+  abuf_puts(out,
+    "\n"
+    "# Number of TCs which may be sent ahead of the TC interval when the\n"
+    "# advertised neighbor set changes. One more is allowed per TC\n"
+    "# interval, up to this number (at most 16). 0 waits for the next\n"
+    "# periodic TC.\n"
+    "# (Default is 3)\n"
+    "\n");
+  abuf_appendf(out, "%sTcTriggerBurst  %d\n",
+      cnf->tc_trigger_burst == DEF_TC_TRIGGER_BURST ? "# " : "",
+      cnf->tc_trigger_burst);
+  abuf_puts(out,
+    "\n"
+    "# Minimum time (in seconds) between two TCs of an interface before a\n"
+    "# triggered TC is sent, see TcTriggerBurst.\n"
+    "# (Default is 1.0)\n"
+    "\n");
+  abuf_appendf(out, "%sTcTriggerGap  %.1f\n",
+      cnf->tc_trigger_gap == (float)DEF_TC_TRIGGER_GAP ? "# " : "",
+      (double)cnf->tc_trigger_gap);
+  abuf_puts(out,
+    "\n"
+    "# Interval (in seconds) for writing a memory usage summary to syslog.\n"
+    "# It contains the memory held by the internal allocators and the\n"
+    "# number of entries in the topology, MID, HNA, link, duplicate and\n"
+    "# route tables. Details are available through the txtinfo/jsoninfo\n"
+    "# plugins. 0 disables the summary.\n"
+    "# (Default is 0)\n"
+    "\n");
+  abuf_appendf(out, "%sMemoryStatsInterval  %u\n",
+      cnf->mem_stats_interval == DEF_MEM_STATS_INT ? "# " : "",
+      cnf->mem_stats_interval);
+  abuf_puts(out,
+    "\n"
+    "# Maximum number of nodes (originators) kept in the topology table.\n"
+    "# TC messages from further originators are still forwarded, but\n"
+    "# not stored. 0 means unlimited.\n"
+    "# (Default is 0)\n"
+    "\n");
+  abuf_appendf(out, "%sMaxTcEntries  %u\n",
+      cnf->max_tc_entries == DEF_MAX_TC_ENTRIES ? "# " : "",
+      cnf->max_tc_entries);
+  abuf_puts(out,
+    "\n"
+    "# Maximum number of edges kept in the topology table. If the limit\n"
+    "# is reached, the edges of the most distant node are dropped to\n"
+    "# make room for closer ones. 0 means unlimited.\n"
+    "# (Default is 0)\n"
+    "\n");
+  abuf_appendf(out, "%sMaxTcEdges  %u\n",
+      cnf->max_tc_edges == DEF_MAX_TC_EDGES ? "# " : "",
+      cnf->max_tc_edges);
+  abuf_puts(out,
+    "\n"
+    "# Maximum number of interface aliases kept in the MID table.\n"
+    "# New aliases beyond the limit are ignored. 0 means unlimited.\n"
+    "# (Default is 0)\n"
+    "\n");
+  abuf_appendf(out, "%sMaxMidEntries  %u\n",
+      cnf->max_mid_entries == DEF_MAX_MID_ENTRIES ? "# " : "",
+      cnf->max_mid_entries);
+  abuf_puts(out,
+    "\n"
+    "# Maximum number of announced networks kept in the HNA table.\n"
+    "# New networks beyond the limit are ignored. 0 means unlimited.\n"
+    "# (Default is 0)\n"
+    "\n");
+  abuf_appendf(out, "%sMaxHnaNets  %u\n",
+      cnf->max_hna_nets == DEF_MAX_HNA_NETS ? "# " : "",
+      cnf->max_hna_nets);
+  abuf_puts(out,
+    "\n"
+    "# Maximum number of originators tracked in the duplicate set. If the\n"
+    "# limit is reached, the oldest entry is dropped. 0 means unlimited.\n"
+    "# (Default is 0)\n"
+    "\n");
+  abuf_appendf(out, "%sMaxDupEntries  %u\n",
+      cnf->max_dup_entries == DEF_MAX_DUP_ENTRIES ? "# " : "",
+      cnf->max_dup_entries);
+  abuf_puts(out,
+    "\n"
+    "# Number of sequence numbers per originator remembered by the\n"
+    "# duplicate detection. Messages arriving out of order by more than\n"
+    "# this are treated as too old. Must be 64, 128 or 256.\n"
+    "# (Default is 128)\n"
+    "\n");
+  abuf_appendf(out, "%sDuplicateWindow  %u\n",
+      cnf->dup_window == DEF_DUP_WINDOW ? "# " : "",
+      cnf->dup_window);
   abuf_puts(out,
     "\n"
     "# TOS(type of service) value for the IP header of control traffic.\n"
@@ -782,6 +916,30 @@ void olsrd_write_cnf_autobuf(struct autobuf *out, struct olsrd_config *cnf) {
   abuf_appendf(out, "%sLinkQualityFishEye  %d\n",
       cnf->lq_fish == DEF_LQ_FISH ? "# " : "",
       cnf->lq_fish);
+  abuf_puts(out,
+    "\n"
+    "# Incremental TCs (only for lq level > 0). Between two full TCs\n"
+    "# only the changes of the advertised neighbor set are sent. The\n"
+    "# value is the number of TCs per full TC, 0 means off. Nodes\n"
+    "# without support forward incremental TCs, but ignore them.\n"
+    "# The maximum is 64.\n"
+    "# (default is 0)\n"
+    "\n");
+  abuf_appendf(out, "%sTcDelta  %d\n",
+      cnf->tc_delta == DEF_TC_DELTA ? "# " : "",
+      cnf->tc_delta);
+  abuf_puts(out,
+    "\n"
+    "# Send TC (only for lq level > 0), MID and HNA messages with\n"
+    "# compact addresses. The common head of all addresses in a message\n"
+    "# is sent only once, followed by the remaining bytes of each\n"
+    "# address. All nodes of the mesh have to support it, others\n"
+    "# forward these messages, but ignore them.\n"
+    "# (default is no)\n"
+    "\n");
+  abuf_appendf(out, "%sCompactAddresses  %s\n",
+      cnf->compact_addrs == DEF_COMPACT_ADDRS ? "# " : "",
+      cnf->compact_addrs ? "yes" : "no");
   abuf_puts(out,
     "\n"
     "#\n"
@@ -425,6 +425,12 @@ olsrd_sanity_check_cnf(struct olsrd_config *cnf)
     fprintf(stderr, "Ipversion %d not allowed!\n", cnf->ip_version);
     return -1;
   }
+#ifdef OLSR_IPVERSION
+  if (cnf->ip_version != (OLSR_IPVERSION == 4 ? AF_INET : AF_INET6)) {
+    fprintf(stderr, "This olsrd was built for IPv%d only!\n", OLSR_IPVERSION);
+    return -1;
+  }
+#endif /* OLSR_IPVERSION */
 
   /* TOS range */
   if (cnf->tos > MAX_TOS) {
@@ -473,6 +479,18 @@ olsrd_sanity_check_cnf(struct olsrd_config *cnf)
     return -1;
   }
 
+  /* Input budget */
+  if (cnf->input_budget < 1 || cnf->input_budget > 100) {
+    fprintf(stderr, "InputBudget %d is not allowed, use 1 to 100\n", cnf->input_budget);
+    return -1;
+  }
+
+  /* Duplicate window */
+  if (cnf->dup_window != 64 && cnf->dup_window != 128 && cnf->dup_window != 256) {
+    fprintf(stderr, "Duplicate window %u is not allowed, use 64, 128 or 256\n", cnf->dup_window);
+    return -1;
+  }
+
   /* NIC Changes Pollrate */
 
   if (cnf->nic_chgs_pollrate < (float)MIN_NICCHGPOLLRT || cnf->nic_chgs_pollrate > (float)MAX_NICCHGPOLLRT) {
@@ -480,6 +498,41 @@ olsrd_sanity_check_cnf(struct olsrd_config *cnf)
     return -1;
   }
 
+  /* Link failure delay */
+
+  if (cnf->link_fail_delay > (float)MAX_LINK_FAIL_DELAY) {
+    fprintf(stderr, "Link failure delay %0.2f is not allowed\n", (double)cnf->link_fail_delay);
+    return -1;
+  }
+
+  /* Adaptive intervals */
+
+  if (cnf->adaptive_intervals < 1 || cnf->adaptive_intervals > MAX_ADAPTIVE_INTERVALS) {
+    fprintf(stderr, "Adaptive intervals %d is not allowed\n", cnf->adaptive_intervals);
+    return -1;
+  }
+
+  /* TC trigger burst */
+
+  if (cnf->tc_trigger_burst > MAX_TC_TRIGGER_BURST) {
+    fprintf(stderr, "TC trigger burst %d is not allowed\n", cnf->tc_trigger_burst);
+    return -1;
+  }
+
+  /* TC trigger gap */
+
+  if (cnf->tc_trigger_gap < 0.0f || cnf->tc_trigger_gap > (float)MAX_TC_TRIGGER_GAP) {
+    fprintf(stderr, "TC trigger gap %0.2f is not allowed\n", (double)cnf->tc_trigger_gap);
+    return -1;
+  }
+
+  /* Incremental TCs */
+
+  if (cnf->tc_delta > MAX_TC_DELTA) {
+    fprintf(stderr, "TcDelta %d is not allowed, use 0 to %d\n", cnf->tc_delta, MAX_TC_DELTA);
+    return -1;
+  }
+
   /* TC redundancy */
   if (cnf->tc_redundancy != 2) {
     fprintf(stderr, "Sorry, tc-redundancy 0/1 are not working on 0.5.6. "
@@ -847,9 +900,15 @@ set_default_cnf(struct olsrd_config *cnf)
   cnf->no_fork = false;
   cnf->pidfile = NULL;
   cnf->host_emul = false;
+#if defined OLSR_IPVERSION && OLSR_IPVERSION == 6
+  cnf->ip_version = AF_INET6;
+  cnf->ipsize = sizeof(struct in6_addr);
+  cnf->maxplen = 128;
+#else /* defined OLSR_IPVERSION && OLSR_IPVERSION == 6 */
   cnf->ip_version = AF_INET;
   cnf->ipsize = sizeof(struct in_addr);
   cnf->maxplen = 32;
+#endif /* defined OLSR_IPVERSION && OLSR_IPVERSION == 6 */
   cnf->allow_no_interfaces = DEF_ALLOW_NO_INTS;
   cnf->tos = DEF_TOS;
   cnf->olsrport = DEF_OLSRPORT;
@@ -873,12 +932,20 @@ set_default_cnf(struct olsrd_config *cnf)
   cnf->hysteresis_param.thr_low = HYST_THRESHOLD_LOW;
 
   cnf->pollrate = DEF_POLLRATE;
+  cnf->input_budget = DEF_INPUT_BUDGET;
   cnf->nic_chgs_pollrate = DEF_NICCHGPOLLRT;
+  cnf->link_fail_detection = DEF_LINK_FAIL_DETECT;
+  cnf->link_fail_delay = DEF_LINK_FAIL_DELAY;
+  cnf->adaptive_intervals = DEF_ADAPTIVE_INTERVALS;
+  cnf->tc_trigger_burst = DEF_TC_TRIGGER_BURST;
+  cnf->tc_trigger_gap = DEF_TC_TRIGGER_GAP;
 
   cnf->tc_redundancy = TC_REDUNDANCY;
   cnf->mpr_coverage = MPR_COVERAGE;
   cnf->lq_level = DEF_LQ_LEVEL;
   cnf->lq_fish = DEF_LQ_FISH;
+  cnf->tc_delta = DEF_TC_DELTA;
+  cnf->compact_addrs = DEF_COMPACT_ADDRS;
   cnf->lq_aging = DEF_LQ_AGING;
   cnf->lq_algorithm = NULL;
   cnf->lq_nat_thresh = DEF_LQ_NAT_THRESH;
@@ -918,6 +985,13 @@ set_default_cnf(struct olsrd_config *cnf)
 
   cnf->use_src_ip_routes = DEF_USE_SRCIP_ROUTES;
   cnf->set_ip_forward = true;
+  cnf->mem_stats_interval = DEF_MEM_STATS_INT;
+  cnf->max_tc_entries = DEF_MAX_TC_ENTRIES;
+  cnf->max_tc_edges = DEF_MAX_TC_EDGES;
+  cnf->max_mid_entries = DEF_MAX_MID_ENTRIES;
+  cnf->max_hna_nets = DEF_MAX_HNA_NETS;
+  cnf->max_dup_entries = DEF_MAX_DUP_ENTRIES;
+  cnf->dup_window = DEF_DUP_WINDOW;
 
 #ifdef __linux__
   cnf->rtnl_s = 0;
@@ -1009,8 +1083,34 @@ olsrd_print_cnf(struct olsrd_config *cnf)
 
   printf("Pollrate         : %0.2f\n", (double)cnf->pollrate);
 
+  printf("Input budget     : %d%%\n", cnf->input_budget);
+
   printf("NIC ChangPollrate: %0.2f\n", (double)cnf->nic_chgs_pollrate);
 
+  printf("Link failures    : %s\n", cnf->link_fail_detection ? "yes" : "no");
+
+  printf("Link fail delay  : %0.2f\n", (double)cnf->link_fail_delay);
+
+  printf("Adaptive interv. : %d\n", cnf->adaptive_intervals);
+
+  printf("TC trigger burst : %d\n", cnf->tc_trigger_burst);
+
+  printf("TC trigger gap   : %0.2f\n", (double)cnf->tc_trigger_gap);
+
+  printf("Mem. stats int.  : %u\n", cnf->mem_stats_interval);
+
+  printf("Max. TC entries  : %u\n", cnf->max_tc_entries);
+
+  printf("Max. TC edges    : %u\n", cnf->max_tc_edges);
+
+  printf("Max. MID entries : %u\n", cnf->max_mid_entries);
+
+  printf("Max. HNA nets    : %u\n", cnf->max_hna_nets);
+
+  printf("Max. dup entries : %u\n", cnf->max_dup_entries);
+
+  printf("Dup. window      : %u\n", cnf->dup_window);
+
   printf("TC redundancy    : %d\n", cnf->tc_redundancy);
 
   printf("MPR coverage     : %d\n", cnf->mpr_coverage);
@@ -1019,6 +1119,10 @@ olsrd_print_cnf(struct olsrd_config *cnf)
 
   printf("LQ fish eye      : %d\n", cnf->lq_fish);
 
+  printf("TC delta         : %d\n", cnf->tc_delta);
+
+  printf("Compact addrs    : %s\n", cnf->compact_addrs ? "yes" : "no");
+
   printf("LQ aging factor  : %f\n", (double)cnf->lq_aging);
 
   printf("LQ algorithm name: %s\n", cnf->lq_algorithm ? cnf->lq_algorithm : "default");
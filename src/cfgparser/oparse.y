@@ -201,11 +201,19 @@ static int add_ipv6_addr(YYSTYPE ipaddr_arg, YYSTYPE prefixlen_arg)
 %token TOK_HYSTUPPER
 %token TOK_HYSTLOWER
 %token TOK_POLLRATE
+%token TOK_INPUT_BUDGET
 %token TOK_NICCHGSPOLLRT
+%token TOK_LINK_FAIL_DETECT
+%token TOK_LINK_FAIL_DELAY
+%token TOK_ADAPTIVE_INTERVALS
+%token TOK_TC_TRIGGER_BURST
+%token TOK_TC_TRIGGER_GAP
 %token TOK_TCREDUNDANCY
 %token TOK_MPRCOVERAGE
 %token TOK_LQ_LEVEL
 %token TOK_LQ_FISH
+%token TOK_TC_DELTA
+%token TOK_COMPACT_ADDRS
 %token TOK_LQ_AGING
 %token TOK_LQ_PLUGIN
 %token TOK_LQ_NAT_THRESH
@@ -238,6 +246,13 @@ static int add_ipv6_addr(YYSTYPE ipaddr_arg, YYSTYPE prefixlen_arg)
 %token TOK_SRC_IP_ROUTES
 %token TOK_MAIN_IP
 %token TOK_SET_IPFORWARD
+%token TOK_MEM_STATS_INTERVAL
+%token TOK_MAX_TC_ENTRIES
+%token TOK_MAX_TC_EDGES
+%token TOK_MAX_MID_ENTRIES
+%token TOK_MAX_HNA_NETS
+%token TOK_MAX_DUP_ENTRIES
+%token TOK_DUP_WINDOW
 
 %token TOK_HOSTLABEL
 %token TOK_NETLABEL
@@ -296,12 +311,20 @@ stmt:       idebug
           | fhystupper
           | fhystlower
           | fpollrate
+          | ainput_budget
           | fnicchgspollrt
+          | blink_fail_detect
+          | flink_fail_delay
+          | aadaptive_intervals
+          | atc_trigger_burst
+          | ftc_trigger_gap
           | atcredundancy
           | amprcoverage
           | alq_level
           | alq_plugin
           | alq_fish
+          | atc_delta
+          | bcompact_addrs
           | anat_thresh
           | alq_aging
           | bclear_screen
@@ -331,6 +354,13 @@ stmt:       idebug
           | bsrc_ip_routes
           | amain_ip
           | bset_ipforward
+          | imem_stats_interval
+          | imax_tc_entries
+          | imax_tc_edges
+          | imax_mid_entries
+          | imax_hna_nets
+          | imax_dup_entries
+          | idup_window
           | ssgw_egress_ifs
 ;
 
@@ -1216,6 +1246,19 @@ fpollrate: TOK_POLLRATE TOK_FLOAT
 }
 ;
 
+ainput_budget: TOK_INPUT_BUDGET TOK_INTEGER
+{
+  PARSER_DEBUG_PRINTF("Input budget %d\n", $2->integer);
+  if ($2->integer < 1 || $2->integer > 100) {
+    fprintf(stderr, "InputBudget %d is not allowed, use 1 to 100\n", $2->integer);
+    free($2);
+    YYABORT;
+  }
+  olsr_cnf->input_budget = $2->integer;
+  free($2);
+}
+;
+
 fnicchgspollrt: TOK_NICCHGSPOLLRT TOK_FLOAT
 {
   PARSER_DEBUG_PRINTF("NIC Changes Pollrate %0.2f\n", (double)$2->floating);
@@ -1224,6 +1267,56 @@ fnicchgspollrt: TOK_NICCHGSPOLLRT TOK_FLOAT
 }
 ;
 
+blink_fail_detect: TOK_LINK_FAIL_DETECT TOK_BOOLEAN
+{
+  PARSER_DEBUG_PRINTF("Link failure detection %s\n", $2->boolean ? "enabled" : "disabled");
+  olsr_cnf->link_fail_detection = $2->boolean;
+  free($2);
+}
+;
+
+flink_fail_delay: TOK_LINK_FAIL_DELAY TOK_FLOAT
+{
+  PARSER_DEBUG_PRINTF("Link failure delay %0.2f\n", (double)$2->floating);
+  olsr_cnf->link_fail_delay = $2->floating;
+  free($2);
+}
+;
+
+aadaptive_intervals: TOK_ADAPTIVE_INTERVALS TOK_INTEGER
+{
+  PARSER_DEBUG_PRINTF("Adaptive intervals %d\n", $2->integer);
+  if ($2->integer < 1 || $2->integer > MAX_ADAPTIVE_INTERVALS) {
+    fprintf(stderr, "Adaptive intervals %d is not allowed, use 1 to %d\n", $2->integer, MAX_ADAPTIVE_INTERVALS);
+    free($2);
+    YYABORT;
+  }
+  olsr_cnf->adaptive_intervals = $2->integer;
+  free($2);
+}
+;
+
+atc_trigger_burst: TOK_TC_TRIGGER_BURST TOK_INTEGER
+{
+  PARSER_DEBUG_PRINTF("TC trigger burst %d\n", $2->integer);
+  if ($2->integer > MAX_TC_TRIGGER_BURST) {
+    fprintf(stderr, "TC trigger burst %d is not allowed, use 0 to %d\n", $2->integer, MAX_TC_TRIGGER_BURST);
+    free($2);
+    YYABORT;
+  }
+  olsr_cnf->tc_trigger_burst = $2->integer;
+  free($2);
+}
+;
+
+ftc_trigger_gap: TOK_TC_TRIGGER_GAP TOK_FLOAT
+{
+  PARSER_DEBUG_PRINTF("TC trigger gap %0.2f\n", (double)$2->floating);
+  olsr_cnf->tc_trigger_gap = $2->floating;
+  free($2);
+}
+;
+
 atcredundancy: TOK_TCREDUNDANCY TOK_INTEGER
 {
   PARSER_DEBUG_PRINTF("TC redundancy %d\n", $2->integer);
@@ -1256,6 +1349,27 @@ alq_fish: TOK_LQ_FISH TOK_INTEGER
 }
 ;
 
+atc_delta: TOK_TC_DELTA TOK_INTEGER
+{
+  PARSER_DEBUG_PRINTF("Incremental TCs per full TC %d\n", $2->integer);
+  if ($2->integer > MAX_TC_DELTA) {
+    fprintf(stderr, "TcDelta %d is not allowed, use 0 to %d\n", $2->integer, MAX_TC_DELTA);
+    free($2);
+    YYABORT;
+  }
+  olsr_cnf->tc_delta = $2->integer;
+  free($2);
+}
+;
+
+bcompact_addrs: TOK_COMPACT_ADDRS TOK_BOOLEAN
+{
+  PARSER_DEBUG_PRINTF("Compact addresses %s\n", $2->boolean ? "enabled" : "disabled");
+  olsr_cnf->compact_addrs = $2->boolean;
+  free($2);
+}
+;
+
 alq_aging: TOK_LQ_AGING TOK_FLOAT
 {
   PARSER_DEBUG_PRINTF("Link quality aging factor %f\n", (double)$2->floating);
@@ -1612,6 +1726,62 @@ bset_ipforward: TOK_SET_IPFORWARD TOK_BOOLEAN
 }
 ;
 
+imem_stats_interval: TOK_MEM_STATS_INTERVAL TOK_INTEGER
+{
+  PARSER_DEBUG_PRINTF("Memory statistics interval %d\n", $2->integer);
+  olsr_cnf->mem_stats_interval = $2->integer;
+  free($2);
+}
+;
+
+imax_tc_entries: TOK_MAX_TC_ENTRIES TOK_INTEGER
+{
+  PARSER_DEBUG_PRINTF("Maximum number of topology entries %d\n", $2->integer);
+  olsr_cnf->max_tc_entries = $2->integer;
+  free($2);
+}
+;
+
+imax_tc_edges: TOK_MAX_TC_EDGES TOK_INTEGER
+{
+  PARSER_DEBUG_PRINTF("Maximum number of topology edges %d\n", $2->integer);
+  olsr_cnf->max_tc_edges = $2->integer;
+  free($2);
+}
+;
+
+imax_mid_entries: TOK_MAX_MID_ENTRIES TOK_INTEGER
+{
+  PARSER_DEBUG_PRINTF("Maximum number of MID aliases %d\n", $2->integer);
+  olsr_cnf->max_mid_entries = $2->integer;
+  free($2);
+}
+;
+
+imax_hna_nets: TOK_MAX_HNA_NETS TOK_INTEGER
+{
+  PARSER_DEBUG_PRINTF("Maximum number of HNA networks %d\n", $2->integer);
+  olsr_cnf->max_hna_nets = $2->integer;
+  free($2);
+}
+;
+
+imax_dup_entries: TOK_MAX_DUP_ENTRIES TOK_INTEGER
+{
+  PARSER_DEBUG_PRINTF("Maximum number of duplicate entries %d\n", $2->integer);
+  olsr_cnf->max_dup_entries = $2->integer;
+  free($2);
+}
+;
+
+idup_window: TOK_DUP_WINDOW TOK_INTEGER
+{
+  PARSER_DEBUG_PRINTF("Duplicate window %d\n", $2->integer);
+  olsr_cnf->dup_window = $2->integer;
+  free($2);
+}
+;
+
 
 plblock: TOK_PLUGIN TOK_STRING
 {
@@ -179,6 +179,24 @@ strscat(char *dest, const char *src, size_t size)
  */
 extern struct olsrd_config *olsr_cnf;
 
+/*
+ * Address family of the daemon. A build with OLSR_IPVERSION set to
+ * 4 or 6 supports only that family, which turns the address size and
+ * family checks on the hot paths into constants.
+ */
+#if defined OLSR_IPVERSION && OLSR_IPVERSION == 4
+#define OLSR_IP_VERSION         AF_INET
+#define OLSR_IPSIZE             sizeof(struct in_addr)
+#elif defined OLSR_IPVERSION && OLSR_IPVERSION == 6
+#define OLSR_IP_VERSION         AF_INET6
+#define OLSR_IPSIZE             sizeof(struct in6_addr)
+#elif defined OLSR_IPVERSION
+#error "OLSR_IPVERSION must be 4 or 6"
+#else /* OLSR_IPVERSION */
+#define OLSR_IP_VERSION         (olsr_cnf->ip_version)
+#define OLSR_IPSIZE             (olsr_cnf->ipsize)
+#endif /* OLSR_IPVERSION */
+
 /* Timer data */
 extern uint32_t now_times;              /* current idea of times(2) reported uptime */
 extern struct olsr_cookie_info *def_timer_ci;
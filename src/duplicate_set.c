@@ -41,64 +41,240 @@
 
 #include "duplicate_set.h"
 #include "ipcalc.h"
-#include "common/avl.h"
+#include "hashing.h"
 #include "olsr.h"
 #include "mid_set.h"
 #include "scheduler.h"
 #include "mantissa.h"
+#include "olsr_cookie.h"
 
 static void olsr_cleanup_duplicate_entry(void *unused);
 
-struct avl_tree duplicate_set;
+/* Hash of all entries, keyed by originator address */
+struct dup_entry **dup_hash = NULL;
+uint32_t dup_hash_size = 0;
+static uint32_t dup_count = 0;
+
+/*
+ * Entries are kept in expiry slots by the cleanup interval they
+ * time out in. A cleanup run drops whole slots without looking
+ * at the entries which are still valid.
+ */
+struct dup_expiry_slot {
+  struct list_node entries;            /* list head of entries */
+  uint32_t expires;                    /* latest valid_until of all entries */
+};
+
+static struct dup_expiry_slot dup_expiry[DUP_EXPIRY_SLOTS];
+
+/* Size of the sliding window in bits and 64 bit words */
+static unsigned int dup_window_bits;
+static unsigned int dup_window_words;
+
 struct timer_entry *duplicate_cleanup_timer;
+struct olsr_cookie_info *dup_mem_cookie = NULL;
 
 void
 olsr_init_duplicate_set(void)
 {
-  avl_init(&duplicate_set, olsr_cnf->ip_version == AF_INET ? &avl_comp_ipv4 : &avl_comp_ipv6);
+  int i;
+
+  dup_window_bits = olsr_cnf->dup_window;
+  dup_window_words = dup_window_bits / 64;
+
+  dup_hash_size = DUP_HASH_INITIAL_SIZE;
+  dup_hash = olsr_malloc(dup_hash_size * sizeof(*dup_hash), "dup hash");
+
+  for (i = 0; i < DUP_EXPIRY_SLOTS; i++) {
+    list_head_init(&dup_expiry[i].entries);
+  }
+
+  dup_mem_cookie = olsr_alloc_cookie("dup_entry", OLSR_COOKIE_TYPE_MEMORY);
+  olsr_cookie_set_memory_size(dup_mem_cookie, sizeof(struct dup_entry) + dup_window_words * sizeof(uint64_t));
+  olsr_cookie_set_budget(dup_mem_cookie, olsr_cnf->max_dup_entries);
 
   olsr_set_timer(&duplicate_cleanup_timer, DUPLICATE_CLEANUP_INTERVAL, DUPLICATE_CLEANUP_JITTER, OLSR_TIMER_PERIODIC,
                  &olsr_cleanup_duplicate_entry, NULL, 0);
 }
 
+/*
+ * Double the number of hash buckets.
+ */
+static void
+olsr_grow_duplicate_hash(void)
+{
+  struct dup_entry **hash, *entry, *next;
+  uint32_t i, size;
+
+  size = dup_hash_size * 2;
+  hash = olsr_malloc(size * sizeof(*hash), "dup hash");
+
+  for (i = 0; i < dup_hash_size; i++) {
+    for (entry = dup_hash[i]; entry; entry = next) {
+      next = entry->hash_next;
+      entry->hash_next = hash[entry->hash & (size - 1)];
+      hash[entry->hash & (size - 1)] = entry;
+    }
+  }
+
+  free(dup_hash);
+  dup_hash = hash;
+  dup_hash_size = size;
+}
+
+/*
+ * Look up the entry of an originator.
+ */
+static struct dup_entry *
+olsr_lookup_duplicate_entry(const void *ip, uint32_t hash)
+{
+  struct dup_entry *entry;
+
+  for (entry = dup_hash[hash & (dup_hash_size - 1)]; entry; entry = entry->hash_next) {
+    if (entry->hash == hash && memcmp(&entry->ip, ip, OLSR_IPSIZE) == 0) {
+      return entry;
+    }
+  }
+  return NULL;
+}
+
+/*
+ * Put an entry into the expiry slot of its valid_until time.
+ */
+static void
+olsr_set_duplicate_expiry(struct dup_entry *entry, uint32_t valid_until)
+{
+  struct dup_expiry_slot *slot;
+  uint8_t idx;
+
+  entry->valid_until = valid_until;
+
+  idx = (valid_until / DUPLICATE_CLEANUP_INTERVAL) % DUP_EXPIRY_SLOTS;
+  slot = &dup_expiry[idx];
+
+  if (list_is_empty(&slot->entries) || (int32_t)(valid_until - slot->expires) > 0) {
+    slot->expires = valid_until;
+  }
+
+  if (list_node_on_list(&entry->expiry_node)) {
+    if (entry->expiry_slot == idx) {
+      return;
+    }
+    list_remove(&entry->expiry_node);
+  }
+
+  entry->expiry_slot = idx;
+  list_add_before(&slot->entries, &entry->expiry_node);
+}
+
+/*
+ * Unlink an entry from the hash and its expiry slot and free it.
+ */
+static void
+olsr_delete_duplicate_entry(struct dup_entry *entry)
+{
+  struct dup_entry **prev;
+
+  for (prev = &dup_hash[entry->hash & (dup_hash_size - 1)]; *prev != entry; prev = &(*prev)->hash_next);
+  *prev = entry->hash_next;
+  dup_count--;
+
+  list_remove(&entry->expiry_node);
+  olsr_cookie_free(dup_mem_cookie, entry);
+}
+
 void olsr_cleanup_duplicates(union olsr_ip_addr *orig) {
   struct dup_entry *entry;
 
-  entry = (struct dup_entry *)avl_find(&duplicate_set, orig);
+  entry = olsr_lookup_duplicate_entry(orig, olsr_ip_hash(orig));
   if (entry != NULL) {
     entry->too_low_counter = DUP_MAX_TOO_LOW - 2;
   }
 }
 
+/*
+ * Drop the oldest entry to stay within the budget.
+ * It is taken from the slot which expires first.
+ */
+static void
+olsr_evict_duplicate_entry(void)
+{
+  struct dup_expiry_slot *oldest = NULL;
+  int i;
+
+  for (i = 0; i < DUP_EXPIRY_SLOTS; i++) {
+    if (list_is_empty(&dup_expiry[i].entries)) {
+      continue;
+    }
+    if (!oldest || (int32_t)(dup_expiry[i].expires - oldest->expires) < 0) {
+      oldest = &dup_expiry[i];
+    }
+  }
+
+  if (oldest) {
+    olsr_delete_duplicate_entry(expiry2dupentry(oldest->entries.next));
+    dup_mem_cookie->ci_evicted++;
+  }
+}
+
 struct dup_entry *
 olsr_create_duplicate_entry(void *ip, uint16_t seqnr)
 {
   struct dup_entry *entry;
-  entry = olsr_malloc(sizeof(struct dup_entry), "New duplicate entry");
+
+  if (olsr_cookie_budget_exhausted(dup_mem_cookie)) {
+    olsr_evict_duplicate_entry();
+  }
+  entry = olsr_cookie_malloc(dup_mem_cookie);
   if (entry != NULL) {
-    memcpy(&entry->ip, ip, olsr_cnf->ip_version == AF_INET ? sizeof(entry->ip.v4) : sizeof(entry->ip.v6));
+    memcpy(&entry->ip, ip, OLSR_IPSIZE);
+    entry->hash = olsr_ip_hash(&entry->ip);
     entry->seqnr = seqnr;
     entry->too_low_counter = 0;
-    entry->avl.key = &entry->ip;
-    entry->array = 0;
+    list_node_init(&entry->expiry_node);
+
+    if (++dup_count > 2 * dup_hash_size) {
+      olsr_grow_duplicate_hash();
+    }
+    entry->hash_next = dup_hash[entry->hash & (dup_hash_size - 1)];
+    dup_hash[entry->hash & (dup_hash_size - 1)] = entry;
   }
   return entry;
 }
 
+/*
+ * Drop all expiry slots which have timed out as a whole.
+ */
 static void
 olsr_cleanup_duplicate_entry(void __attribute__ ((unused)) * unused)
 {
-  struct dup_entry *entry;
+  struct dup_expiry_slot *slot;
+  int i;
 
-  OLSR_FOR_ALL_DUP_ENTRIES(entry) {
-    if (TIMED_OUT(entry->valid_until)) {
-      avl_delete(&duplicate_set, &entry->avl);
-      free(entry);
+  for (i = 0; i < DUP_EXPIRY_SLOTS; i++) {
+    slot = &dup_expiry[i];
+    if (!TIMED_OUT(slot->expires)) {
+      continue;
+    }
+    while (!list_is_empty(&slot->entries)) {
+      olsr_delete_duplicate_entry(expiry2dupentry(slot->entries.next));
     }
   }
-  OLSR_FOR_ALL_DUP_ENTRIES_END(entry);
 }
 
+#ifndef NODEBUG
+/*
+ * Main address of an originator, only used for debug output.
+ */
+static union olsr_ip_addr *
+olsr_duplicate_main_addr(void *ip)
+{
+  union olsr_ip_addr *main_addr = mid_lookup_main_addr(ip);
+
+  return main_addr != NULL ? main_addr : ip;
+}
+#endif /* NODEBUG */
+
 int olsr_seqno_diff(uint16_t seqno1, uint16_t seqno2) {
   int diff = (int)seqno1 - (int)(seqno2);
 
@@ -112,18 +288,50 @@ int olsr_seqno_diff(uint16_t seqno1, uint16_t seqno2) {
   return diff;
 }
 
+/*
+ * Shift the sliding window of an entry towards older sequence numbers.
+ */
+static void
+olsr_shift_duplicate_window(struct dup_entry *entry, unsigned int shift)
+{
+  unsigned int word_shift, bit_shift;
+  int i, src;
+
+  if (shift >= dup_window_bits) {
+    memset(entry->window, 0, dup_window_words * sizeof(uint64_t));
+    return;
+  }
+
+  word_shift = shift / 64;
+  bit_shift = shift % 64;
+
+  for (i = dup_window_words - 1; i >= 0; i--) {
+    uint64_t word = 0;
+
+    src = i - (int)word_shift;
+    if (src >= 0) {
+      word = entry->window[src] << bit_shift;
+      if (bit_shift && src > 0) {
+        word |= entry->window[src - 1] >> (64 - bit_shift);
+      }
+    }
+    entry->window[i] = word;
+  }
+}
+
 int
 olsr_message_is_duplicate(union olsr_message *m)
 {
   struct dup_entry *entry;
   int diff;
-  void *mainIp;
-  uint32_t valid_until;
+  uint32_t valid_until, hash;
   struct ipaddr_str buf;
   uint16_t seqnr;
   void *ip;
+  unsigned int bit;
+  uint64_t bitmask;
 
-  if (olsr_cnf->ip_version == AF_INET) {
+  if (OLSR_IP_VERSION == AF_INET) {
     seqnr = ntohs(m->v4.seqno);
     ip = &m->v4.originator;
   } else {
@@ -131,64 +339,60 @@ olsr_message_is_duplicate(union olsr_message *m)
     ip = &m->v6.originator;
   }
 
-  // get main address
-  mainIp = mid_lookup_main_addr(ip);
-  if (mainIp == NULL) {
-    mainIp = ip;
-  }
-
   valid_until = GET_TIMESTAMP(DUPLICATE_VTIME);
+  hash = olsr_ip_hash(ip);
 
-  entry = (struct dup_entry *)avl_find(&duplicate_set, ip);
+  entry = olsr_lookup_duplicate_entry(ip, hash);
   if (entry == NULL) {
     entry = olsr_create_duplicate_entry(ip, seqnr);
     if (entry != NULL) {
-      avl_insert(&duplicate_set, &entry->avl, 0);
-      entry->valid_until = valid_until;
+      olsr_set_duplicate_expiry(entry, valid_until);
+      entry->window[0] = 1;
     }
     return false;               // okay, we process this package
   }
 
 
   // update timestamp
-  if (valid_until > entry->valid_until) {
-    entry->valid_until = valid_until;
+  if ((int32_t)(valid_until - entry->valid_until) > 0) {
+    olsr_set_duplicate_expiry(entry, valid_until);
   }
 
   diff = olsr_seqno_diff(seqnr, entry->seqnr);
-  if (diff < -31) {
+  if (diff < -(int)(dup_window_bits - 1)) {
     entry->too_low_counter++;
 
     // client did restart with a lower number ?
     if (entry->too_low_counter > DUP_MAX_TOO_LOW) {
       entry->too_low_counter = 0;
       entry->seqnr = seqnr;
-      entry->array = 1;
+      memset(entry->window, 0, dup_window_words * sizeof(uint64_t));
+      entry->window[0] = 1;
       return false;             /* start with a new sequence number, so NO duplicate */
     }
-    OLSR_PRINTF(9, "blocked 0x%x from %s\n", seqnr, olsr_ip_to_string(&buf, mainIp));
+    OLSR_PRINTF(9, "blocked 0x%x from %s\n", seqnr, olsr_ip_to_string(&buf, olsr_duplicate_main_addr(ip)));
     return true;                /* duplicate ! */
   }
 
   entry->too_low_counter = 0;
   if (diff <= 0) {
-    uint32_t bitmask = 1 << ((uint32_t) (-diff));
+    bit = (unsigned int)(-diff);
+    bitmask = (uint64_t)1 << (bit % 64);
 
-    if ((entry->array & bitmask) != 0) {
-      OLSR_PRINTF(9, "blocked 0x%x (diff=%d,mask=%08x) from %s\n", seqnr, diff, entry->array, olsr_ip_to_string(&buf, mainIp));
+    if ((entry->window[bit / 64] & bitmask) != 0) {
+      OLSR_PRINTF(9, "blocked 0x%x (diff=%d) from %s\n", seqnr, diff,
+                  olsr_ip_to_string(&buf, olsr_duplicate_main_addr(ip)));
       return true;              /* duplicate ! */
     }
-    entry->array |= bitmask;
-    OLSR_PRINTF(9, "processed 0x%x from %s\n", seqnr, olsr_ip_to_string(&buf, mainIp));
+    entry->window[bit / 64] |= bitmask;
+    OLSR_PRINTF(9, "processed 0x%x from %s\n", seqnr, olsr_ip_to_string(&buf, olsr_duplicate_main_addr(ip)));
     return false;               /* no duplicate */
-  } else if (diff < 32) {
-    entry->array <<= (uint32_t) diff;
-  } else {
-    entry->array = 0;
   }
-  entry->array |= 1;
+
+  olsr_shift_duplicate_window(entry, diff);
+  entry->window[0] |= 1;
   entry->seqnr = seqnr;
-  OLSR_PRINTF(9, "processed 0x%x from %s\n", seqnr, olsr_ip_to_string(&buf, mainIp));
+  OLSR_PRINTF(9, "processed 0x%x from %s\n", seqnr, olsr_ip_to_string(&buf, olsr_duplicate_main_addr(ip)));
   return false;                 /* no duplicate */
 }
 
@@ -198,15 +402,15 @@ olsr_print_duplicate_table(void)
 {
   /* The whole function makes no sense without it. */
   struct dup_entry *entry;
-  const int ipwidth = olsr_cnf->ip_version == AF_INET ? (INET_ADDRSTRLEN - 1) : (INET6_ADDRSTRLEN - 1);
+  const int ipwidth = OLSR_IP_VERSION == AF_INET ? (INET_ADDRSTRLEN - 1) : (INET6_ADDRSTRLEN - 1);
   struct ipaddr_str addrbuf;
 
-  OLSR_PRINTF(1, "\n--- %s ------------------------------------------------- DUPLICATE SET\n\n" "%-*s %8s %s\n",
+  OLSR_PRINTF(1, "\n--- %s ------------------------------------------------- DUPLICATE SET\n\n" "%-*s %16s %s\n",
               olsr_wallclock_string(), ipwidth, "Node IP", "DupArray", "VTime");
 
   OLSR_FOR_ALL_DUP_ENTRIES(entry) {
-    OLSR_PRINTF(1, "%-*s %08x %s\n", ipwidth, olsr_ip_to_string(&addrbuf, (union olsr_ip_addr *)(entry->avl.key)),
-                entry->array, olsr_clock_string(entry->valid_until));
+    OLSR_PRINTF(1, "%-*s %016llx %s\n", ipwidth, olsr_ip_to_string(&addrbuf, &entry->ip),
+                (unsigned long long)entry->window[0], olsr_clock_string(entry->valid_until));
   } OLSR_FOR_ALL_DUP_ENTRIES_END(entry);
 }
 #endif /* NODEBUG */
@@ -45,23 +45,37 @@
 #include "defs.h"
 #include "olsr.h"
 #include "mantissa.h"
-#include "common/avl.h"
+#include "common/list.h"
+#include "olsr_cookie.h"
 
 #define DUPLICATE_CLEANUP_INTERVAL 15000
 #define DUPLICATE_CLEANUP_JITTER 25
 #define DUPLICATE_VTIME 120000
 #define DUP_MAX_TOO_LOW 16
 
+/* Number of expiry slots, each one covers a cleanup interval */
+#define DUP_EXPIRY_SLOTS (DUPLICATE_VTIME / DUPLICATE_CLEANUP_INTERVAL + 2)
+
+/* Initial number of hash buckets, doubled when the load exceeds 2 */
+#define DUP_HASH_INITIAL_SIZE 256
+
 struct dup_entry {
-  struct avl_node avl;
-  union olsr_ip_addr ip;
-  uint16_t seqnr;
-  uint16_t too_low_counter;
-  uint32_t array;
+  struct dup_entry *hash_next;         /* next entry in the same hash bucket */
+  struct list_node expiry_node;        /* member of an expiry slot */
+  union olsr_ip_addr ip;               /* originator address */
+  uint32_t hash;                       /* full hash of ip */
   uint32_t valid_until;
+  uint16_t seqnr;                      /* highest sequence number seen, bit 0 of the window */
+  uint16_t too_low_counter;
+  uint8_t expiry_slot;                 /* index of the expiry slot */
+  uint64_t window[0];                  /* sliding window of seen sequence numbers */
 };
 
-AVLNODE2STRUCT(duptree2dupentry, struct dup_entry, avl);
+LISTNODE2STRUCT(expiry2dupentry, struct dup_entry, expiry_node);
+
+extern struct dup_entry **dup_hash;
+extern uint32_t dup_hash_size;
+extern struct olsr_cookie_info *dup_mem_cookie;
 
 void olsr_init_duplicate_set(void);
 void olsr_cleanup_duplicates(union olsr_ip_addr *orig);
@@ -76,12 +90,12 @@ void olsr_print_duplicate_table(void);
 
 #define OLSR_FOR_ALL_DUP_ENTRIES(dup) \
 { \
-  struct avl_node *dup_tree_node, *next_dup_tree_node; \
-  for (dup_tree_node = avl_walk_first(&duplicate_set); \
-    dup_tree_node; dup_tree_node = next_dup_tree_node) { \
-    next_dup_tree_node = avl_walk_next(dup_tree_node); \
-    dup = duptree2dupentry(dup_tree_node);
-#define OLSR_FOR_ALL_DUP_ENTRIES_END(dup) }}
+  uint32_t dup_bucket; \
+  struct dup_entry *next_dup; \
+  for (dup_bucket = 0; dup_bucket < dup_hash_size; dup_bucket++) { \
+    for (dup = dup_hash[dup_bucket]; dup; dup = next_dup) { \
+      next_dup = dup->hash_next;
+#define OLSR_FOR_ALL_DUP_ENTRIES_END(dup) }}}
 
 #endif /* DUPLICATE_SET_2_H_ */
 
@@ -96,7 +96,7 @@ static void olsr_delete_gateway_tree_entry(struct gateway_entry * gw, uint8_t pr
  * @return the gateway 'server' tunnel name to use
  */
 static inline const char * server_tunnel_name(void) {
-  return (olsr_cnf->ip_version == AF_INET ? TUNNEL_ENDPOINT_IF : TUNNEL_ENDPOINT_IF6);
+  return (OLSR_IP_VERSION == AF_INET ? TUNNEL_ENDPOINT_IF : TUNNEL_ENDPOINT_IF6);
 }
 
 /**
@@ -187,7 +187,7 @@ static struct interfaceName * find_interfaceName(struct gateway_entry *gw) {
   assert(sgwTunnel4InterfaceNames);
   assert(sgwTunnel6InterfaceNames);
 
-  sgwTunnelInterfaceNames = (olsr_cnf->ip_version == AF_INET) ? sgwTunnel4InterfaceNames : sgwTunnel6InterfaceNames;
+  sgwTunnelInterfaceNames = (OLSR_IP_VERSION == AF_INET) ? sgwTunnel4InterfaceNames : sgwTunnel6InterfaceNames;
   while (i < olsr_cnf->smart_gw_use_count) {
     struct interfaceName * ifn = &sgwTunnelInterfaceNames[i];
     if (ifn->gw == gw) {
@@ -228,7 +228,7 @@ static void get_unused_iptunnel_name(struct gateway_entry *gw, char * name, stru
     /* do not return, fall-through to classic naming as fallback */
   }
 
-  snprintf(name, IFNAMSIZ, "tnl_%08x", (olsr_cnf->ip_version == AF_INET) ? gw->originator.v4.s_addr : ++counter);
+  snprintf(name, IFNAMSIZ, "tnl_%08x", (OLSR_IP_VERSION == AF_INET) ? gw->originator.v4.s_addr : ++counter);
   *interfaceName = NULL;
 }
 
@@ -270,7 +270,7 @@ static bool multiGwRunScript(const char * mode, bool add, const char * ifname, u
 
   abuf_appendf(&buf, "\"%s\"", olsr_cnf->smart_gw_policyrouting_script);
 
-  abuf_appendf(&buf, " \"%s\"", (olsr_cnf->ip_version == AF_INET) ? "ipv4" : "ipv6");
+  abuf_appendf(&buf, " \"%s\"", (OLSR_IP_VERSION == AF_INET) ? "ipv4" : "ipv6");
 
   assert(!strcmp(mode, SCRIPT_MODE_GENERIC) || !strcmp(mode, SCRIPT_MODE_OLSRIF) ||
       !strcmp(mode, SCRIPT_MODE_SGWSRVTUN) || !strcmp(mode, SCRIPT_MODE_EGRESSIF) ||
@@ -407,7 +407,7 @@ static bool multiGwRulesSgwTunnels(bool add) {
   unsigned int i = 0;
 
   while (i < olsr_cnf->smart_gw_use_count) {
-    struct interfaceName * ifn = (olsr_cnf->ip_version == AF_INET) ? &sgwTunnel4InterfaceNames[i] : &sgwTunnel6InterfaceNames[i];
+    struct interfaceName * ifn = (OLSR_IP_VERSION == AF_INET) ? &sgwTunnel4InterfaceNames[i] : &sgwTunnel6InterfaceNames[i];
     if (!multiGwRunScript(SCRIPT_MODE_SGWTUN, add, ifn->name, &ifn->mark)) {
       ok = false;
       if (add) {
@@ -761,11 +761,11 @@ void olsr_trigger_inetgw_startup(void) {
 void olsr_print_gateway_entries(void) {
   struct ipaddr_str buf;
   struct gateway_entry *gw;
-  const int addrsize = olsr_cnf->ip_version == AF_INET ? (INET_ADDRSTRLEN - 1) : (INET6_ADDRSTRLEN - 1);
+  const int addrsize = OLSR_IP_VERSION == AF_INET ? (INET_ADDRSTRLEN - 1) : (INET6_ADDRSTRLEN - 1);
 
   OLSR_PRINTF(0, "\n--- %s ---------------------------------------------------- GATEWAYS\n\n", olsr_wallclock_string());
   OLSR_PRINTF(0, "%-*s %-6s %-9s %-9s %s\n",
-      addrsize, "IP address", "Type", "Uplink", "Downlink", olsr_cnf->ip_version == AF_INET ? "" : "External Prefix");
+      addrsize, "IP address", "Type", "Uplink", "Downlink", OLSR_IP_VERSION == AF_INET ? "" : "External Prefix");
 
   OLSR_FOR_ALL_GATEWAY_ENTRIES(gw) {
     OLSR_PRINTF(0, "%-*s %s%c%s%c%c %-9u %-9u %s\n",
@@ -833,7 +833,7 @@ void refresh_smartgw_netmask(void) {
     ip[GW_HNA_DOWNLINK] = serialize_gw_speed(olsr_cnf->smart_gw_downlink);
     ip[GW_HNA_UPLINK] = serialize_gw_speed(olsr_cnf->smart_gw_uplink);
 
-    if (olsr_cnf->ip_version == AF_INET6 && olsr_cnf->smart_gw_prefix.prefix_len > 0) {
+    if (OLSR_IP_VERSION == AF_INET6 && olsr_cnf->smart_gw_prefix.prefix_len > 0) {
       ip[GW_HNA_FLAGS] |= GW_HNA_FLAG_IPV6PREFIX;
       ip[GW_HNA_V6PREFIXLEN] = olsr_cnf->smart_gw_prefix.prefix_len;
       memcpy(&ip[GW_HNA_V6PREFIX], &olsr_cnf->smart_gw_prefix.prefix, 8);
@@ -902,7 +902,7 @@ void olsr_update_gateway_entry(union olsr_ip_addr *originator, union olsr_ip_add
   gw->ipv4 = (ptr[GW_HNA_FLAGS] & GW_HNA_FLAG_IPV4) != 0;
   gw->ipv4nat = (ptr[GW_HNA_FLAGS] & GW_HNA_FLAG_IPV4_NAT) != 0;
 
-  if (olsr_cnf->ip_version == AF_INET6) {
+  if (OLSR_IP_VERSION == AF_INET6) {
     gw->ipv6 = (ptr[GW_HNA_FLAGS] & GW_HNA_FLAG_IPV6) != 0;
 
     /* do not reset prefixlength for ::ffff:0:0 HNAs */
@@ -910,7 +910,7 @@ void olsr_update_gateway_entry(union olsr_ip_addr *originator, union olsr_ip_add
       memset(&gw->external_prefix, 0, sizeof(gw->external_prefix));
 
       if ((ptr[GW_HNA_FLAGS] & GW_HNA_FLAG_IPV6PREFIX) != 0
-          && memcmp(mask->v6.s6_addr, &ipv6_internet_route.prefix, olsr_cnf->ipsize) == 0) {
+          && memcmp(mask->v6.s6_addr, &ipv6_internet_route.prefix, OLSR_IPSIZE) == 0) {
         /* this is the right prefix (2000::/3), so we can copy the prefix */
         gw->external_prefix.prefix_len = ptr[GW_HNA_V6PREFIXLEN];
         memcpy(&gw->external_prefix.prefix, &ptr[GW_HNA_V6PREFIX], 8);
@@ -982,14 +982,14 @@ static void olsr_delete_gateway_tree_entry(struct gateway_entry * gw, uint8_t pr
   if (gw->cleanup_timer == NULL || gw->ipv4 || gw->ipv6) {
     /* the gw  is not scheduled for deletion */
 
-    if (olsr_cnf->ip_version == AF_INET && prefixlen == 0) {
+    if (OLSR_IP_VERSION == AF_INET && prefixlen == 0) {
       change = gw->ipv4;
       gw->ipv4 = false;
       gw->ipv4nat = false;
-    } else if (olsr_cnf->ip_version == AF_INET6 && prefixlen == ipv6_internet_route.prefix_len) {
+    } else if (OLSR_IP_VERSION == AF_INET6 && prefixlen == ipv6_internet_route.prefix_len) {
       change = gw->ipv6;
       gw->ipv6 = false;
-    } else if (olsr_cnf->ip_version == AF_INET6 && prefixlen == ipv6_mappedv4_route.prefix_len) {
+    } else if (OLSR_IP_VERSION == AF_INET6 && prefixlen == ipv6_mappedv4_route.prefix_len) {
       change = gw->ipv4;
       gw->ipv4 = false;
       gw->ipv4nat = false;
@@ -1111,8 +1111,8 @@ void olsr_trigger_gatewayloss_check(void) {
 bool olsr_set_inet_gateway(union olsr_ip_addr *originator, uint64_t path_cost, bool ipv4, bool ipv6) {
   struct gateway_entry *new_gw;
 
-  ipv4 = ipv4 && (olsr_cnf->ip_version == AF_INET || olsr_cnf->use_niit);
-  ipv6 = ipv6 && (olsr_cnf->ip_version == AF_INET6);
+  ipv4 = ipv4 && (OLSR_IP_VERSION == AF_INET || olsr_cnf->use_niit);
+  ipv6 = ipv6 && (OLSR_IP_VERSION == AF_INET6);
   if (!ipv4 && !ipv6) {
     return true;
   }
@@ -190,7 +190,7 @@ static void gw_default_choose_gateway(void) {
 
     if (gw_def_choose_new_ipv4_gw) {
       bool gw_eligible_v4 = gw->ipv4
-          /* && (olsr_cnf->ip_version == AF_INET || olsr_cnf->use_niit) *//* contained in gw_def_choose_new_ipv4_gw */
+          /* && (OLSR_IP_VERSION == AF_INET || olsr_cnf->use_niit) *//* contained in gw_def_choose_new_ipv4_gw */
           && (olsr_cnf->smart_gw_allow_nat || !gw->ipv4nat);
       if (gw_eligible_v4 && gw_cost < chosen_gw_ipv4_costs
           && (!cost_ipv4_threshold_valid || (gw_cost < cost_ipv4_threshold))) {
@@ -201,7 +201,7 @@ static void gw_default_choose_gateway(void) {
 
     if (gw_def_choose_new_ipv6_gw) {
       bool gw_eligible_v6 = gw->ipv6
-          /* && olsr_cnf->ip_version == AF_INET6 *//* contained in gw_def_choose_new_ipv6_gw */;
+          /* && OLSR_IP_VERSION == AF_INET6 *//* contained in gw_def_choose_new_ipv6_gw */;
       if (gw_eligible_v6 && gw_cost < chosen_gw_ipv6_costs
           && (!cost_ipv6_threshold_valid || (gw_cost < cost_ipv6_threshold))) {
         chosen_gw_ipv6 = gw;
@@ -271,11 +271,11 @@ static void gw_default_timer(void *unused __attribute__ ((unused))) {
 static void gw_default_lookup_gateway(bool ipv4, bool ipv6) {
   if (ipv4) {
     /* get a new IPv4 gateway if we use OLSRv4 or NIIT */
-    gw_def_choose_new_ipv4_gw = (olsr_cnf->ip_version == AF_INET) || olsr_cnf->use_niit;
+    gw_def_choose_new_ipv4_gw = (OLSR_IP_VERSION == AF_INET) || olsr_cnf->use_niit;
   }
   if (ipv6) {
     /* get a new IPv6 gateway if we use OLSRv6 */
-    gw_def_choose_new_ipv6_gw = olsr_cnf->ip_version == AF_INET6;
+    gw_def_choose_new_ipv6_gw = OLSR_IP_VERSION == AF_INET6;
   }
 
   if (gw_def_choose_new_ipv4_gw || gw_def_choose_new_ipv6_gw) {
@@ -318,10 +318,10 @@ static void gw_default_startup_handler(void) {
   gw_def_stablecount = 0;
 
   /* get a new IPv4 gateway if we use OLSRv4 or NIIT */
-  gw_def_choose_new_ipv4_gw = (olsr_cnf->ip_version == AF_INET) || olsr_cnf->use_niit;
+  gw_def_choose_new_ipv4_gw = (OLSR_IP_VERSION == AF_INET) || olsr_cnf->use_niit;
 
   /* get a new IPv6 gateway if we use OLSRv6 */
-  gw_def_choose_new_ipv6_gw = olsr_cnf->ip_version == AF_INET6;
+  gw_def_choose_new_ipv6_gw = OLSR_IP_VERSION == AF_INET6;
 
   /* keep in mind we might be a gateway ourself */
   gw_def_choose_new_ipv4_gw = gw_def_choose_new_ipv4_gw && !olsr_cnf->has_ipv4_gateway;
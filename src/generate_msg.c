@@ -69,10 +69,11 @@ generate_hello(void *p)
   struct hello_message hellopacket;
   struct interface *ifn = (struct interface *)p;
 
+  olsr_adapt_hello_interval(ifn);
   olsr_build_hello_packet(&hellopacket, ifn);
 
-  if (queue_hello(&hellopacket, ifn))
-    net_output(ifn);
+  queue_hello(&hellopacket, ifn);
+  net_output_periodic(ifn, ifn->olsr_if->cnf->hello_params.emission_interval, HELLO_JITTER);
 
   olsr_free_hello_packet(&hellopacket);
 
@@ -84,11 +85,11 @@ generate_tc(void *p)
   struct tc_message tcpacket;
   struct interface *ifn = (struct interface *)p;
 
+  olsr_adapt_tc_interval(ifn);
   olsr_build_tc_packet(&tcpacket);
 
-  if (queue_tc(&tcpacket, ifn) && TIMED_OUT(ifn->fwdtimer)) {
-    set_buffer_timer(ifn);
-  }
+  queue_tc(&tcpacket, ifn);
+  net_output_periodic(ifn, ifn->olsr_if->cnf->tc_params.emission_interval, TC_JITTER);
 
   olsr_free_tc_packet(&tcpacket);
 }
@@ -98,10 +99,8 @@ generate_mid(void *p)
 {
   struct interface *ifn = (struct interface *)p;
 
-  if (queue_mid(ifn) && TIMED_OUT(ifn->fwdtimer)) {
-    set_buffer_timer(ifn);
-  }
-
+  queue_mid(ifn);
+  net_output_periodic(ifn, ifn->olsr_if->cnf->mid_params.emission_interval, MID_JITTER);
 }
 
 void
@@ -109,9 +108,8 @@ generate_hna(void *p)
 {
   struct interface *ifn = (struct interface *)p;
 
-  if (queue_hna(ifn) && TIMED_OUT(ifn->fwdtimer)) {
-    set_buffer_timer(ifn);
-  }
+  queue_hna(ifn);
+  net_output_periodic(ifn, ifn->olsr_if->cnf->hna_params.emission_interval, HNA_JITTER);
 }
 
 void
@@ -136,16 +136,16 @@ jenkins_hash(const uint8_t * k, uint32_t length)
 }
 
 /**
- * Hashing function. Creates a key based on an IP address.
+ * Hashing function. Creates a full 32 bit key based on an IP address.
  * @param address the address to hash
- * @return the hash(a value in the (0 to HASHMASK-1) range)
+ * @return the hash
  */
 uint32_t
-olsr_ip_hashing(const union olsr_ip_addr * address)
+olsr_ip_hash(const union olsr_ip_addr * address)
 {
   uint32_t hash;
 
-  switch (olsr_cnf->ip_version) {
+  switch (OLSR_IP_VERSION) {
   case AF_INET:
     hash = jenkins_hash((const uint8_t *)&address->v4, sizeof(uint32_t));
     break;
@@ -157,7 +157,18 @@ olsr_ip_hashing(const union olsr_ip_addr * address)
     break;
 
   }
-  return hash & HASHMASK;
+  return hash;
+}
+
+/**
+ * Hashing function. Creates a key based on an IP address.
+ * @param address the address to hash
+ * @return the hash(a value in the (0 to HASHMASK-1) range)
+ */
+uint32_t
+olsr_ip_hashing(const union olsr_ip_addr * address)
+{
+  return olsr_ip_hash(address) & HASHMASK;
 }
 
 /*
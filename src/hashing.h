@@ -47,6 +47,7 @@
 
 #include "olsr_types.h"
 
+uint32_t olsr_ip_hash(const union olsr_ip_addr *);
 uint32_t olsr_ip_hashing(const union olsr_ip_addr *);
 
 #endif /* _OLSR_HASHING */
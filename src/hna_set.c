@@ -73,6 +73,7 @@ olsr_init_hna_set(void)
 
   hna_net_mem_cookie = olsr_alloc_cookie("hna_net", OLSR_COOKIE_TYPE_MEMORY);
   olsr_cookie_set_memory_size(hna_net_mem_cookie, sizeof(struct hna_net));
+  olsr_cookie_set_budget(hna_net_mem_cookie, olsr_cnf->max_hna_nets);
 
   hna_entry_mem_cookie = olsr_alloc_cookie("hna_entry", OLSR_COOKIE_TYPE_MEMORY);
   olsr_cookie_set_memory_size(hna_entry_mem_cookie, sizeof(struct hna_entry));
@@ -276,13 +277,22 @@ olsr_update_hna_entry(const union olsr_ip_addr *gw, const union olsr_ip_addr *ne
   struct hna_net *net_entry;
 
   gw_entry = olsr_lookup_hna_gw(gw);
+  net_entry = gw_entry ? olsr_lookup_hna_net(&gw_entry->networks, net, prefixlen) : NULL;
+
+  /*
+   * Refuse new networks beyond the budget.
+   */
+  if (net_entry == NULL && olsr_cookie_budget_exhausted(hna_net_mem_cookie)) {
+    hna_net_mem_cookie->ci_refused++;
+    return;
+  }
+
   if (!gw_entry) {
 
     /* Need to add the entry */
     gw_entry = olsr_add_hna_entry(gw);
   }
 
-  net_entry = olsr_lookup_hna_net(&gw_entry->networks, net, prefixlen);
   if (net_entry == NULL) {
 
     /* Need to add the net */
@@ -316,8 +326,8 @@ olsr_print_hna_set(void)
   int idx;
   struct tm * nowtm;
   struct timeval now;
-  const int ipwidth = olsr_cnf->ip_version == AF_INET ? (INET_ADDRSTRLEN - 1) : (INET6_ADDRSTRLEN - 1);
-  const int ipwidthprefix = olsr_cnf->ip_version == AF_INET ? (INET_ADDRSTRLEN + 1 + INET_ADDRSTRLEN - 1) : (INET6_ADDRSTRLEN + 1 + 3 - 1);
+  const int ipwidth = OLSR_IP_VERSION == AF_INET ? (INET_ADDRSTRLEN - 1) : (INET6_ADDRSTRLEN - 1);
+  const int ipwidthprefix = OLSR_IP_VERSION == AF_INET ? (INET_ADDRSTRLEN + 1 + INET_ADDRSTRLEN - 1) : (INET6_ADDRSTRLEN + 1 + 3 - 1);
 
 	(void)gettimeofday(&now, NULL);
   nowtm = localtime((time_t *)&now.tv_sec);
@@ -325,7 +335,7 @@ olsr_print_hna_set(void)
   OLSR_PRINTF(1, "\n--- %02d:%02d:%02d.%02d ------------------------------------------------- HNA SET\n\n", nowtm->tm_hour,
               nowtm->tm_min, nowtm->tm_sec, (int)now.tv_usec / 10000);
 
-  if (olsr_cnf->ip_version == AF_INET)
+  if (OLSR_IP_VERSION == AF_INET)
     OLSR_PRINTF(1, "IP net          netmask         GW IP\n");
   else
     OLSR_PRINTF(1, "IP net/prefixlen               GW IP\n");
@@ -372,8 +382,9 @@ olsr_input_hna(union olsr_message *m, struct interface *in_if __attribute__ ((un
   uint8_t hop_count;
   uint16_t msg_seq_number;
 
-  int hnasize;
+  int hnasize, entries, i;
   const uint8_t *curr, *curr_end;
+  struct olsr_addr_block nets, masks;
 
   struct ipaddr_str buf;
 #ifdef DEBUG
@@ -388,7 +399,7 @@ olsr_input_hna(union olsr_message *m, struct interface *in_if __attribute__ ((un
 
   /* olsr_msgtype */
   pkt_get_u8(&curr, &olsr_msgtype);
-  if (olsr_msgtype != HNA_MESSAGE) {
+  if (olsr_msgtype != HNA_MESSAGE && olsr_msgtype != HNA_COMPACT_MESSAGE) {
     OLSR_PRINTF(1, "not a HNA message!\n");
     return false;
   }
@@ -398,7 +409,7 @@ olsr_input_hna(union olsr_message *m, struct interface *in_if __attribute__ ((un
   /* olsr_msgsize */
   pkt_get_u16(&curr, &olsr_msgsize);
 
-  hnasize = olsr_msgsize - 8 - olsr_cnf->ipsize;
+  hnasize = olsr_msgsize - 8 - OLSR_IPSIZE;
   curr_end = (const uint8_t *)m + olsr_msgsize;
 
   /* validate originator */
@@ -414,10 +425,23 @@ olsr_input_hna(union olsr_message *m, struct interface *in_if __attribute__ ((un
   /* seqno */
   pkt_get_u16(&curr, &msg_seq_number);
 
-  if ((hnasize % (2 * olsr_cnf->ipsize)) != 0) {
-    OLSR_PRINTF(1, "Illegal HNA message from %s with size %d!\n",
-        olsr_ip_to_string(&buf, &originator), olsr_msgsize);
-    return false;
+  if (olsr_msgtype == HNA_COMPACT_MESSAGE) {
+
+    /* one address block for the networks, one for their netmasks */
+    if (!pkt_get_addr_block(&curr, curr_end, &nets) || !pkt_get_addr_block(&curr, curr_end, &masks)
+        || nets.count != masks.count) {
+      OLSR_PRINTF(1, "Illegal compact HNA message from %s with size %d!\n",
+          olsr_ip_to_string(&buf, &originator), olsr_msgsize);
+      return false;
+    }
+    entries = nets.count;
+  } else {
+    if ((hnasize % (2 * OLSR_IPSIZE)) != 0) {
+      OLSR_PRINTF(1, "Illegal HNA message from %s with size %d!\n",
+          olsr_ip_to_string(&buf, &originator), olsr_msgsize);
+      return false;
+    }
+    entries = hnasize / (2 * OLSR_IPSIZE);
   }
 
   /*
@@ -429,7 +453,7 @@ olsr_input_hna(union olsr_message *m, struct interface *in_if __attribute__ ((un
     OLSR_PRINTF(2, "Received HNA from NON SYM neighbor %s\n", olsr_ip_to_string(&buf, from_addr));
     return false;
   }
-  while (curr < curr_end) {
+  for (i = 0; i < entries; i++) {
     struct olsr_ip_prefix prefix;
     union olsr_ip_addr mask;
 
@@ -437,8 +461,13 @@ olsr_input_hna(union olsr_message *m, struct interface *in_if __attribute__ ((un
     struct interface *ifs;
     bool stop = false;
 
-    pkt_get_ipaddress(&curr, &prefix.prefix);
-    pkt_get_ipaddress(&curr, &mask);
+    if (olsr_msgtype == HNA_COMPACT_MESSAGE) {
+      olsr_addr_block_get(&nets, i, &prefix.prefix);
+      olsr_addr_block_get(&masks, i, &mask);
+    } else {
+      pkt_get_ipaddress(&curr, &prefix.prefix);
+      pkt_get_ipaddress(&curr, &mask);
+    }
     prefix.prefix_len = olsr_netmask_to_prefix(&mask);
 
 #ifdef __linux__
@@ -46,6 +46,7 @@
 #include "olsr_types.h"
 #include "olsr_protocol.h"
 #include "mantissa.h"
+#include "olsr_cookie.h"
 
 #include <time.h>
 
@@ -80,6 +81,8 @@ struct hna_entry {
 #define OLSR_FOR_ALL_HNA_ENTRIES_END(hna) }}}
 
 extern struct hna_entry hna_set[HASHSIZE];
+extern struct olsr_cookie_info *hna_entry_mem_cookie;
+extern struct olsr_cookie_info *hna_net_mem_cookie;
 
 int olsr_init_hna_set(void);
 void olsr_cleanup_hna(union olsr_ip_addr *orig);
@@ -51,6 +51,9 @@
 #include "ipcalc.h"
 #include "log.h"
 #include "parser.h"
+#include "lq_packet.h"
+#include "mantissa.h"
+#include "generate_msg.h"
 
 #ifdef _WIN32
 #include <winbase.h>
@@ -68,12 +71,17 @@ struct ifchgf {
 
 static struct ifchgf *ifchgf_list;
 
+/* Changes of the HELLO and TC contents, see olsr_hello_churn() */
+static uint32_t hello_churn;
+static uint32_t tc_churn;
+
 /* Some cookies for stats keeping */
 struct olsr_cookie_info *interface_poll_timer_cookie = NULL;
 struct olsr_cookie_info *hello_gen_timer_cookie = NULL;
 struct olsr_cookie_info *tc_gen_timer_cookie = NULL;
 struct olsr_cookie_info *mid_gen_timer_cookie = NULL;
 struct olsr_cookie_info *hna_gen_timer_cookie = NULL;
+static struct olsr_cookie_info *tc_trigger_timer_cookie = NULL;
 
 /**
  *Do initialization of various data needed for
@@ -99,6 +107,7 @@ olsr_init_interfacedb(void)
   tc_gen_timer_cookie = olsr_alloc_cookie("TC Generation", OLSR_COOKIE_TYPE_TIMER);
   mid_gen_timer_cookie = olsr_alloc_cookie("MID Generation", OLSR_COOKIE_TYPE_TIMER);
   hna_gen_timer_cookie = olsr_alloc_cookie("HNA Generation", OLSR_COOKIE_TYPE_TIMER);
+  tc_trigger_timer_cookie = olsr_alloc_cookie("TC Trigger", OLSR_COOKIE_TYPE_TIMER);
 
   OLSR_PRINTF(1, "\n ---- Interface configuration ---- \n\n");
   /* Run trough all interfaces immedeatly */
@@ -111,9 +120,11 @@ olsr_init_interfacedb(void)
     }
   }
 
+#ifndef __linux__
   /* Kick a periodic timer for the network interface update function */
   olsr_start_timer((unsigned int)olsr_cnf->nic_chgs_pollrate * MSEC_PER_SEC, 5, OLSR_TIMER_PERIODIC, &check_interface_updates, NULL,
                    interface_poll_timer_cookie);
+#endif /* __linux__ */
 
   return (ifnet == NULL) ? 0 : 1;
 }
@@ -147,7 +158,7 @@ if_ifwithaddr(const union olsr_ip_addr *addr)
     return NULL;
 
   for (ifp = ifnet; ifp; ifp = ifp->int_next) {
-    if (olsr_cnf->ip_version == AF_INET) {
+    if (OLSR_IP_VERSION == AF_INET) {
       /* IPv4 */
       //printf("Checking: %s == ", inet_ntoa(((struct sockaddr_in *)&ifp->int_addr)->sin_addr));
       //printf("%s\n", olsr_ip_to_string(addr));
@@ -397,8 +408,12 @@ olsr_remove_interface(struct olsr_if * iface)
     tmp_ifp->int_next = ifp->int_next;
   }
 
+  /* Drop the messages received on it which are still queued */
+  olsr_parser_flush_interface(ifp);
+
   /* Remove output buffer */
   net_remove_buffer(ifp);
+  olsr_free_lq_msg_cache(ifp);
 
   /*
    * Deregister functions for periodic message generation
@@ -407,6 +422,7 @@ olsr_remove_interface(struct olsr_if * iface)
   olsr_stop_timer(ifp->tc_gen_timer);
   olsr_stop_timer(ifp->mid_gen_timer);
   olsr_stop_timer(ifp->hna_gen_timer);
+  olsr_stop_timer(ifp->tc_trigger_timer);
 
   iface->configured = 0;
   iface->interf = NULL;
@@ -428,6 +444,250 @@ olsr_remove_interface(struct olsr_if * iface)
   }
 }
 
+/*
+ * Stretch the HELLO interval of the interface by the given factor,
+ * the advertised htime and vtime follow the interval.
+ */
+static void
+set_hello_factor(struct interface *ifp, uint8_t factor)
+{
+  const struct if_config_options *cnf = ifp->olsr_if->cnf;
+
+  ifp->hello_factor = factor;
+  ifp->hello_etime = (olsr_reltime) (cnf->hello_params.emission_interval * factor * MSEC_PER_SEC);
+  ifp->valtimes.hello = reltime_to_me(cnf->hello_params.validity_time * factor * MSEC_PER_SEC);
+}
+
+/*
+ * Stretch the TC interval of the interface by the given factor,
+ * the advertised vtime follows the interval.
+ */
+static void
+set_tc_factor(struct interface *ifp, uint8_t factor)
+{
+  const struct if_config_options *cnf = ifp->olsr_if->cnf;
+
+  ifp->tc_factor = factor;
+  ifp->valtimes.tc = reltime_to_me(cnf->tc_params.validity_time * factor * MSEC_PER_SEC);
+}
+
+/*
+ * Next factor of an interval: back to the configured interval
+ * if the contents changed since the last message, doubled up
+ * to AdaptiveIntervals otherwise.
+ */
+static uint8_t
+next_factor(uint8_t factor, uint32_t *seen, uint32_t churn)
+{
+  if (*seen != churn) {
+    *seen = churn;
+    return 1;
+  }
+  if (factor * 2 > olsr_cnf->adaptive_intervals) {
+    return olsr_cnf->adaptive_intervals;
+  }
+  return factor * 2;
+}
+
+/**
+ *Signal a change of the link set, the neighbor states or the
+ *MPR set. Interfaces with a stretched HELLO interval fall back
+ *to the configured one, the next HELLO is sent after at most
+ *one configured interval.
+ */
+void
+olsr_hello_churn(void)
+{
+  struct interface *ifp;
+
+  hello_churn++;
+
+  if (olsr_cnf->adaptive_intervals <= 1) {
+    return;
+  }
+
+  for (ifp = ifnet; ifp != NULL; ifp = ifp->int_next) {
+    if (ifp->hello_factor > 1) {
+      set_hello_factor(ifp, 1);
+
+      if (ifp->hello_gen_timer != NULL && TIME_DUE(ifp->hello_gen_timer->timer_clock) > (int32_t)ifp->hello_etime) {
+        olsr_change_timer(ifp->hello_gen_timer, ifp->hello_etime, HELLO_JITTER, OLSR_TIMER_PERIODIC);
+      }
+    }
+  }
+}
+
+/**
+ *Signal a change of the MPR selectors or the advertised neighbor
+ *set, see olsr_hello_churn(). Link cost changes are not signalled.
+ */
+void
+olsr_tc_churn(void)
+{
+  struct interface *ifp;
+  unsigned int interval;
+
+  tc_churn++;
+
+  if (olsr_cnf->adaptive_intervals <= 1) {
+    return;
+  }
+
+  for (ifp = ifnet; ifp != NULL; ifp = ifp->int_next) {
+    if (ifp->tc_factor > 1) {
+      set_tc_factor(ifp, 1);
+
+      interval = ifp->olsr_if->cnf->tc_params.emission_interval * MSEC_PER_SEC;
+      if (ifp->tc_gen_timer != NULL && TIME_DUE(ifp->tc_gen_timer->timer_clock) > (int32_t)interval) {
+        olsr_change_timer(ifp->tc_gen_timer, interval, TC_JITTER, OLSR_TIMER_PERIODIC);
+      }
+    }
+  }
+}
+
+/**
+ *Pick the interval until the next HELLO of the interface,
+ *called right before a HELLO is generated so it advertises
+ *the interval which actually follows it.
+ *
+ *@param ifp the interface
+ */
+void
+olsr_adapt_hello_interval(struct interface *ifp)
+{
+  uint8_t factor;
+
+  ifp->hello_sent++;
+  ifp->hello_nominal += ifp->hello_factor;
+
+  if (olsr_cnf->adaptive_intervals <= 1) {
+    return;
+  }
+
+  factor = next_factor(ifp->hello_factor, &ifp->hello_churn, hello_churn);
+  if (factor != ifp->hello_factor) {
+    set_hello_factor(ifp, factor);
+    olsr_change_timer(ifp->hello_gen_timer, ifp->hello_etime, HELLO_JITTER, OLSR_TIMER_PERIODIC);
+  }
+}
+
+/**
+ *Pick the interval until the next TC of the interface,
+ *see olsr_adapt_hello_interval(). Also accounts the delay
+ *of the changes the TC carries, see olsr_trigger_tc().
+ *
+ *@param ifp the interface
+ */
+void
+olsr_adapt_tc_interval(struct interface *ifp)
+{
+  uint8_t factor;
+
+  ifp->tc_sent++;
+  ifp->tc_nominal += ifp->tc_factor;
+
+  ifp->tc_last = now_times;
+  if (ifp->tc_changed != 0) {
+    ifp->tc_delay_sum += now_times - ifp->tc_changed;
+    ifp->tc_delay_count++;
+    ifp->tc_changed = 0;
+  }
+
+  if (olsr_cnf->adaptive_intervals <= 1) {
+    return;
+  }
+
+  factor = next_factor(ifp->tc_factor, &ifp->tc_churn, tc_churn);
+  if (factor != ifp->tc_factor) {
+    set_tc_factor(ifp, factor);
+    olsr_change_timer(ifp->tc_gen_timer, ifp->olsr_if->cnf->tc_params.emission_interval * factor * MSEC_PER_SEC, TC_JITTER,
+                      OLSR_TIMER_PERIODIC);
+  }
+}
+
+/*
+ * Send a TC ahead of the TC interval, unless the token bucket
+ * of the interface is empty. The bucket gains one token per
+ * TC interval and holds up to TcTriggerBurst of them.
+ */
+static void
+send_triggered_tc(struct interface *ifp)
+{
+  uint32_t interval = ifp->olsr_if->cnf->tc_params.emission_interval * MSEC_PER_SEC;
+
+  if (TIME_DUE(ifp->tc_bucket) > (int32_t)((olsr_cnf->tc_trigger_burst - 1) * interval)) {
+    ifp->tc_limited++;
+    return;
+  }
+  if (TIME_DUE(ifp->tc_bucket) < 0) {
+    ifp->tc_bucket = now_times;
+  }
+  ifp->tc_bucket += interval;
+  ifp->tc_triggered++;
+
+  if (olsr_cnf->lq_level == 0) {
+    generate_tc(ifp);
+  } else {
+    olsr_output_lq_tc(ifp);
+  }
+
+  /* neighbors flood it at the same time, jitter it like a forwarded message */
+  net_output_forward(ifp);
+
+  /* the next periodic TC is a full interval away */
+  olsr_change_timer(ifp->tc_gen_timer, interval * ifp->tc_factor, TC_JITTER, OLSR_TIMER_PERIODIC);
+}
+
+/*
+ * Wrapper for the timer callback, the change waited for the
+ * TcTriggerGap.
+ */
+static void
+olsr_expire_tc_trigger(void *context)
+{
+  struct interface *ifp = context;
+
+  ifp->tc_trigger_timer = NULL;
+
+  /* a periodic TC may have carried the change meanwhile */
+  if (ifp->tc_changed != 0) {
+    send_triggered_tc(ifp);
+  }
+}
+
+/**
+ *Send the changed neighbor set in a TC right away instead of
+ *waiting for the next periodic one. Called whenever the ANSN
+ *changed, which includes relevant link cost changes.
+ *The TCs of an interface keep a gap of TcTriggerGap and
+ *a token bucket limits the triggered ones, see
+ *send_triggered_tc().
+ */
+void
+olsr_trigger_tc(void)
+{
+  struct interface *ifp;
+  int32_t gap;
+
+  for (ifp = ifnet; ifp != NULL; ifp = ifp->int_next) {
+    if (ifp->tc_changed == 0) {
+      ifp->tc_changed = now_times;
+    }
+
+    if (olsr_cnf->tc_trigger_burst == 0 || ifp->tc_trigger_timer != NULL) {
+      continue;
+    }
+
+    gap = TIME_DUE(ifp->tc_last + (uint32_t)(olsr_cnf->tc_trigger_gap * MSEC_PER_SEC));
+    if (gap > 0) {
+      olsr_set_timer(&ifp->tc_trigger_timer, gap, 0, OLSR_TIMER_ONESHOT, &olsr_expire_tc_trigger, ifp,
+                     tc_trigger_timer_cookie);
+      continue;
+    }
+    send_triggered_tc(ifp);
+  }
+}
+
 /*
  * Local Variables:
  * c-basic-offset: 2
@@ -110,6 +110,10 @@ struct olsr_netbuf {
   int maxsize;                         /* Max bytes of payload that can be added to the buffer */
   int pending;                         /* How much data is currently pending in the buffer */
   int reserved;                        /* Plugins can reserve space in buffers */
+  uint32_t deadline;                   /* Latest send time of the pending messages */
+  struct timer_entry *timer;           /* Sends the pending data at the deadline */
+  uint32_t packets;                    /* Packets sent */
+  uint32_t messages;                   /* Messages sent in them */
 };
 
 /**
@@ -161,8 +165,25 @@ struct interface {
   olsr_reltime hello_etime;
   struct vtimes valtimes;
 
-  /* Timeout for OLSR forwarding on this if */
-  uint32_t fwdtimer;
+  /* adaptive HELLO and TC intervals, see olsr_adapt_hello_interval() */
+  uint8_t hello_factor;                /* current multiple of the HELLO interval */
+  uint8_t tc_factor;                   /* current multiple of the TC interval */
+  uint32_t hello_churn;                /* churn counter at the last HELLO */
+  uint32_t tc_churn;                   /* churn counter at the last TC */
+  uint32_t hello_sent;                 /* HELLOs generated */
+  uint32_t hello_nominal;              /* HELLOs the fixed interval would have generated */
+  uint32_t tc_sent;                    /* TCs generated */
+  uint32_t tc_nominal;                 /* TCs the fixed interval would have generated */
+
+  /* triggered TCs, see olsr_trigger_tc() */
+  struct timer_entry *tc_trigger_timer;
+  uint32_t tc_bucket;                  /* time the token bucket is full again */
+  uint32_t tc_last;                    /* time of the last TC */
+  uint32_t tc_changed;                 /* time of the first change not yet in a TC, 0 if none */
+  uint32_t tc_triggered;               /* TCs sent ahead of the interval */
+  uint32_t tc_limited;                 /* changes left to the periodic TC by the rate limit */
+  uint32_t tc_delay_sum;               /* time from the changes to their TCs in ms */
+  uint32_t tc_delay_count;
 
   /* the buffer to construct the packet data */
   struct olsr_netbuf netbuf;
@@ -173,8 +194,9 @@ struct interface {
   /* index in TTL array for fish-eye */
   int ttl_index;
 
-  /* Hello's are sent immediately normally, this flag prefers to send TC's */
-  bool immediate_send_tc;
+  /* serialized LQ_HELLO and LQ_TC of this interface, see lq_packet.c */
+  struct lq_msg_cache *lq_hello_cache;
+  struct lq_msg_cache *lq_tc_cache;
 
   /* backpointer to olsr_if configuration */
   struct olsr_if *olsr_if;
@@ -217,6 +239,12 @@ int olsr_remove_ifchange_handler(void (*f) (int if_index, struct interface *, en
 
 void olsr_remove_interface(struct olsr_if *);
 
+void olsr_hello_churn(void);
+void olsr_tc_churn(void);
+void olsr_adapt_hello_interval(struct interface *);
+void olsr_adapt_tc_interval(struct interface *);
+void olsr_trigger_tc(void);
+
 extern struct olsr_cookie_info *interface_poll_timer_cookie;
 extern struct olsr_cookie_info *hello_gen_timer_cookie;
 extern struct olsr_cookie_info *tc_gen_timer_cookie;
@@ -200,7 +200,7 @@ frontend_msgparser(union olsr_message * msg, struct interface * in_if __attribut
   if (!ipc_active)
     return true;
 
-  if (olsr_cnf->ip_version == AF_INET)
+  if (OLSR_IP_VERSION == AF_INET)
     size = ntohs(msg->v4.olsr_msgsize);
   else
     size = ntohs(msg->v6.olsr_msgsize);
@@ -359,7 +359,7 @@ ipc_send_net_info(int fd)
   net_msg.neigh_hold = 0;      //htons((uint16_t)neighbor_hold_time);
   net_msg.topology_hold = 0;   //htons((uint16_t)topology_hold_time);
 
-  net_msg.ipv6 = olsr_cnf->ip_version == AF_INET ? 0 : 1;
+  net_msg.ipv6 = OLSR_IP_VERSION == AF_INET ? 0 : 1;
 
   /* Main addr */
   net_msg.main_addr = olsr_cnf->main_addr;
@@ -98,7 +98,7 @@ prefix_to_netmask(uint8_t * a, int len, uint8_t prefixlen)
   }
 
 #ifdef DEBUG
-  OLSR_PRINTF(3, "Prefix %d = Netmask: %s\n", prefixlen, inet_ntop(olsr_cnf->ip_version, a_start, buf.buf, sizeof(buf.buf)));
+  OLSR_PRINTF(3, "Prefix %d = Netmask: %s\n", prefixlen, inet_ntop(OLSR_IP_VERSION, a_start, buf.buf, sizeof(buf.buf)));
 #endif /* DEBUG */
   return 1;
 }
@@ -162,7 +162,7 @@ olsr_ip_prefix_to_string(const struct olsr_ip_prefix *prefix)
   static char buf[MAX(INET6_ADDRSTRLEN + 1 + 3, INET_ADDRSTRLEN + 1 + INET_ADDRSTRLEN)];
   const char *rv;
 
-  if (olsr_cnf->ip_version == AF_INET) {
+  if (OLSR_IP_VERSION == AF_INET) {
     /* IPv4 */
     int len;
     union olsr_ip_addr netmask;
@@ -197,7 +197,7 @@ olsr_string_to_prefix(int ipversion, struct olsr_ip_prefix *dst, const char *str
 
   if (ptr) {
     *ptr++ = 0;
-    if (olsr_cnf->ip_version == AF_INET && strchr(ptr, '.')) {
+    if (OLSR_IP_VERSION == AF_INET && strchr(ptr, '.')) {
       uint8_t subnetbuf[4];
       if (inet_pton(AF_INET, ptr, subnetbuf) != 1) {
         return -1;
@@ -229,7 +229,7 @@ int
 ip_in_net(const union olsr_ip_addr *ipaddr, const struct olsr_ip_prefix *net)
 {
   int rv;
-  if (olsr_cnf->ip_version == AF_INET) {
+  if (OLSR_IP_VERSION == AF_INET) {
     uint32_t netmask = htonl(prefix_to_netmask4(net->prefix_len));
     rv = (ipaddr->v4.s_addr & netmask) == (net->prefix.v4.s_addr & netmask);
   } else {
@@ -254,10 +254,10 @@ ip_in_net(const union olsr_ip_addr *ipaddr, const struct olsr_ip_prefix *net)
 }
 
 bool is_prefix_inetgw(const struct olsr_ip_prefix *prefix) {
-  if (olsr_cnf->ip_version == AF_INET && ip_prefix_is_v4_inetgw(prefix)) {
+  if (OLSR_IP_VERSION == AF_INET && ip_prefix_is_v4_inetgw(prefix)) {
     return true;
   }
-  if (olsr_cnf->ip_version == AF_INET6) {
+  if (OLSR_IP_VERSION == AF_INET6) {
     if (ip_prefix_is_v6_inetgw(prefix) || ip_prefix_is_mappedv4_inetgw(prefix)) {
       return true;
     }
@@ -89,7 +89,13 @@ ip6equal(const struct in6_addr *a, const struct in6_addr *b)
 static INLINE int
 ipequal(const union olsr_ip_addr *a, const union olsr_ip_addr *b)
 {
-  return olsr_cnf->ip_version == AF_INET ? ip4equal(&a->v4, &b->v4) : ip6equal(&a->v6, &b->v6);
+  return OLSR_IP_VERSION == AF_INET ? ip4equal(&a->v4, &b->v4) : ip6equal(&a->v6, &b->v6);
+}
+
+static INLINE int
+ipcmp(const union olsr_ip_addr *a, const union olsr_ip_addr *b)
+{
+  return OLSR_IP_VERSION == AF_INET ? ip4cmp(&a->v4, &b->v4) : ip6cmp(&a->v6, &b->v6);
 }
 
 /* Do not use this - this is as evil as the COPY_IP() macro was and only used in
@@ -98,7 +104,7 @@ ipequal(const union olsr_ip_addr *a, const union olsr_ip_addr *b)
 static INLINE void
 genipcopy(void *dst, const void *src)
 {
-  memcpy(dst, src, olsr_cnf->ipsize);
+  memcpy(dst, src, OLSR_IPSIZE);
 }
 
 int ip_in_net(const union olsr_ip_addr *ipaddr, const struct olsr_ip_prefix *net);
@@ -108,7 +114,7 @@ int prefix_to_netmask(uint8_t *, int, uint8_t);
 static INLINE int
 olsr_prefix_to_netmask(union olsr_ip_addr *adr, uint8_t prefixlen)
 {
-  return prefix_to_netmask(adr->v6.s6_addr, olsr_cnf->ipsize, prefixlen);
+  return prefix_to_netmask(adr->v6.s6_addr, OLSR_IPSIZE, prefixlen);
 }
 
 uint8_t netmask_to_prefix(const uint8_t *, int);
@@ -116,7 +122,7 @@ uint8_t netmask_to_prefix(const uint8_t *, int);
 static INLINE uint8_t
 olsr_netmask_to_prefix(const union olsr_ip_addr *adr)
 {
-  return netmask_to_prefix(adr->v6.s6_addr, olsr_cnf->ipsize);
+  return netmask_to_prefix(adr->v6.s6_addr, OLSR_IPSIZE);
 }
 
 static INLINE uint8_t
@@ -145,7 +151,7 @@ ip6_to_string(struct ipaddr_str *const buf, const struct in6_addr *const addr6)
 static INLINE const char *
 olsr_ip_to_string(struct ipaddr_str *const buf, const union olsr_ip_addr *addr)
 {
-  return inet_ntop(olsr_cnf->ip_version, addr, buf->buf, sizeof(buf->buf));
+  return inet_ntop(OLSR_IP_VERSION, addr, buf->buf, sizeof(buf->buf));
 }
 
 const char *
@@ -172,7 +178,7 @@ is_prefix_niit_ipv6(const struct olsr_ip_prefix *p) {
 #else
 	bool v4mapped = IN6_IS_ADDR_V4MAPPED(&p->prefix.v6);
 #endif
-  return olsr_cnf->ip_version == AF_INET6 && v4mapped
+  return OLSR_IP_VERSION == AF_INET6 && v4mapped
       && p->prefix_len >= ipv6_mappedv4_route.prefix_len;
 }
 
@@ -186,7 +192,7 @@ prefix_mappedv4_to_v4(struct olsr_ip_prefix *v4, const struct olsr_ip_prefix *v6
 
 static INLINE bool
 ip_is_linklocal(const union olsr_ip_addr *ip) {
-  return olsr_cnf->ip_version == AF_INET6
+  return OLSR_IP_VERSION == AF_INET6
       && ip->v6.s6_addr[0] == 0xfe && (ip->v6.s6_addr[1] & 0xc0) == 0x80;
 }
 
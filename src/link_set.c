@@ -49,6 +49,7 @@
 #include "hysteresis.h"
 #include "mid_set.h"
 #include "mpr.h"
+#include "lq_mpr.h"
 #include "neighbor_table.h"
 #include "olsr.h"
 #include "log.h"
@@ -57,16 +58,26 @@
 #include "net_olsr.h"
 #include "ipcalc.h"
 #include "lq_plugin.h"
+#include "olsr_cookie.h"
 
 /* head node for all link sets */
 struct list_node link_entry_head;
 
 bool link_changes;                     /* is set if changes occur in MPRS set */
 
+struct olsr_cookie_info *link_mem_cookie = NULL;
+
+static struct timer_entry *link_fail_spf_timer;
+
 void
 signal_link_changes(bool val)
 {                               /* XXX ugly */
   link_changes = val;
+
+  /* the advertised neighbor set changed */
+  if (val) {
+    olsr_tc_churn();
+  }
 }
 
 /* Prototypes. */
@@ -82,6 +93,9 @@ olsr_init_link_set(void)
 
   /* Init list head */
   list_head_init(&link_entry_head);
+
+  link_mem_cookie = olsr_alloc_cookie("link_entry", OLSR_COOKIE_TYPE_MEMORY);
+  olsr_cookie_set_memory_size(link_mem_cookie, sizeof(struct link_entry) + active_lq_handler->hello_lq_size);
 }
 
 /**
@@ -100,6 +114,7 @@ void olsr_reset_all_links(void) {
 
     link->neighbor->is_mpr = false;
     link->neighbor->status = NOT_SYM;
+    olsr_lq_mpr_touch_neighbor(link->neighbor);
   } OLSR_FOR_ALL_LINK_ENTRIES_END(link)
 
 
@@ -386,12 +401,15 @@ olsr_delete_link_entry(struct link_entry *link)
   link->link_hello_timer = NULL;
   olsr_stop_timer(link->link_loss_timer);
   link->link_loss_timer = NULL;
+  olsr_stop_timer(link->link_fail_timer);
+  link->link_fail_timer = NULL;
   list_remove(&link->link_list);
 
   free(link->if_name);
-  free(link);
+  olsr_cookie_free(link_mem_cookie, link);
 
   changes_neighborhood = true;
+  olsr_hello_churn();
 }
 
 /**
@@ -451,6 +469,7 @@ olsr_expire_link_sym_timer(void *context)
   link->prev_status = lookup_link_status(link);
   update_neighbor_status(link->neighbor, get_neighbor_status(&link->neighbor_iface_addr));
   changes_neighborhood = true;
+  olsr_hello_churn();
 }
 
 /**
@@ -481,6 +500,95 @@ olsr_expire_link_hello_timer(void *context)
   link->olsr_seqno++;
 }
 
+/**
+ * Callback for the timer started by a link failure,
+ * withdraws the routes without waiting for the SPF backoff.
+ */
+static void
+olsr_expire_link_fail_spf_timer(void *context __attribute__ ((unused)))
+{
+  link_fail_spf_timer = NULL;
+
+  olsr_calculate_routing_table(true);
+}
+
+/**
+ * Callback for the link failure timer. The kernel still
+ * reports the link as down, so it is lost now.
+ */
+static void
+olsr_expire_link_fail_timer(void *context)
+{
+  struct ipaddr_str buf;
+  struct link_entry *link;
+
+  link = (struct link_entry *)context;
+  link->link_fail_timer = NULL;
+
+  OLSR_PRINTF(1, "Link to %s on %s is down\n", olsr_ip_to_string(&buf, &link->neighbor_iface_addr), link->inter->int_name);
+
+  /* neither symmetric nor asymmetric any more */
+  olsr_stop_timer(link->link_sym_timer);
+  link->link_sym_timer = NULL;
+  link->ASYM_time = now_times - 1;
+
+  /* nothing gets through */
+  olsr_clear_hello_lq(link);
+  link->linkcost = LINK_COST_BROKEN;
+
+  link->prev_status = lookup_link_status(link);
+  update_neighbor_status(link->neighbor, get_neighbor_status(&link->neighbor_iface_addr));
+
+  changes_neighborhood = true;
+  changes_topology = true;
+  olsr_hello_churn();
+  signal_link_changes(true);
+
+  /* on the next tick, once for all links which failed together */
+  if (link_fail_spf_timer == NULL) {
+    link_fail_spf_timer = olsr_start_timer(1, 0, OLSR_TIMER_ONESHOT, &olsr_expire_link_fail_spf_timer, NULL, 0);
+  }
+}
+
+/**
+ * The kernel reports the carrier of an interface (remote is NULL)
+ * or the reachability of a neighbor interface as changed. The links
+ * affected are declared lost after LinkFailureDelay, unless they
+ * come back or a HELLO is received before.
+ *
+ * @param ifp the local interface
+ * @param remote the neighbor interface address or NULL for all
+ * @param failed true if the link is down
+ */
+void
+olsr_link_failure(const struct interface *ifp, const union olsr_ip_addr *remote, bool failed)
+{
+  const unsigned int delay = (unsigned int)(olsr_cnf->link_fail_delay * MSEC_PER_SEC);
+  struct link_entry *link;
+
+  if (!olsr_cnf->link_fail_detection) {
+    return;
+  }
+
+  OLSR_FOR_ALL_LINK_ENTRIES(link) {
+    if (link->inter != ifp || (remote != NULL && !ipequal(remote, &link->neighbor_iface_addr))) {
+      continue;
+    }
+
+    if (!failed) {
+      olsr_stop_timer(link->link_fail_timer);
+      link->link_fail_timer = NULL;
+    } else if (link->link_fail_timer == NULL && lookup_link_status(link) != LOST_LINK) {
+      if (delay == 0) {
+        olsr_expire_link_fail_timer(link);
+      } else {
+        olsr_set_timer(&link->link_fail_timer, delay, 0, OLSR_TIMER_ONESHOT, &olsr_expire_link_fail_timer, link, 0);
+      }
+    }
+  }
+  OLSR_FOR_ALL_LINK_ENTRIES_END(link);
+}
+
 /**
  * Callback for the link timer.
  */
@@ -599,6 +707,7 @@ add_link_entry(const union olsr_ip_addr *local, const union olsr_ip_addr *remote
 
   /* Add to queue */
   list_add_before(&link_entry_head, &new_link->link_list);
+  olsr_hello_churn();
 
   /*
    * Create the neighbor entry
@@ -690,15 +799,24 @@ update_link_entry(const union olsr_ip_addr *local, const union olsr_ip_addr *rem
                   const struct interface *in_if)
 {
   struct link_entry *entry;
+  int status;
 
   /* Add if not registered */
   entry = add_link_entry(local, remote, &message->source_addr, message->vtime, message->htime, in_if);
 
+  /* the link is alive, whatever the kernel said */
+  olsr_stop_timer(entry->link_fail_timer);
+  entry->link_fail_timer = NULL;
+
   /* Update ASYM_time */
   entry->vtime = message->vtime;
   entry->ASYM_time = GET_TIMESTAMP(message->vtime);
 
-  entry->prev_status = check_link_status(message, in_if);
+  status = check_link_status(message, in_if);
+  if (status != entry->prev_status) {
+    olsr_hello_churn();
+  }
+  entry->prev_status = status;
 
   switch (entry->prev_status) {
   case (LOST_LINK):
@@ -806,7 +924,7 @@ olsr_print_link_set(void)
 {
   /* The whole function makes no sense without it. */
   struct link_entry *walker;
-  const int addrsize = olsr_cnf->ip_version == AF_INET ? (INET_ADDRSTRLEN - 1) : (INET6_ADDRSTRLEN - 1);
+  const int addrsize = OLSR_IP_VERSION == AF_INET ? (INET_ADDRSTRLEN - 1) : (INET6_ADDRSTRLEN - 1);
 
   OLSR_PRINTF(0, "\n--- %s ---------------------------------------------------- LINKS\n\n", olsr_wallclock_string());
   OLSR_PRINTF(1, "%-*s  %-6s %-14s %s\n", addrsize, "IP address", "hyst", "      LQ      ", "ETX");
@@ -50,6 +50,7 @@
 #include "packet.h"
 #include "common/list.h"
 #include "mantissa.h"
+#include "olsr_cookie.h"
 
 #define MID_ALIAS_HACK_VTIME  10.0
 
@@ -84,6 +85,9 @@ struct link_entry {
   olsr_reltime loss_helloint;
   struct timer_entry *link_loss_timer;
 
+  /* the kernel reported the link as down */
+  struct timer_entry *link_fail_timer;
+
   /* user defined multiplies for link quality, multiplied with 65536 */
   uint32_t loss_link_multiplier;
 
@@ -116,6 +120,7 @@ LISTNODE2STRUCT(list2link, struct link_entry, link_list);
 /* Externals */
 extern struct list_node link_entry_head;
 extern bool link_changes;
+extern struct olsr_cookie_info *link_mem_cookie;
 
 /* Function prototypes */
 
@@ -124,6 +129,7 @@ void olsr_init_link_set(void);
 void olsr_reset_all_links(void);
 void olsr_delete_link_entry_by_ip(const union olsr_ip_addr *);
 void olsr_expire_link_hello_timer(void *);
+void olsr_link_failure(const struct interface *, const union olsr_ip_addr *, bool);
 void signal_link_changes(bool);        /* XXX ugly */
 
 struct link_entry *get_best_link_to_neighbor(const union olsr_ip_addr *);
@@ -46,10 +46,12 @@
 #include "log.h"
 #include "net_os.h"
 #include "ifnet.h"
+#include "link_set.h"
 
 #include <assert.h>
 #include <linux/types.h>
 #include <linux/rtnetlink.h>
+#include <linux/neighbour.h>
 
 //ipip includes
 #include <netinet/in.h>
@@ -111,6 +113,58 @@ int rtnetlink_register_socket(int rtnl_mgrp)
   return sock;
 }
 
+/*
+ * carrier lost or back, concerns all links of the interface. Other
+ * RTM_NEWLINK events must not stop the timers of failed neighbors.
+ */
+static void netlink_update_carrier(struct interface *iface, int flags)
+{
+  if ((iface->int_flags & IFF_RUNNING) != (flags & IFF_RUNNING)) {
+    iface->int_flags = (iface->int_flags & ~IFF_RUNNING) | (flags & IFF_RUNNING);
+    olsr_link_failure(iface, NULL, (flags & IFF_RUNNING) == 0);
+  }
+}
+
+/*
+ * check an OLSR interface again. Without carrier a configured interface
+ * is kept if link failure detection is on, its timers take care of the
+ * links. Otherwise chk_if_changed() removes it, like the poll did.
+ */
+static void netlink_check_interface(struct olsr_if *oif)
+{
+  if (!oif->cnf->autodetect_chg || oif->host_emul || olsr_cnf->host_emul) {
+    return;
+  }
+
+  if (!oif->configured) {
+    chk_if_up(oif, 3);
+  }
+  else if (!olsr_cnf->link_fail_detection || oif->interf == NULL || (oif->interf->int_flags & IFF_RUNNING) != 0) {
+    chk_if_changed(oif);
+  }
+}
+
+/*
+ * events were lost, read the carrier state of the configured interfaces
+ * and check all of them once
+ */
+static void netlink_resync_interfaces(void)
+{
+  struct olsr_if *oif;
+  struct ifreq ifr;
+
+  for (oif = olsr_cnf->interfaces; oif != NULL; oif = oif->next) {
+    if (oif->configured && oif->interf != NULL) {
+      memset(&ifr, 0, sizeof(ifr));
+      strscpy(ifr.ifr_name, oif->name, sizeof(ifr.ifr_name));
+      if (ioctl(olsr_cnf->ioctl_s, SIOCGIFFLAGS, &ifr) == 0 && (ifr.ifr_flags & IFF_UP) != 0) {
+        netlink_update_carrier(oif->interf, ifr.ifr_flags);
+      }
+    }
+    netlink_check_interface(oif);
+  }
+}
+
 static void netlink_process_link(struct nlmsghdr *h)
 {
   struct ifinfomsg *ifi = (struct ifinfomsg *) NLMSG_DATA(h);
@@ -133,6 +187,13 @@ static void netlink_process_link(struct nlmsghdr *h)
     /* try to take interface down, will trigger ifchange */
     olsr_remove_interface(iface->olsr_if);
   }
+  else if (iface != NULL) {
+    netlink_update_carrier(iface, ifi->ifi_flags);
+
+    /* flags or MTU might have changed */
+    oif = iface->olsr_if;
+    netlink_check_interface(oif);
+  }
 
   if (iface == NULL && oif == NULL) {
     /* this is not an OLSR interface */
@@ -145,6 +206,57 @@ static void netlink_process_link(struct nlmsghdr *h)
   }
 }
 
+static void netlink_process_addr(struct nlmsghdr *h)
+{
+  struct ifaddrmsg *ifa = (struct ifaddrmsg *) NLMSG_DATA(h);
+  struct interface *iface;
+  struct olsr_if *oif;
+  char namebuffer[IF_NAMESIZE];
+
+  if (ifa->ifa_family != olsr_cnf->ip_version) {
+    return;
+  }
+
+  if ((iface = if_ifwithindex(ifa->ifa_index)) != NULL) {
+    oif = iface->olsr_if;
+  }
+  else if (if_indextoname(ifa->ifa_index, namebuffer) == NULL || (oif = olsrif_ifwithname(namebuffer)) == NULL) {
+    /* this is not an OLSR interface */
+    return;
+  }
+
+  /* address added or removed, check the interface again */
+  netlink_check_interface(oif);
+}
+
+static void netlink_process_neigh(struct nlmsghdr *h)
+{
+  struct ndmsg *ndm = (struct ndmsg *) NLMSG_DATA(h);
+  struct rtattr *rta;
+  struct interface *iface;
+  union olsr_ip_addr addr;
+  int len;
+
+  if (ndm->ndm_family != olsr_cnf->ip_version || (iface = if_ifwithindex(ndm->ndm_ifindex)) == NULL) {
+    return;
+  }
+
+  /* only resolution failures and confirmed neighbors are of interest */
+  if ((ndm->ndm_state & (NUD_FAILED | NUD_REACHABLE)) == 0) {
+    return;
+  }
+
+  len = h->nlmsg_len - NLMSG_LENGTH(sizeof(*ndm));
+  for (rta = (struct rtattr *)ARM_NOWARN_ALIGN(((char *)ndm) + NLMSG_ALIGN(sizeof(*ndm))); RTA_OK(rta, len); rta = RTA_NEXT(rta, len)) {
+    if (rta->rta_type == NDA_DST && RTA_PAYLOAD(rta) == olsr_cnf->ipsize) {
+      memset(&addr, 0, sizeof(addr));
+      memcpy(&addr, RTA_DATA(rta), olsr_cnf->ipsize);
+      olsr_link_failure(iface, &addr, (ndm->ndm_state & NUD_FAILED) != 0);
+      return;
+    }
+  }
+}
+
 static void rtnetlink_read(int sock, void *data __attribute__ ((unused)), unsigned int flags __attribute__ ((unused)))
 {
   int len, plen;
@@ -183,9 +295,20 @@ static void rtnetlink_read(int sock, void *data __attribute__ ((unused)), unsign
       /* handle ifup/ifdown */
       netlink_process_link(nlh);
     }
+    else if ((nlh->nlmsg_type == RTM_NEWADDR) || (nlh->nlmsg_type == RTM_DELADDR)) {
+      /* interface address changed */
+      netlink_process_addr(nlh);
+    }
+    else if (nlh->nlmsg_type == RTM_NEWNEIGH) {
+      /* neighbor resolution failed or succeeded */
+      netlink_process_neigh(nlh);
+    }
   }
 
-  if (errno != EAGAIN) {
+  if (errno == ENOBUFS) {
+    netlink_resync_interfaces();
+  }
+  else if (errno != EAGAIN) {
     OLSR_PRINTF(1,"netlink listen error %u - %s\n",errno,strerror(errno));
   }
 }
@@ -87,7 +87,7 @@ static const char *lq_print_ffeth_nl80211(void *ptr, char separator, struct lqte
 static const char *lq_print_cost_ffeth_nl80211(olsr_linkcost cost, struct lqtextbuffer *buffer);
 
 /* etx lq plugin (freifunk fpm version) settings */
-struct lq_handler lq_etx_ffeth_nl80211_handler = {
+LQ_HANDLER_CONST struct lq_handler lq_etx_ffeth_nl80211_handler = {
   &lq_initialize_ffeth_nl80211,
   &lq_calc_cost_ffeth_nl80211,
   &lq_calc_cost_ffeth_nl80211,
@@ -183,6 +183,26 @@ lq_ffeth_nl80211_handle_lqchange(void) {
   olsr_relevant_linkcost_change();
 }
 
+/* add a window slot to the running sums */
+static void
+lq_ffeth_nl80211_sum_slot(struct lq_ffeth_hello *lq, int slot)
+{
+  if (slot < lq->windowSize) {
+    lq->received_sum += lq->received[slot];
+    lq->total_sum += lq->total[slot];
+  }
+}
+
+/* remove a window slot from the running sums */
+static void
+lq_ffeth_nl80211_unsum_slot(struct lq_ffeth_hello *lq, int slot)
+{
+  if (slot < lq->windowSize) {
+    lq->received_sum -= lq->received[slot];
+    lq->total_sum -= lq->total[slot];
+  }
+}
+
 static void
 lq_parser_ffeth_nl80211(struct olsr *olsr, struct interface *in_if, union olsr_ip_addr *from_addr)
 {
@@ -221,8 +241,10 @@ lq_parser_ffeth_nl80211(struct olsr *olsr, struct interface *in_if, union olsr_i
     seq_diff = 1;
   }
 
+  lq_ffeth_nl80211_unsum_slot(lq, lq->activePtr);
   lq->received[lq->activePtr]++;
   lq->total[lq->activePtr] += seq_diff;
+  lq_ffeth_nl80211_sum_slot(lq, lq->activePtr);
 
   lq->last_seq_nr = olsr->olsr_seqno;
   lq->missed_hellos = 0;
@@ -240,19 +262,15 @@ lq_ffeth_nl80211_timer(void __attribute__ ((unused)) * context)
   OLSR_FOR_ALL_LINK_ENTRIES(link) {
     struct lq_ffeth_hello *tlq = (struct lq_ffeth_hello *)link->linkquality;
     fpm ratio;
-    int i, received, total;
-
-    received = 0;
-    total = 0;
+    int received, total;
 
     /* enlarge window if still in quickstart phase */
     if (tlq->windowSize < LQ_FFETH_WINDOW) {
       tlq->windowSize++;
+      lq_ffeth_nl80211_sum_slot(tlq, tlq->windowSize - 1);
     }
-    for (i = 0; i < tlq->windowSize; i++) {
-      received += tlq->received[i];
-      total += tlq->total[i];
-    }
+    received = tlq->received_sum;
+    total = tlq->total_sum;
 
     /* calculate link quality */
     if (total == 0) {
@@ -263,7 +281,10 @@ lq_ffeth_nl80211_timer(void __attribute__ ((unused)) * context)
 
       /* keep missed hello periods in mind (round up hello interval to seconds) */
       if (tlq->missed_hellos > 1) {
-        received = received - received * tlq->missed_hellos * link->inter->hello_etime/1000 / LQ_FFETH_WINDOW;
+        /* stretched HELLO intervals can miss more than the whole window */
+        const uint64_t missed = (uint64_t)tlq->missed_hellos * link->loss_helloint / 1000;
+
+        received = missed >= LQ_FFETH_WINDOW ? 0 : received - received * (int)missed / LQ_FFETH_WINDOW;
       }
 
       // calculate received/total factor
@@ -293,6 +314,7 @@ lq_ffeth_nl80211_timer(void __attribute__ ((unused)) * context)
 
     // shift buffer
     tlq->activePtr = (tlq->activePtr + 1) % LQ_FFETH_WINDOW;
+    lq_ffeth_nl80211_unsum_slot(tlq, tlq->activePtr);
     tlq->total[tlq->activePtr] = 0;
     tlq->received[tlq->activePtr] = 0;
 
@@ -487,6 +509,14 @@ lq_clear_ffeth_nl80211_hello(void *target)
   for (i = 0; i < LQ_FFETH_WINDOW; i++) {
     local->total[i] = 3;
   }
+  local->received_sum = 0;
+  local->total_sum = 0;
+  for (i = 0; i < local->windowSize; i++) {
+    lq_ffeth_nl80211_sum_slot(local, i);
+  }
+#ifdef LINUX_NL80211
+  local->mac_valid = false;
+#endif
 }
 
 static const char *
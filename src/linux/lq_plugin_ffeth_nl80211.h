@@ -74,11 +74,16 @@ struct lq_ffeth_hello {
   uint8_t windowSize, activePtr;
   uint16_t last_seq_nr;
   uint16_t missed_hellos;
+  uint32_t received_sum, total_sum;   /* sums over the first windowSize slots */
   bool perfect_eth;
   uint16_t received[LQ_FFETH_WINDOW], total[LQ_FFETH_WINDOW];
+#ifdef LINUX_NL80211
+  bool mac_valid;                     /* mac is the neighbor's address, see nl80211_link_info.c */
+  unsigned char mac[ETHER_ADDR_LEN];
+#endif
 };
 
-extern struct lq_handler lq_etx_ffeth_nl80211_handler;
+extern LQ_HANDLER_CONST struct lq_handler lq_etx_ffeth_nl80211_handler;
 
 #endif /* LQ_ETX_FFETH_NL80211_ */
 
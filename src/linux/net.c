@@ -50,9 +50,11 @@
 #include "../ipcalc.h"
 #include "../olsr.h"
 #include "../log.h"
+#include "../net_olsr.h"
 #include "kernel_tunnel.h"
 
 #include <net/if.h>
+#include <linux/filter.h>
 
 #include <sys/ioctl.h>
 #include <sys/utsname.h>
@@ -102,6 +104,12 @@
 #define SIOCGIWNAME	0x8B01  /* get name == wireless protocol */
 #define SIOCGIWRATE	0x8B21  /* get default bit rate (bps) */
 
+/*
+ * Source addresses dropped by the socket filter. Packets from
+ * addresses beyond this are still dropped by olsr_input().
+ */
+#define SOCKET_FILTER_MAX_ADDRS 256
+
 /* The original state of the IP forwarding proc entry */
 static char orig_fwd_state;
 static char orig_global_redirect_state;
@@ -211,6 +219,103 @@ kernel_parse_error:
   return false;
 }
 
+/**
+ * Build a BPF program which drops all packets with one of the
+ * given source addresses. The filter of a UDP socket sees the
+ * packet from the UDP header on, so the IP header is loaded
+ * relative to SKF_NET_OFF.
+ *
+ * @param addrs the source addresses to drop
+ * @param count number of addresses
+ * @param len returns the number of instructions
+ * @return the program, to be freed by the caller
+ */
+static struct sock_filter *
+build_socket_filter(const union olsr_ip_addr *addrs, unsigned int count, unsigned short *len)
+{
+  struct sock_filter *filter, *insn;
+  unsigned int i, w;
+
+  if (olsr_cnf->ip_version == AF_INET) {
+    filter = olsr_malloc((2 * count + 2) * sizeof(*filter), "Socket filter");
+    insn = filter;
+
+    /* ld [ip->saddr] */
+    *insn++ = (struct sock_filter)BPF_STMT(BPF_LD | BPF_W | BPF_ABS, SKF_NET_OFF + 12);
+    for (i = 0; i < count; i++) {
+      *insn++ = (struct sock_filter)BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, ntohl(addrs[i].v4.s_addr), 0, 1);
+      *insn++ = (struct sock_filter)BPF_STMT(BPF_RET | BPF_K, 0);
+    }
+  } else {
+    filter = olsr_malloc((9 * count + 1) * sizeof(*filter), "Socket filter");
+    insn = filter;
+
+    /* compare ip6->saddr word by word, skip to the next address on the first mismatch */
+    for (i = 0; i < count; i++) {
+      for (w = 0; w < 4; w++) {
+        uint32_t word;
+
+        memcpy(&word, &addrs[i].v6.s6_addr[4 * w], sizeof(word));
+        *insn++ = (struct sock_filter)BPF_STMT(BPF_LD | BPF_W | BPF_ABS, SKF_NET_OFF + 8 + 4 * w);
+        *insn++ = (struct sock_filter)BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, ntohl(word), 0, 7 - 2 * w);
+      }
+      *insn++ = (struct sock_filter)BPF_STMT(BPF_RET | BPF_K, 0);
+    }
+  }
+
+  /* accept the whole packet */
+  *insn++ = (struct sock_filter)BPF_STMT(BPF_RET | BPF_K, 0xffffffff);
+
+  *len = insn - filter;
+  return filter;
+}
+
+/**
+ * Interface change handler. Regenerates the socket filter of all
+ * OLSR interfaces, so our own packets and the packets from invalid
+ * addresses are dropped by the kernel instead of olsr_input().
+ */
+static void
+update_socket_filters(int if_index __attribute__ ((unused)), struct interface *changed, enum olsr_ifchg_flag flag)
+{
+  union olsr_ip_addr addrs[SOCKET_FILTER_MAX_ADDRS];
+  struct sock_fprog prog;
+  struct interface *ifp;
+  unsigned int count = 0;
+
+  if (changed == NULL) {
+    /* not an OLSR interface */
+    return;
+  }
+
+  for (ifp = ifnet; ifp != NULL && count < SOCKET_FILTER_MAX_ADDRS; ifp = ifp->int_next) {
+    if (flag == IFCHG_IF_REMOVE && ifp == changed) {
+      continue;
+    }
+    memset(&addrs[count], 0, sizeof(addrs[count]));
+    if (olsr_cnf->ip_version == AF_INET) {
+      addrs[count++].v4 = ifp->int_addr.sin_addr;
+    } else {
+      addrs[count++].v6 = ifp->int6_addr.sin6_addr;
+    }
+  }
+  count += olsr_get_invalid_addresses(&addrs[count], SOCKET_FILTER_MAX_ADDRS - count);
+
+  prog.filter = build_socket_filter(addrs, count, &prog.len);
+
+  for (ifp = ifnet; ifp != NULL; ifp = ifp->int_next) {
+    if ((flag == IFCHG_IF_REMOVE && ifp == changed) || ifp->olsr_if->host_emul) {
+      continue;
+    }
+    if (setsockopt(ifp->olsr_socket, SOL_SOCKET, SO_ATTACH_FILTER, &prog, sizeof(prog)) < 0
+        || setsockopt(ifp->send_socket, SOL_SOCKET, SO_ATTACH_FILTER, &prog, sizeof(prog)) < 0) {
+      OLSR_PRINTF(1, "Cannot attach socket filter on %s: %s\n", ifp->int_name, strerror(errno));
+    }
+  }
+
+  free(prog.filter);
+}
+
 /**
  * Setup global interface options (icmp redirect, ip forwarding, rp_filter)
  * @return 1 on success 0 on failure
@@ -243,6 +348,11 @@ net_os_set_global_ifoptions(void) {
     }
   }
 
+  /* keep the socket filters up to date */
+  if (!olsr_cnf->host_emul) {
+    olsr_add_ifchange_handler(&update_socket_filters);
+  }
+
   if (olsr_cnf->ip_version == AF_INET) {
     if (writeToProc(PROC_ALL_REDIRECT, &orig_global_redirect_state, OLSRD_REDIRECT_VALUE)) {
       OLSR_PRINTF(1, "WARNING! Could not disable ICMP redirects!\n"
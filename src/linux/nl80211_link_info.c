@@ -87,14 +87,18 @@ static inline void nl_socket_free(struct nl_sock *sock)
 		} \
 	} while (0)
 
-struct nl80211_link_info_context {
-	int *finish;
-	struct lq_nl80211_data **nl80211;
-};
+#define STATION_HASH_SIZE 64 // Power of two
 
 static int netlink_id = 0;
 static struct nl_sock *gen_netlink_socket = NULL; // Socket for NL80211
 static struct nl_sock *rt_netlink_socket = NULL; // Socket for ARP cache
+static struct nl_cb *station_cb = NULL; // Callbacks of the station dumps
+
+static struct lq_nl80211_data *station_hash[STATION_HASH_SIZE]; // Stations by MAC address
+static uint32_t dump_round = 0; // Current round of station dumps over all interfaces
+static int dump_ifindex = 0; // Interface with a dump in progress, 0 if none
+static int dump_finished = 0; // Set by the callbacks when the dump of dump_ifindex ended
+static int dump_stalled = 0; // Rounds requested while the current one was still running
 
 
 /**
@@ -114,6 +118,11 @@ static void connect_netlink(void) {
 		olsr_exit("Failed to resolve netlink nl80211 module", EXIT_FAILURE);
 	}
 
+	// The station dumps are read by the scheduler, never wait for them
+	if (nl_socket_set_nonblocking(gen_netlink_socket) != 0) {
+		olsr_exit("Failed to make the nl80211 socket non-blocking", EXIT_FAILURE);
+	}
+
 	if ((rt_netlink_socket = nl_socket_alloc()) == NULL) {
 		olsr_exit("Failed allocating memory for netlink socket", EXIT_FAILURE);
 	}
@@ -123,15 +132,80 @@ static void connect_netlink(void) {
 	}
 }
 
-static int parse_nl80211_message(struct nl_msg *msg, void *arg) {
-	struct nl80211_link_info_context *context = (struct nl80211_link_info_context *) arg;
+static unsigned int station_hash_index(const unsigned char *mac) {
+	// The vendor part of the address is shared by many stations
+	return (mac[3] ^ mac[4] ^ mac[5]) & (STATION_HASH_SIZE - 1);
+}
+
+/**
+ * Find the station with the given MAC address in the hash.
+ *
+ * @param mac		MAC address to look for, MUST be ETHER_ADDR_LEN long.
+ *
+ * @returns			Pointer to object or NULL if not found.
+ */
+static struct lq_nl80211_data *find_lq_nl80211_data_by_mac(const unsigned char *mac) {
+	struct lq_nl80211_data *lq_data;
+
+	ASSERT_NOT_NULL(mac);
+
+	for (lq_data = station_hash[station_hash_index(mac)]; lq_data; lq_data = lq_data->next) {
+		if (memcmp(mac, lq_data->mac, ETHER_ADDR_LEN) == 0) {
+			return lq_data;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * Store the data of a station in the hash.
+ */
+static void update_station(const unsigned char *mac, int8_t signal, uint16_t bandwidth) {
+	struct lq_nl80211_data *lq_data;
+	unsigned int idx;
+
+	if ((lq_data = find_lq_nl80211_data_by_mac(mac)) == NULL) {
+		idx = station_hash_index(mac);
+
+		lq_data = olsr_malloc(sizeof(struct lq_nl80211_data), "new lq_nl80211_data struct");
+		memcpy(lq_data->mac, mac, ETHER_ADDR_LEN);
+		lq_data->next = station_hash[idx];
+		station_hash[idx] = lq_data;
+	}
+
+	lq_data->signal = signal;
+	lq_data->bandwidth = bandwidth;
+	lq_data->round = dump_round;
+}
+
+/**
+ * Remove the stations which were not part of the last round of dumps.
+ */
+static void expire_stations(void) {
+	struct lq_nl80211_data **lq_ptr, *lq_data;
+	unsigned int idx;
+
+	for (idx = 0; idx < STATION_HASH_SIZE; idx++) {
+		lq_ptr = &station_hash[idx];
+		while ((lq_data = *lq_ptr) != NULL) {
+			if (lq_data->round != dump_round) {
+				*lq_ptr = lq_data->next;
+				free(lq_data);
+			} else {
+				lq_ptr = &lq_data->next;
+			}
+		}
+	}
+}
+
+static int parse_nl80211_message(struct nl_msg *msg, void __attribute__ ((unused)) *arg) {
 	struct genlmsghdr *header = nlmsg_data(nlmsg_hdr(msg));
 	struct nlattr *attributes[NL80211_ATTR_MAX + 1];
 	struct nlattr *station_info[NL80211_STA_INFO_MAX + 1];
 	struct nlattr *rate_info[NL80211_RATE_INFO_MAX + 1];
-	struct lq_nl80211_data *lq_data = NULL;
-	uint8_t signal;
-	uint16_t bandwidth;
+	uint8_t signal = 0;
+	uint16_t bandwidth = 0;
 
 	static struct nla_policy station_attr_policy[NL80211_STA_INFO_MAX + 1] = {
 		[NL80211_STA_INFO_INACTIVE_TIME] = { .type = NLA_U32 }, // Last activity from remote station (msec)
@@ -143,10 +217,9 @@ static int parse_nl80211_message(struct nl_msg *msg, void *arg) {
 	};
 
 	ASSERT_NOT_NULL(msg);
-	ASSERT_NOT_NULL(context);
 
 	if (nla_parse(attributes, NL80211_ATTR_MAX, genlmsg_attrdata(header, 0), genlmsg_attrlen(header, 0), NULL) != 0) {
-		*(context->finish) = 1;
+		dump_finished = 1;
 		return NL_STOP;
 	}
 
@@ -157,95 +230,90 @@ static int parse_nl80211_message(struct nl_msg *msg, void *arg) {
 
 	if (nla_parse_nested(station_info, NL80211_STA_INFO_MAX, attributes[NL80211_ATTR_STA_INFO],
 				station_attr_policy) < 0) {
-		*(context->finish) = 1;
-		return NL_STOP;
-	}
-	if (nla_parse_nested(rate_info, NL80211_RATE_INFO_MAX, station_info[NL80211_STA_INFO_TX_BITRATE],
-				station_rate_policy) < 0) {
-		*(context->finish) = 1;
+		dump_finished = 1;
 		return NL_STOP;
 	}
 
-	if (nla_len(attributes[NL80211_ATTR_MAC]) != ETHER_ADDR_LEN) {
+	if (!attributes[NL80211_ATTR_MAC] || nla_len(attributes[NL80211_ATTR_MAC]) != ETHER_ADDR_LEN) {
 		olsr_syslog(OLSR_LOG_ERR, "Attribute NL80211_ATTR_MAC length is not equal to ETHER_ADDR_LEN");
-		*(context->finish) = 1;
+		dump_finished = 1;
 		return NL_STOP;
 	}
 
 	if (station_info[NL80211_STA_INFO_SIGNAL]) {
 		signal = nla_get_u8(station_info[NL80211_STA_INFO_SIGNAL]);
 	}
-	if (rate_info[NL80211_RATE_INFO_BITRATE]) {
-		bandwidth = nla_get_u16(rate_info[NL80211_RATE_INFO_BITRATE]);
+	if (station_info[NL80211_STA_INFO_TX_BITRATE]) {
+		if (nla_parse_nested(rate_info, NL80211_RATE_INFO_MAX, station_info[NL80211_STA_INFO_TX_BITRATE],
+					station_rate_policy) < 0) {
+			dump_finished = 1;
+			return NL_STOP;
+		}
+		if (rate_info[NL80211_RATE_INFO_BITRATE]) {
+			bandwidth = nla_get_u16(rate_info[NL80211_RATE_INFO_BITRATE]);
+		}
 	}
 
 	if (bandwidth != 0 || signal != 0) {
-		lq_data = olsr_malloc(sizeof(struct lq_nl80211_data), "new lq_nl80211_data struct");
-		memcpy(lq_data->mac, nla_data(attributes[NL80211_ATTR_MAC]), ETHER_ADDR_LEN);
-		lq_data->signal = signal;
-		lq_data->bandwidth = bandwidth;
-		lq_data->next = NULL;
-
-		if (context->nl80211 == NULL) { // Linked list does not exist yet
-			*(context->nl80211) = lq_data;
-		} else { // Append to head of linked list
-			lq_data->next = *(context->nl80211);
-			*(context->nl80211) = lq_data;
-		}
+		update_station(nla_data(attributes[NL80211_ATTR_MAC]), signal, bandwidth);
 	}
 
 	return NL_SKIP;
 }
 
-static int error_handler(struct sockaddr_nl __attribute__ ((unused)) *nla, struct nlmsgerr __attribute__ ((unused)) *err, void *arg) {
-	int *finish = arg;
-
-	ASSERT_NOT_NULL(arg);
-
-	*finish = 1;
+static int error_handler(struct sockaddr_nl __attribute__ ((unused)) *nla, struct nlmsgerr __attribute__ ((unused)) *err,
+		void __attribute__ ((unused)) *arg) {
+	dump_finished = 1;
 	return NL_STOP;
 }
 
-static int finish_handler(struct nl_msg __attribute__ ((unused)) *msg, void *arg) {
-	int *finish = arg;
-
-	ASSERT_NOT_NULL(arg);
+static int finish_handler(struct nl_msg __attribute__ ((unused)) *msg, void __attribute__ ((unused)) *arg) {
+	dump_finished = 1;
+	return NL_STOP;
+}
 
-	*finish = 1;
-	return NL_SKIP;
+static int ack_handler(struct nl_msg __attribute__ ((unused)) *nla, void __attribute__ ((unused)) *arg) {
+	dump_finished = 1;
+	return NL_STOP;
 }
 
-static int ack_handler(struct nl_msg __attribute__ ((unused)) *nla, void *arg) {
-	int *finish = arg;
+/**
+ * Finds the next wireless interface after the given one.
+ *
+ * @param if_index	Interface to start after, 0 to start with the first one.
+ *
+ * @returns			The interface or NULL if there is none (anymore).
+ */
+static struct interface *next_wireless_interface(int if_index) {
+	struct interface *iface = ifnet;
 
-	ASSERT_NOT_NULL(arg);
+	if (if_index != 0) {
+		if ((iface = if_ifwithindex(if_index)) == NULL) {
+			return NULL;
+		}
+		iface = iface->int_next;
+	}
 
-	*finish = 1;
-	return NL_STOP;
+	while (iface && !iface->is_wireless) {
+		iface = iface->int_next;
+	}
+	return iface;
 }
 
 /**
- * Requests the NL80211 data for a specific interface.
+ * Requests the NL80211 station dump for a specific interface. The replies
+ * are read by nl80211_station_read() as they arrive.
  *
  * @param iface		Interface to get all the NL80211 station information for.
- * @param nl80211	Pointer to linked list with station information. If set to NULL
- *					the pointer will point to a new linked list, if there was any
- *					information retreived.
+ *
+ * @returns			True if the request was sent.
  */
-static void nl80211_link_info_for_interface(struct interface *iface, struct lq_nl80211_data **nl80211) {
-	int finish = 0;
+static bool nl80211_link_info_for_interface(struct interface *iface) {
 	struct nl_msg *request_message = NULL;
-	struct nl_cb *request_cb = NULL;
-	struct nl80211_link_info_context link_context = { &finish, nl80211 };
+	bool sent = true;
 
 	ASSERT_NOT_NULL(iface);
 
-	if (! iface->is_wireless) {
-		// Remove in production code
-		olsr_syslog(OLSR_LOG_INFO, "Link entry %s is not a wireless link", iface->int_name);
-		return;
-	}
-
 	if ((request_message = nlmsg_alloc()) == NULL) {
 		olsr_exit("Failed to allocate nl_msg struct", EXIT_FAILURE);
 	}
@@ -257,47 +325,30 @@ static void nl80211_link_info_for_interface(struct interface *iface, struct lq_n
 		exit(1);
 	}
 
-#ifdef NL_DEBUG
-	if ((request_cb = nl_cb_alloc(NL_CB_DEBUG)) == NULL) {
-#else
-	if ((request_cb = nl_cb_alloc(NL_CB_DEFAULT)) == NULL) {
-#endif
-		olsr_exit("Failed to alloc nl_cb struct", EXIT_FAILURE);
-	}
-
-	if (nl_cb_set(request_cb, NL_CB_VALID, NL_CB_CUSTOM, parse_nl80211_message, &link_context) != 0) {
-		olsr_syslog(OLSR_LOG_ERR, "Failed to set netlink message callback");
-		exit(1);
-	}
-
-	nl_cb_err(request_cb, NL_CB_CUSTOM, error_handler, &finish);
-	nl_cb_set(request_cb, NL_CB_FINISH, NL_CB_CUSTOM, finish_handler, &finish);
-	nl_cb_set(request_cb, NL_CB_ACK, NL_CB_CUSTOM, ack_handler, &finish);
-
 	if (nl_send_auto_complete(gen_netlink_socket, request_message) < 0) {
 		olsr_syslog(OLSR_LOG_ERR, "Failed sending the request message with netlink");
-		exit(1);
-	}
-
-	while (! finish) {
-		nl_recvmsgs(gen_netlink_socket, request_cb);
+		sent = false;
 	}
 
 	nlmsg_free(request_message);
+
+	dump_ifindex = sent ? iface->if_index : 0;
+	dump_finished = 0;
+	return sent;
 }
 
 /**
  * Uses the linux ARP cache to find a MAC address for a neighbor. Does not do
  * actual ARP if it's not found in the cache.
  *
+ * @param cache		The ARP cache.
  * @param link		Neighbor to find MAC address of.
  * @param mac		Pointer to buffer of size ETHER_ADDR_LEN that will be
  *					used to write MAC address in (if found).
  * @returns			True if MAC address is found.
  */
-static bool mac_of_neighbor(struct link_entry *link, unsigned char *mac) {
+static bool mac_of_neighbor(struct nl_cache *cache, struct link_entry *link, unsigned char *mac) {
 	bool success = false;
-	struct nl_cache *cache = NULL;
 	struct rtnl_neigh *neighbor = NULL;
 	struct nl_addr *neighbor_addr_filter = NULL;
 	struct nl_addr *neighbor_mac_addr = NULL;
@@ -317,17 +368,7 @@ static bool mac_of_neighbor(struct link_entry *link, unsigned char *mac) {
 		goto cleanup;
 	}
 
-#if !defined(CONFIG_LIBNL20) && !defined(CONFIG_LIBNL30)
-	if ((cache = rtnl_neigh_alloc_cache(rt_netlink_socket)) == NULL) {
-#else
-	if (rtnl_neigh_alloc_cache(rt_netlink_socket, &cache) != 0) {
-#endif
-		olsr_syslog(OLSR_LOG_ERR, "Failed to allocate netlink neighbor cache");
-		goto cleanup;
-	}
-
 	if ((neighbor = rtnl_neigh_get(cache, link->inter->if_index, neighbor_addr_filter)) == NULL) {
-		olsr_syslog(OLSR_LOG_INFO, "Neighbor MAC address not found in ARP cache");
 		goto cleanup;
 	}
 
@@ -341,8 +382,6 @@ static bool mac_of_neighbor(struct link_entry *link, unsigned char *mac) {
 	}
 
 cleanup:
-	if (cache)
-		nl_cache_free(cache);
 	if (neighbor)
 		rtnl_neigh_put(neighbor);
 	if (neighbor_addr_filter)
@@ -352,46 +391,6 @@ cleanup:
 	return success;
 }
 
-void nl80211_link_info_init(void) {
-	connect_netlink();
-}
-
-void nl80211_link_info_cleanup(void) {
-	nl_socket_free(gen_netlink_socket);
-	nl_socket_free(rt_netlink_socket);
-}
-
-static void free_lq_nl80211_data(struct lq_nl80211_data *nl80211) {
-	struct lq_nl80211_data *next = nl80211;
-	while (nl80211) {
-		next = nl80211->next;
-		free(nl80211);
-		nl80211 = next;	
-	}
-}
-
-/**
- * Find a object in the linked list that matches the MAC address.
- *
- * @param nl80211_list		Pointer to the linked list to find the object in.
- * @param mac				MAC address to look for, MUST be ETHER_ADDR_LEN long.
- *
- * @returns					Pointer to object or NULL on failure.
- */
-static struct lq_nl80211_data *find_lq_nl80211_data_by_mac(struct lq_nl80211_data *nl80211_list, unsigned char *mac) {
-	ASSERT_NOT_NULL(nl80211_list);
-	ASSERT_NOT_NULL(mac);
-
-	while (nl80211_list) {
-		if (memcmp(mac, nl80211_list->mac, ETHER_ADDR_LEN) == 0) {
-			return nl80211_list;
-		}
-		nl80211_list = nl80211_list->next;
-	}
-
-	return NULL;
-}
-
 static uint8_t bandwidth_to_quality(uint16_t bandwidth) {
 	fpm ratio;
 	fpm fp_bandwidth;
@@ -440,54 +439,166 @@ static uint8_t signal_to_quality(int8_t signal) {
 	return penalty;
 }
 
-void nl80211_link_info_get(void) {
-	struct interface *next_interface = NULL;
-	struct lq_nl80211_data *nl80211_list = NULL;
+/**
+ * Applies the station data of the last round of dumps to the links. The MAC
+ * address of a neighbor is looked up in the ARP cache once and kept with the
+ * link, only the links whose values differ are written.
+ */
+static void apply_stations(void) {
+	struct nl_cache *cache = NULL;
+	bool cache_failed = false;
 	struct link_entry *link = NULL;
 	struct lq_nl80211_data *lq_data = NULL;
 	struct lq_ffeth_hello *lq_ffeth = NULL;
-	unsigned char mac_address[ETHER_ADDR_LEN];
 
 	uint8_t penalty_bandwidth;
 	uint8_t penalty_signal;
 
-	// Get latest 802.11 status information for all interfaces
-	// This list will contain OLSR and non-OLSR nodes
-	for (next_interface = ifnet; next_interface; next_interface = next_interface->int_next) {
-		nl80211_link_info_for_interface(next_interface, &nl80211_list);
-	}
-
-	if (nl80211_list == NULL) {
-		olsr_syslog(OLSR_LOG_INFO, "Failed to retreive any NL80211 data");
-		return;
-	}
-
 	OLSR_FOR_ALL_LINK_ENTRIES(link) {
 		lq_ffeth = (struct lq_ffeth_hello *) link->linkquality;
-		lq_ffeth->lq.valueBandwidth = 0;
-		lq_ffeth->lq.valueRSSI = 0;
-		lq_ffeth->smoothed_lq.valueBandwidth = 0;
-		lq_ffeth->smoothed_lq.valueRSSI = 0;
+		penalty_bandwidth = 0;
+		penalty_signal = 0;
+		lq_data = NULL;
 
-		if (mac_of_neighbor(link, mac_address)) {
-			if ((lq_data = find_lq_nl80211_data_by_mac(nl80211_list, mac_address)) != NULL) {
+		if (!lq_ffeth->mac_valid && !cache_failed) {
+			// One copy of the ARP cache for all links which need it
+			if (cache == NULL) {
+#if !defined(CONFIG_LIBNL20) && !defined(CONFIG_LIBNL30)
+				if ((cache = rtnl_neigh_alloc_cache(rt_netlink_socket)) == NULL) {
+#else
+				if (rtnl_neigh_alloc_cache(rt_netlink_socket, &cache) != 0) {
+#endif
+					olsr_syslog(OLSR_LOG_ERR, "Failed to allocate netlink neighbor cache");
+					cache = NULL;
+					cache_failed = true;
+				}
+			}
+			if (cache != NULL) {
+				lq_ffeth->mac_valid = mac_of_neighbor(cache, link, lq_ffeth->mac);
+			}
+		}
+
+		if (lq_ffeth->mac_valid) {
+			if ((lq_data = find_lq_nl80211_data_by_mac(lq_ffeth->mac)) != NULL) {
 				penalty_bandwidth = bandwidth_to_quality(lq_data->bandwidth);
 				penalty_signal = signal_to_quality(lq_data->signal);
+			} else {
+				// The address may have moved to another station, look it up again
+				lq_ffeth->mac_valid = false;
+			}
+		}
+
+		if (lq_ffeth->lq.valueBandwidth == penalty_bandwidth && lq_ffeth->lq.valueRSSI == penalty_signal
+				&& lq_ffeth->smoothed_lq.valueBandwidth == penalty_bandwidth
+				&& lq_ffeth->smoothed_lq.valueRSSI == penalty_signal) {
+			continue;
+		}
 
-				lq_ffeth->lq.valueBandwidth = penalty_bandwidth;
-				lq_ffeth->lq.valueRSSI = penalty_signal;
-				lq_ffeth->smoothed_lq.valueBandwidth = penalty_bandwidth;
-				lq_ffeth->smoothed_lq.valueRSSI = penalty_signal;
+		lq_ffeth->lq.valueBandwidth = penalty_bandwidth;
+		lq_ffeth->lq.valueRSSI = penalty_signal;
+		lq_ffeth->smoothed_lq.valueBandwidth = penalty_bandwidth;
+		lq_ffeth->smoothed_lq.valueRSSI = penalty_signal;
 
-				olsr_syslog(OLSR_LOG_INFO, "Apply 802.11: iface(%s) neighbor(%s) bandwidth(%dMb = %d) rssi(%ddBm = %d)",
-						link->if_name, ether_ntoa((struct ether_addr *)mac_address),
-						lq_data->bandwidth / 10, penalty_bandwidth, lq_data->signal, penalty_signal);
-			} else
-				olsr_syslog(OLSR_LOG_INFO, "NO match ;-(!");
+		if (lq_data) {
+			olsr_syslog(OLSR_LOG_INFO, "Apply 802.11: iface(%s) neighbor(%s) bandwidth(%dMb = %d) rssi(%ddBm = %d)",
+					link->if_name, ether_ntoa((struct ether_addr *)lq_ffeth->mac),
+					lq_data->bandwidth / 10, penalty_bandwidth, lq_data->signal, penalty_signal);
 		}
 	} OLSR_FOR_ALL_LINK_ENTRIES_END(link)
 
-	free_lq_nl80211_data(nl80211_list);
+	if (cache)
+		nl_cache_free(cache);
+}
+
+/**
+ * Requests the dump of the next wireless interface. After the last one the
+ * stations which disappeared are removed and the data is applied to the links.
+ */
+static void next_station_dump(void) {
+	struct interface *iface = next_wireless_interface(dump_ifindex);
+
+	while (iface) {
+		if (nl80211_link_info_for_interface(iface)) {
+			return;
+		}
+		iface = next_wireless_interface(iface->if_index);
+	}
+
+	dump_ifindex = 0;
+	expire_stations();
+	apply_stations();
+}
+
+/**
+ * Reads the replies of the running station dump, called by the scheduler.
+ */
+static void nl80211_station_read(int fd __attribute__ ((unused)), void *data __attribute__ ((unused)),
+		unsigned int flags __attribute__ ((unused))) {
+	// Returns when the socket has no more data
+	nl_recvmsgs(gen_netlink_socket, station_cb);
+
+	if (dump_ifindex != 0 && dump_finished) {
+		next_station_dump();
+	}
+}
+
+void nl80211_link_info_init(void) {
+	connect_netlink();
+
+#ifdef NL_DEBUG
+	if ((station_cb = nl_cb_alloc(NL_CB_DEBUG)) == NULL) {
+#else
+	if ((station_cb = nl_cb_alloc(NL_CB_DEFAULT)) == NULL) {
+#endif
+		olsr_exit("Failed to alloc nl_cb struct", EXIT_FAILURE);
+	}
+
+	if (nl_cb_set(station_cb, NL_CB_VALID, NL_CB_CUSTOM, parse_nl80211_message, NULL) != 0) {
+		olsr_exit("Failed to set netlink message callback", EXIT_FAILURE);
+	}
+
+	nl_cb_err(station_cb, NL_CB_CUSTOM, error_handler, NULL);
+	nl_cb_set(station_cb, NL_CB_FINISH, NL_CB_CUSTOM, finish_handler, NULL);
+	nl_cb_set(station_cb, NL_CB_ACK, NL_CB_CUSTOM, ack_handler, NULL);
+
+	add_olsr_socket(nl_socket_get_fd(gen_netlink_socket), &nl80211_station_read, NULL, NULL, SP_PR_READ);
+}
+
+void nl80211_link_info_cleanup(void) {
+	struct lq_nl80211_data *lq_data;
+	unsigned int idx;
+
+	remove_olsr_socket(nl_socket_get_fd(gen_netlink_socket), &nl80211_station_read, NULL);
+	nl_cb_put(station_cb);
+	nl_socket_free(gen_netlink_socket);
+	nl_socket_free(rt_netlink_socket);
+
+	for (idx = 0; idx < STATION_HASH_SIZE; idx++) {
+		while ((lq_data = station_hash[idx]) != NULL) {
+			station_hash[idx] = lq_data->next;
+			free(lq_data);
+		}
+	}
+}
+
+/**
+ * Starts a new round of station dumps over all wireless interfaces. The
+ * replies are handled by the scheduler, this never blocks.
+ */
+void nl80211_link_info_get(void) {
+	if (dump_ifindex != 0) {
+		// Give a lost reply a few rounds before starting over
+		if (++dump_stalled < 5) {
+			return;
+		}
+		olsr_syslog(OLSR_LOG_INFO, "NL80211 station dump timed out");
+	}
+	dump_stalled = 0;
+
+	// This round will contain OLSR and non-OLSR nodes
+	dump_round++;
+	dump_ifindex = 0;
+	next_station_dump();
 }
 
 #endif /* LINUX_NL80211 */
@@ -52,7 +52,8 @@ struct lq_nl80211_data {
 	unsigned char mac[ETHER_ADDR_LEN]; // MAC address of station
 	int8_t signal; // Signal level in dBm
 	uint16_t bandwidth; // Active bandwidth setting in 100kbit/sec
-	struct lq_nl80211_data *next; // Linked list pointer
+	uint32_t round; // Last round of station dumps which contained the station
+	struct lq_nl80211_data *next; // Hash bucket chain
 };
 
 void nl80211_link_info_init(void);
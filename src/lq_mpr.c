@@ -44,125 +44,273 @@
 #include "two_hop_neighbor_table.h"
 #include "link_set.h"
 #include "lq_mpr.h"
+#include "mid_set.h"
 #include "scheduler.h"
 #include "lq_plugin.h"
+#include "common/list.h"
 
+/*
+ * The MPR selection of every two hop neighbor only depends on its
+ * own one hop list and on its direct link, if it is a neighbor
+ * itself. The selection is kept in the one hop list entries and
+ * only redone for the two hop neighbors touched since the last run.
+ */
+static struct list_node lq_mpr_changed = { &lq_mpr_changed, &lq_mpr_changed };
+static struct list_node lq_mpr_direct = { &lq_mpr_direct, &lq_mpr_direct };
+
+LISTNODE2STRUCT(changed2nbr2, struct neighbor_2_entry, lq_changed_node);
+LISTNODE2STRUCT(direct2nbr2, struct neighbor_2_entry, lq_direct_node);
+
+/**
+ *Reselect the MPRs of a two hop neighbor on the next run.
+ *
+ *@param neigh2 the two hop neighbor
+ */
 void
-olsr_calculate_lq_mpr(void)
+olsr_lq_mpr_touch_two_hop(struct neighbor_2_entry *neigh2)
+{
+  if (olsr_cnf->lq_level > 0 && !list_node_on_list(&neigh2->lq_changed_node)) {
+    list_add_before(&lq_mpr_changed, &neigh2->lq_changed_node);
+  }
+}
+
+/**
+ *Reselect the MPRs of the two hop neighbor registered
+ *on an address, if there is one.
+ *
+ *@param addr the address
+ */
+void
+olsr_lq_mpr_touch_address(const union olsr_ip_addr *addr)
 {
   struct neighbor_2_entry *neigh2;
+
+  if (olsr_cnf->lq_level > 0 && (neigh2 = olsr_lookup_two_hop_neighbor_table_mid(addr)) != NULL) {
+    olsr_lq_mpr_touch_two_hop(neigh2);
+  }
+}
+
+/**
+ *Reselect the MPRs of all two hop neighbors reached through
+ *a neighbor and of the two hop neighbors which are the neighbor.
+ *Called when the status of the neighbor changes.
+ *
+ *@param neigh the neighbor
+ */
+void
+olsr_lq_mpr_touch_neighbor(struct neighbor_entry *neigh)
+{
+  struct neighbor_2_list_entry *two_hop_list;
+  struct mid_address *alias;
+
+  if (olsr_cnf->lq_level == 0) {
+    return;
+  }
+
+  for (two_hop_list = neigh->neighbor_2_list.next; two_hop_list != &neigh->neighbor_2_list; two_hop_list = two_hop_list->next) {
+    olsr_lq_mpr_touch_two_hop(two_hop_list->neighbor_2);
+  }
+
+  olsr_lq_mpr_touch_address(&neigh->neighbor_main_addr);
+  for (alias = mid_lookup_aliases(&neigh->neighbor_main_addr); alias != NULL; alias = alias->next_alias) {
+    olsr_lq_mpr_touch_address(&alias->alias);
+  }
+}
+
+/**
+ *Withdraw the selection of a one hop list entry.
+ */
+static void
+olsr_lq_mpr_release(struct neighbor_list_entry *walker)
+{
+  if (walker->lq_mpr) {
+    walker->lq_mpr = false;
+    walker->neighbor->lq_mpr_count--;
+  }
+}
+
+/**
+ *An entry is about to be removed from the one hop list
+ *of a two hop neighbor.
+ *
+ *@param neigh2 the two hop neighbor
+ *@param walker the entry of its one hop list
+ */
+void
+olsr_lq_mpr_unlink_two_hop(struct neighbor_2_entry *neigh2, struct neighbor_list_entry *walker)
+{
+  olsr_lq_mpr_release(walker);
+  olsr_lq_mpr_touch_two_hop(neigh2);
+}
+
+/**
+ *A two hop neighbor is about to be freed.
+ *
+ *@param neigh2 the two hop neighbor
+ */
+void
+olsr_lq_mpr_del_two_hop(struct neighbor_2_entry *neigh2)
+{
   struct neighbor_list_entry *walker;
-  int i, k;
+
+  for (walker = neigh2->neighbor_2_nblist.next; walker != &neigh2->neighbor_2_nblist; walker = walker->next) {
+    olsr_lq_mpr_release(walker);
+  }
+
+  if (list_node_on_list(&neigh2->lq_changed_node)) {
+    list_remove(&neigh2->lq_changed_node);
+  }
+  if (list_node_on_list(&neigh2->lq_direct_node)) {
+    list_remove(&neigh2->lq_direct_node);
+  }
+}
+
+/**
+ *Select the MPRs of one two hop neighbor.
+ *
+ *@param neigh2 the two hop neighbor
+ */
+static void
+olsr_lq_mpr_select(struct neighbor_2_entry *neigh2)
+{
+  struct neighbor_list_entry *walker, *best_walker;
   struct neighbor_entry *neigh;
   olsr_linkcost best, best_1hop;
-  bool mpr_changes = false;
+  int k;
 
-  OLSR_FOR_ALL_NBR_ENTRIES(neigh) {
+  for (walker = neigh2->neighbor_2_nblist.next; walker != &neigh2->neighbor_2_nblist; walker = walker->next) {
+    olsr_lq_mpr_release(walker);
+  }
 
-    /* Memorize previous MPR status. */
+  if (list_node_on_list(&neigh2->lq_direct_node)) {
+    list_remove(&neigh2->lq_direct_node);
+  }
 
-    neigh->was_mpr = neigh->is_mpr;
+  best_1hop = LINK_COST_BROKEN;
 
-    /* Clear current MPR status. */
+  /* check whether this 2-hop neighbour is also a neighbour */
 
-    neigh->is_mpr = false;
+  neigh = olsr_lookup_neighbor_table(&neigh2->neighbor_2_addr);
 
-    /* In this pass we are only interested in WILL_ALWAYS neighbours */
+  /* if it's a neighbour and also symmetric, then examine
+     the link quality */
 
-    if (neigh->status == NOT_SYM || neigh->willingness != WILL_ALWAYS) {
-      continue;
-    }
+  if (neigh != NULL && neigh->status == SYM) {
+    /* if the direct link is better than the best route via
+     * an MPR, then prefer the direct link and do not select
+     * an MPR for this 2-hop neighbour */
 
-    neigh->is_mpr = true;
+    /* determine the link quality of the direct link */
 
-    if (neigh->is_mpr != neigh->was_mpr) {
-      mpr_changes = true;
-    }
+    struct link_entry *lnk = get_best_link_to_neighbor(&neigh->neighbor_main_addr);
 
-  }
-  OLSR_FOR_ALL_NBR_ENTRIES_END(neigh);
+    /* watch the direct link from now on */
+    neigh2->lq_direct = lnk ? lnk->linkcost : LINK_COST_BROKEN;
+    list_add_before(&lq_mpr_direct, &neigh2->lq_direct_node);
+
+    if (!lnk)
+      return;
+
+    best_1hop = lnk->linkcost;
 
-  for (i = 0; i < HASHSIZE; i++) {
-    /* loop through all 2-hop neighbours */
+    /* see wether we find a better route via an MPR */
 
-    for (neigh2 = two_hop_neighbortable[i].next; neigh2 != &two_hop_neighbortable[i]; neigh2 = neigh2->next) {
-      best_1hop = LINK_COST_BROKEN;
+    for (walker = neigh2->neighbor_2_nblist.next; walker != &neigh2->neighbor_2_nblist; walker = walker->next)
+      if (walker->path_linkcost < best_1hop)
+        break;
 
-      /* check whether this 2-hop neighbour is also a neighbour */
+    /* we've reached the end of the list, so we haven't found
+     * a better route via an MPR - so, skip MPR selection for
+     * this 1-hop neighbor */
 
-      neigh = olsr_lookup_neighbor_table(&neigh2->neighbor_2_addr);
+    if (walker == &neigh2->neighbor_2_nblist)
+      return;
+  }
 
-      /* if it's a neighbour and also symmetric, then examine
-         the link quality */
+  /* find the connecting 1-hop neighbours with the
+   * best total link qualities */
 
-      if (neigh != NULL && neigh->status == SYM) {
-        /* if the direct link is better than the best route via
-         * an MPR, then prefer the direct link and do not select
-         * an MPR for this 2-hop neighbour */
+  for (k = 0; k < olsr_cnf->mpr_coverage; k++) {
+    /* look for the best 1-hop neighbour that we haven't
+     * yet selected */
 
-        /* determine the link quality of the direct link */
+    best_walker = NULL;
+    best = LINK_COST_BROKEN;
 
-        struct link_entry *lnk = get_best_link_to_neighbor(&neigh->neighbor_main_addr);
+    for (walker = neigh2->neighbor_2_nblist.next; walker != &neigh2->neighbor_2_nblist; walker = walker->next)
+      if (walker->neighbor->status == SYM && !walker->lq_mpr && walker->path_linkcost < best) {
+        best_walker = walker;
+        best = walker->path_linkcost;
+      }
 
-        if (!lnk)
-          continue;
+    /* Found a 1-hop neighbor that we haven't previously selected.
+     * Use it as MPR only when the 2-hop path through it is better than
+     * any existing 1-hop path. */
+    if ((best_walker != NULL) && (best < best_1hop)) {
+      best_walker->lq_mpr = true;
+      best_walker->neighbor->lq_mpr_count++;
+    }
 
-        best_1hop = lnk->linkcost;
+    /* no neighbour found => the requested MPR coverage cannot
+     * be satisfied => stop */
 
-        /* see wether we find a better route via an MPR */
+    else
+      break;
+  }
+}
 
-        for (walker = neigh2->neighbor_2_nblist.next; walker != &neigh2->neighbor_2_nblist; walker = walker->next)
-          if (walker->path_linkcost < best_1hop)
-            break;
+void
+olsr_calculate_lq_mpr(void)
+{
+  struct neighbor_2_entry *neigh2;
+  struct list_node *node;
+  struct neighbor_entry *neigh;
+  struct link_entry *lnk;
+  bool mpr_changes = false;
 
-        /* we've reached the end of the list, so we haven't found
-         * a better route via an MPR - so, skip MPR selection for
-         * this 1-hop neighbor */
+  /* the link costs change without notice, so compare the direct links */
 
-        if (walker == &neigh2->neighbor_2_nblist)
-          continue;
-      }
+  for (node = lq_mpr_direct.next; node != &lq_mpr_direct; node = node->next) {
+    neigh2 = direct2nbr2(node);
+    neigh = olsr_lookup_neighbor_table(&neigh2->neighbor_2_addr);
 
-      /* find the connecting 1-hop neighbours with the
-       * best total link qualities */
+    if (neigh == NULL || neigh->status != SYM) {
+      olsr_lq_mpr_touch_two_hop(neigh2);
+      continue;
+    }
 
-      /* mark all 1-hop neighbours as not selected */
+    lnk = get_best_link_to_neighbor(&neigh->neighbor_main_addr);
+    if ((lnk ? lnk->linkcost : LINK_COST_BROKEN) != neigh2->lq_direct) {
+      olsr_lq_mpr_touch_two_hop(neigh2);
+    }
+  }
 
-      for (walker = neigh2->neighbor_2_nblist.next; walker != &neigh2->neighbor_2_nblist; walker = walker->next)
-        walker->neighbor->skip = false;
+  while (!list_is_empty(&lq_mpr_changed)) {
+    neigh2 = changed2nbr2(lq_mpr_changed.next);
+    list_remove(&neigh2->lq_changed_node);
 
-      for (k = 0; k < olsr_cnf->mpr_coverage; k++) {
-        /* look for the best 1-hop neighbour that we haven't
-         * yet selected */
+    olsr_lq_mpr_select(neigh2);
+  }
 
-        neigh = NULL;
-        best = LINK_COST_BROKEN;
+  OLSR_FOR_ALL_NBR_ENTRIES(neigh) {
 
-        for (walker = neigh2->neighbor_2_nblist.next; walker != &neigh2->neighbor_2_nblist; walker = walker->next)
-          if (walker->neighbor->status == SYM && !walker->neighbor->skip && walker->path_linkcost < best) {
-            neigh = walker->neighbor;
-            best = walker->path_linkcost;
-          }
+    /* Memorize previous MPR status. */
 
-        /* Found a 1-hop neighbor that we haven't previously selected.
-         * Use it as MPR only when the 2-hop path through it is better than
-         * any existing 1-hop path. */
-        if ((neigh != NULL) && (best < best_1hop)) {
-          neigh->is_mpr = true;
-          neigh->skip = true;
+    neigh->was_mpr = neigh->is_mpr;
 
-          if (neigh->is_mpr != neigh->was_mpr)
-            mpr_changes = true;
-        }
+    /* WILL_ALWAYS neighbours are always selected */
 
-        /* no neighbour found => the requested MPR coverage cannot
-         * be satisfied => stop */
+    neigh->is_mpr = neigh->lq_mpr_count > 0 || (neigh->status != NOT_SYM && neigh->willingness == WILL_ALWAYS);
 
-        else
-          break;
+    if (neigh->is_mpr != neigh->was_mpr) {
+      olsr_hello_churn();
+      if (neigh->is_mpr) {
+        mpr_changes = true;
       }
     }
+
   }
+  OLSR_FOR_ALL_NBR_ENTRIES_END(neigh);
 
   if (mpr_changes && olsr_cnf->tc_redundancy > 0)
     signal_link_changes(true);
@@ -42,8 +42,24 @@
 #ifndef _OLSR_LQ_MPR
 #define _OLSR_LQ_MPR
 
+#include "olsr_types.h"
+
+struct neighbor_entry;
+struct neighbor_2_entry;
+struct neighbor_list_entry;
+
 void olsr_calculate_lq_mpr(void);
 
+void olsr_lq_mpr_touch_two_hop(struct neighbor_2_entry *);
+
+void olsr_lq_mpr_touch_address(const union olsr_ip_addr *);
+
+void olsr_lq_mpr_touch_neighbor(struct neighbor_entry *);
+
+void olsr_lq_mpr_unlink_two_hop(struct neighbor_2_entry *, struct neighbor_list_entry *);
+
+void olsr_lq_mpr_del_two_hop(struct neighbor_2_entry *);
+
 #endif /* _OLSR_LQ_MPR */
 
 /*
@@ -63,14 +63,82 @@
 
 bool lq_tc_pending = false;
 
+struct lq_tc_delta_stats lq_tc_delta_stats;
+
 static uint32_t msg_buffer_aligned[(MAXMESSAGESIZE - OLSR_HEADERSIZE) / sizeof(uint32_t) + 1];
 static unsigned char *const msg_buffer = (unsigned char *)msg_buffer_aligned;
 
-static void
-create_lq_hello(struct lq_hello_message *lq_hello, struct interface *outif)
+/*
+ * The serialized body of the last LQ_HELLO and LQ_TC of an
+ * interface is kept together with the neighbors it was built
+ * from. It is sent again with a fresh header as long as the
+ * neighbor set is the same and no link cost moved by
+ * LQ_PLUGIN_RELEVANT_COSTCHANGE or more.
+ */
+struct lq_msg_cache_entry {
+  union olsr_ip_addr addr;
+  uint8_t link_type;                   /* LQ_HELLO only */
+  uint8_t neigh_type;                  /* LQ_HELLO only */
+  olsr_linkcost cost;
+  struct link_entry *link;             /* only valid while scanning */
+  bool reported;                       /* LQ_TC base only, listed in an incremental LQ_TC */
+};
+
+struct lq_msg_cache {
+  bool valid;                          /* body matches the entries */
+  unsigned int count;
+  unsigned int size;
+  struct lq_msg_cache_entry *entries;
+  int body_len;
+  uint32_t body[(MAXMESSAGESIZE - OLSR_HEADERSIZE) / sizeof(uint32_t) + 1];
+
+  /* LQ_TC only: neighbors of the last full message, see TcDelta */
+  bool base_valid;
+  uint16_t base_ansn;
+  unsigned int base_count;
+  unsigned int base_size;
+  struct lq_msg_cache_entry *base;
+  unsigned int since_full;             /* incremental messages sent since */
+};
+
+/* neighbors of the message about to be sent, swapped into the cache */
+static struct lq_msg_cache_entry *lq_scan;
+static unsigned int lq_scan_size;
+
+/* link quality scratch space for serializing the cached body */
+static struct lq_hello_neighbor *lq_scratch_hello;
+static struct tc_mpr_addr *lq_scratch_tc;
+
+static uint8_t
+lq_hello_link_type(struct link_entry *walker, struct interface *outif)
 {
-  struct link_entry *walker;
+  // a) this neighbor interface IS NOT visible via the output interface
+  if (!ipequal(&walker->local_iface_addr, &outif->ip_addr))
+    return UNSPEC_LINK;
+
+  // b) this neighbor interface IS visible via the output interface
+  return lookup_link_status(walker);
+}
+
+static uint8_t
+lq_hello_neigh_type(struct link_entry *walker)
+{
+  if (walker->neighbor->is_mpr)
+    return MPR_NEIGH;
+
+  if (walker->neighbor->status == SYM)
+    return SYM_NEIGH;
+
+  if (walker->neighbor->status == NOT_SYM)
+    return NOT_NEIGH;
 
+  OLSR_PRINTF(0, "Error: neigh_type undefined");
+  return NOT_NEIGH;
+}
+
+static void
+init_lq_hello(struct lq_hello_message *lq_hello, struct interface *outif)
+{
   // initialize the static fields
 
   lq_hello->comm.type = LQ_HELLO_MESSAGE;
@@ -86,6 +154,14 @@ create_lq_hello(struct lq_hello_message *lq_hello, struct interface *outif)
   lq_hello->will = olsr_cnf->willingness;
 
   lq_hello->neigh = NULL;
+}
+
+static void
+create_lq_hello(struct lq_hello_message *lq_hello, struct interface *outif)
+{
+  struct link_entry *walker;
+
+  init_lq_hello(lq_hello, outif);
 
   // loop through the link set
 
@@ -94,33 +170,13 @@ create_lq_hello(struct lq_hello_message *lq_hello, struct interface *outif)
     // allocate a neighbour entry
     struct lq_hello_neighbor *neigh = olsr_malloc_lq_hello_neighbor("Build LQ_HELLO");
 
-    // a) this neighbor interface IS NOT visible via the output interface
-    if (!ipequal(&walker->local_iface_addr, &outif->ip_addr))
-      neigh->link_type = UNSPEC_LINK;
-
-    // b) this neighbor interface IS visible via the output interface
-
-    else
-      neigh->link_type = lookup_link_status(walker);
+    neigh->link_type = lq_hello_link_type(walker, outif);
 
     // set the entry's link quality
     olsr_copy_hello_lq(neigh, walker);
 
     // set the entry's neighbour type
-
-    if (walker->neighbor->is_mpr)
-      neigh->neigh_type = MPR_NEIGH;
-
-    else if (walker->neighbor->status == SYM)
-      neigh->neigh_type = SYM_NEIGH;
-
-    else if (walker->neighbor->status == NOT_SYM)
-      neigh->neigh_type = NOT_NEIGH;
-
-    else {
-      OLSR_PRINTF(0, "Error: neigh_type undefined");
-      neigh->neigh_type = NOT_NEIGH;
-    }
+    neigh->neigh_type = lq_hello_neigh_type(walker);
 
     // set the entry's neighbour interface address
 
@@ -149,19 +205,77 @@ destroy_lq_hello(struct lq_hello_message *lq_hello)
   lq_hello->neigh = NULL;
 }
 
-static void
-create_lq_tc(struct lq_tc_message *lq_tc, struct interface *outif)
+static uint8_t
+lq_tc_ttl(struct interface *outif)
 {
-  struct link_entry *lnk;
-  struct neighbor_entry *walker;
-  struct tc_mpr_addr *neigh;
   static int ttl_list[] = { 2, 8, 2, 16, 2, 8, 2, MAX_TTL };
+  uint8_t ttl;
 
-  // remember that we have generated an LQ TC message; this is
-  // checked in net_output()
+  if (olsr_cnf->lq_fish == 0) {
+    return MAX_TTL;
+  }
 
-  lq_tc_pending = true;
+  if (outif->ttl_index >= (int)(sizeof(ttl_list) / sizeof(ttl_list[0])))
+    outif->ttl_index = 0;
+
+  ttl = (0 <= outif->ttl_index ? ttl_list[outif->ttl_index] : MAX_TTL);
+  outif->ttl_index++;
+
+  OLSR_PRINTF(3, "Creating LQ TC with TTL %d.\n", ttl);
+  return ttl;
+}
+
+/*
+ * Returns the link to advertise for a neighbor in our TC,
+ * or NULL if the neighbor is not part of it.
+ */
+static struct link_entry *
+lq_tc_neighbor_link(struct neighbor_entry *walker)
+{
+  struct link_entry *lnk;
+
+  /*
+   * TC redundancy 2
+   *
+   * Only consider symmetric neighbours.
+   */
+  if (walker->status != SYM) {
+    return NULL;
+  }
+
+  /*
+   * TC redundancy 1
+   *
+   * Only consider MPRs and MPR selectors
+   */
+  if (olsr_cnf->tc_redundancy == 1 && !walker->is_mpr && !olsr_lookup_mprs_set(&walker->neighbor_main_addr)) {
+    return NULL;
+  }
+
+  /*
+   * TC redundancy 0
+   *
+   * Only consider MPR selectors
+   */
+  if (olsr_cnf->tc_redundancy == 0 && !olsr_lookup_mprs_set(&walker->neighbor_main_addr)) {
+    return NULL;
+  }
+
+  /* Set the entry's link quality */
+  lnk = get_best_link_to_neighbor(&walker->neighbor_main_addr);
+  if (!lnk) {
+    return NULL;                // no link ?
+  }
+
+  if (lnk->linkcost >= LINK_COST_BROKEN) {
+    return NULL;                // don't advertise links with very low LQ
+  }
+  return lnk;
+}
 
+static void
+init_lq_tc(struct lq_tc_message *lq_tc, struct interface *outif, uint8_t ttl)
+{
   // initialize the static fields
 
   lq_tc->comm.type = LQ_TC_MESSAGE;
@@ -170,18 +284,7 @@ create_lq_tc(struct lq_tc_message *lq_tc, struct interface *outif)
 
   lq_tc->comm.orig = olsr_cnf->main_addr;
 
-  if (olsr_cnf->lq_fish > 0) {
-    if (outif->ttl_index >= (int)(sizeof(ttl_list) / sizeof(ttl_list[0])))
-      outif->ttl_index = 0;
-
-    lq_tc->comm.ttl = (0 <= outif->ttl_index ? ttl_list[outif->ttl_index] : MAX_TTL);
-    outif->ttl_index++;
-
-    OLSR_PRINTF(3, "Creating LQ TC with TTL %d.\n", lq_tc->comm.ttl);
-  }
-
-  else
-    lq_tc->comm.ttl = MAX_TTL;
+  lq_tc->comm.ttl = ttl;
 
   lq_tc->comm.hops = 0;
 
@@ -190,44 +293,21 @@ create_lq_tc(struct lq_tc_message *lq_tc, struct interface *outif)
   lq_tc->ansn = get_local_ansn();
 
   lq_tc->neigh = NULL;
+}
 
-  OLSR_FOR_ALL_NBR_ENTRIES(walker) {
-
-    /*
-     * TC redundancy 2
-     *
-     * Only consider symmetric neighbours.
-     */
-    if (walker->status != SYM) {
-      continue;
-    }
-
-    /*
-     * TC redundancy 1
-     *
-     * Only consider MPRs and MPR selectors
-     */
-    if (olsr_cnf->tc_redundancy == 1 && !walker->is_mpr && !olsr_lookup_mprs_set(&walker->neighbor_main_addr)) {
-      continue;
-    }
+static void
+create_lq_tc(struct lq_tc_message *lq_tc, struct interface *outif, uint8_t ttl)
+{
+  struct link_entry *lnk;
+  struct neighbor_entry *walker;
+  struct tc_mpr_addr *neigh;
 
-    /*
-     * TC redundancy 0
-     *
-     * Only consider MPR selectors
-     */
-    if (olsr_cnf->tc_redundancy == 0 && !olsr_lookup_mprs_set(&walker->neighbor_main_addr)) {
-      continue;
-    }
+  init_lq_tc(lq_tc, outif, ttl);
 
-    /* Set the entry's link quality */
-    lnk = get_best_link_to_neighbor(&walker->neighbor_main_addr);
+  OLSR_FOR_ALL_NBR_ENTRIES(walker) {
+    lnk = lq_tc_neighbor_link(walker);
     if (!lnk) {
-      continue;                 // no link ?
-    }
-
-    if (lnk->linkcost >= LINK_COST_BROKEN) {
-      continue;                 // don't advertise links with very low LQ
+      continue;
     }
 
     /* Allocate a neighbour entry. */
@@ -244,14 +324,14 @@ create_lq_tc(struct lq_tc_message *lq_tc, struct interface *outif)
 
     // TODO: ugly hack until neighbor table is ported to avl tree
 
-    if (lq_tc->neigh == NULL || avl_comp_default(&lq_tc->neigh->address, &neigh->address) > 0) {
+    if (lq_tc->neigh == NULL || ipcmp(&lq_tc->neigh->address, &neigh->address) > 0) {
       neigh->next = lq_tc->neigh;
       lq_tc->neigh = neigh;
     } else {
       struct tc_mpr_addr *last = lq_tc->neigh, *n = last->next;
 
       while (n) {
-        if (avl_comp_default(&n->address, &neigh->address) > 0) {
+        if (ipcmp(&n->address, &neigh->address) > 0) {
           break;
         }
         last = n;
@@ -286,13 +366,13 @@ common_size(void)
 {
   // return the size of the header shared by all OLSR messages
 
-  return (olsr_cnf->ip_version == AF_INET) ? sizeof(struct olsr_header_v4) : sizeof(struct olsr_header_v6);
+  return (OLSR_IP_VERSION == AF_INET) ? sizeof(struct olsr_header_v4) : sizeof(struct olsr_header_v6);
 }
 
 static void
 serialize_common(struct olsr_common *comm)
 {
-  if (olsr_cnf->ip_version == AF_INET) {
+  if (OLSR_IP_VERSION == AF_INET) {
     // serialize an IPv4 OLSR message header
     struct olsr_header_v4 *olsr_head_v4 = (struct olsr_header_v4 *)ARM_NOWARN_ALIGN(msg_buffer);
 
@@ -370,7 +450,7 @@ serialize_lq_hello(struct lq_hello_message *lq_hello, struct interface *outif)
         is_first = true;
         for (neigh = lq_hello->neigh; neigh != NULL; neigh = neigh->next) {
           if (0 == i && 0 == j)
-            expected_size += olsr_cnf->ipsize + olsr_sizeof_hello_lqdata();
+            expected_size += OLSR_IPSIZE + olsr_sizeof_hello_lqdata();
           if (neigh->neigh_type == i && neigh->link_type == LINK_ORDER[j]) {
             if (is_first) {
               expected_size += sizeof(struct lq_hello_info_header);
@@ -405,7 +485,7 @@ serialize_lq_hello(struct lq_hello_message *lq_hello, struct interface *outif)
         // we need space for an IP address plus link quality
         // information
 
-        req = olsr_cnf->ipsize + olsr_sizeof_hello_lqdata();
+        req = OLSR_IPSIZE + olsr_sizeof_hello_lqdata();
 
         // no, we also need space for an info header, as this is the
         // first neighbor with the current neighbor type and link type
@@ -456,7 +536,7 @@ serialize_lq_hello(struct lq_hello_message *lq_hello, struct interface *outif)
         // add the current neighbor's IP address
 
         genipcopy(buff + size, &neigh->addr);
-        size += olsr_cnf->ipsize;
+        size += OLSR_IPSIZE;
 
         // add the corresponding link quality
         size += olsr_serialize_hello_lq_pair(&buff[size], neigh);
@@ -491,13 +571,13 @@ calculate_border_flag(void *lower_border, void *higher_border)
   uint8_t bitmask;
   uint8_t part, bitpos;
 
-  for (part = 0; part < olsr_cnf->ipsize; part++) {
+  for (part = 0; part < OLSR_IPSIZE; part++) {
     if (lower[part] != higher[part]) {
       break;
     }
   }
 
-  if (part == olsr_cnf->ipsize) {       // same IPs ?
+  if (part == OLSR_IPSIZE) {       // same IPs ?
     return 0;
   }
   // look for first bit of difference
@@ -508,7 +588,7 @@ calculate_border_flag(void *lower_border, void *higher_border)
     }
   }
 
-  bitpos += 8 * (olsr_cnf->ipsize - part - 1);
+  bitpos += 8 * (OLSR_IPSIZE - part - 1);
   return bitpos + 1;
 }
 
@@ -557,7 +637,7 @@ serialize_lq_tc(struct lq_tc_message *lq_tc, struct interface *outif)
    */
   if (0 < net_output_pending(outif)) {
     for (neigh = lq_tc->neigh; neigh != NULL; neigh = neigh->next) {
-      expected_size += olsr_cnf->ipsize + olsr_sizeof_tc_lqdata();
+      expected_size += OLSR_IPSIZE + olsr_sizeof_tc_lqdata();
     }
   }
 
@@ -572,7 +652,7 @@ serialize_lq_tc(struct lq_tc_message *lq_tc, struct interface *outif)
     // information
 
     // force signed comparison
-    if ((int)(size + olsr_cnf->ipsize + olsr_sizeof_tc_lqdata()) > rem) {
+    if ((int)(size + OLSR_IPSIZE + olsr_sizeof_tc_lqdata()) > rem) {
       head->lower_border = left_border_flag;
       assert(last_ip);
       head->upper_border = calculate_border_flag(last_ip, &neigh->address);
@@ -601,7 +681,7 @@ serialize_lq_tc(struct lq_tc_message *lq_tc, struct interface *outif)
     // remember last ip
     last_ip = (union olsr_ip_addr *)ARM_NOWARN_ALIGN(buff + size);
 
-    size += olsr_cnf->ipsize;
+    size += OLSR_IPSIZE;
 
     // add the corresponding link quality
     size += olsr_serialize_tc_lq_pair(&buff[size], neigh);
@@ -618,6 +698,381 @@ serialize_lq_tc(struct lq_tc_message *lq_tc, struct interface *outif)
   net_outbuffer_push(outif, msg_buffer, size + off);
 }
 
+/*
+ * Returns the next free entry of the scan array, grows it if needed.
+ */
+static struct lq_msg_cache_entry *
+lq_scan_entry(unsigned int idx)
+{
+  if (idx >= lq_scan_size) {
+    struct lq_msg_cache_entry *old = lq_scan;
+
+    lq_scan_size = lq_scan_size ? 2 * lq_scan_size : 32;
+    lq_scan = olsr_malloc(lq_scan_size * sizeof(*lq_scan), "LQ message scan");
+    if (old) {
+      memcpy(lq_scan, old, idx * sizeof(*lq_scan));
+      free(old);
+    }
+  }
+  return &lq_scan[idx];
+}
+
+static struct lq_msg_cache *
+lq_cache_get(struct lq_msg_cache **cache)
+{
+  if (*cache == NULL) {
+    *cache = olsr_malloc(sizeof(**cache), "LQ message cache");
+  }
+  return *cache;
+}
+
+/*
+ * Check if the neighbors scanned for a message are the ones
+ * the cached body was built from.
+ */
+static bool
+lq_cache_matches(const struct lq_msg_cache *cache, unsigned int count)
+{
+  unsigned int i;
+
+  if (!cache->valid || cache->count != count) {
+    return false;
+  }
+
+  for (i = 0; i < count; i++) {
+    const struct lq_msg_cache_entry *old = &cache->entries[i], *cur = &lq_scan[i];
+    olsr_linkcost diff = old->cost > cur->cost ? old->cost - cur->cost : cur->cost - old->cost;
+
+    if (!ipequal(&old->addr, &cur->addr) || old->link_type != cur->link_type || old->neigh_type != cur->neigh_type
+        || diff >= LQ_PLUGIN_RELEVANT_COSTCHANGE) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*
+ * Make the scanned neighbors the new key of the cache.
+ */
+static void
+lq_cache_store(struct lq_msg_cache *cache, unsigned int count)
+{
+  struct lq_msg_cache_entry *entries = cache->entries;
+  unsigned int size = cache->size;
+
+  cache->entries = lq_scan;
+  cache->size = lq_scan_size;
+  cache->count = count;
+
+  lq_scan = entries;
+  lq_scan_size = size;
+}
+
+static unsigned int
+scan_lq_hello(struct interface *outif)
+{
+  struct link_entry *walker;
+  unsigned int count = 0;
+
+  OLSR_FOR_ALL_LINK_ENTRIES(walker) {
+    struct lq_msg_cache_entry *entry = lq_scan_entry(count++);
+
+    entry->addr = walker->neighbor_iface_addr;
+    entry->link_type = lq_hello_link_type(walker, outif);
+    entry->neigh_type = lq_hello_neigh_type(walker);
+    entry->cost = walker->linkcost;
+    entry->link = walker;
+  }
+  OLSR_FOR_ALL_LINK_ENTRIES_END(walker);
+
+  return count;
+}
+
+/*
+ * Serialize the scanned LQ_HELLO neighbors into the cache, in the
+ * same order as serialize_lq_hello(). Returns false if they do not
+ * fit into a single message.
+ */
+static bool
+build_lq_hello_body(struct lq_msg_cache *cache, unsigned int count)
+{
+  static const int LINK_ORDER[] = { SYM_LINK, UNSPEC_LINK, ASYM_LINK, LOST_LINK };
+  unsigned char *buff = (unsigned char *)cache->body;
+  const int limit = sizeof(cache->body) - common_size() - sizeof(struct lq_hello_header);
+  struct lq_hello_info_header *info_head;
+  int size = 0, req, i;
+  unsigned int j, k;
+
+  if (lq_scratch_hello == NULL) {
+    lq_scratch_hello = olsr_malloc_lq_hello_neighbor("Build LQ_HELLO");
+  }
+
+  for (i = 0; i <= MAX_NEIGH; i++) {
+    for (j = 0; j < sizeof(LINK_ORDER) / sizeof(LINK_ORDER[0]); j++) {
+      info_head = NULL;
+
+      for (k = 0; k < count; k++) {
+        if (lq_scan[k].neigh_type != i || lq_scan[k].link_type != LINK_ORDER[j])
+          continue;
+
+        req = OLSR_IPSIZE + olsr_sizeof_hello_lqdata();
+        if (info_head == NULL)
+          req += sizeof(struct lq_hello_info_header);
+
+        if (size + req > limit)
+          return false;
+
+        if (info_head == NULL) {
+          info_head = (struct lq_hello_info_header *)ARM_NOWARN_ALIGN(buff + size);
+          size += sizeof(struct lq_hello_info_header);
+
+          info_head->reserved = 0;
+          info_head->link_code = CREATE_LINK_CODE(i, LINK_ORDER[j]);
+        }
+
+        genipcopy(buff + size, &lq_scan[k].addr);
+        size += OLSR_IPSIZE;
+
+        olsr_copy_hello_lq(lq_scratch_hello, lq_scan[k].link);
+        size += olsr_serialize_hello_lq_pair(&buff[size], lq_scratch_hello);
+      }
+
+      if (info_head)
+        info_head->size = ntohs(buff + size - (unsigned char *)info_head);
+    }
+  }
+
+  cache->body_len = size;
+  return true;
+}
+
+static int
+lq_tc_entry_cmp(const void *a, const void *b)
+{
+  return ipcmp(&((const struct lq_msg_cache_entry *)a)->addr, &((const struct lq_msg_cache_entry *)b)->addr);
+}
+
+static unsigned int
+scan_lq_tc(void)
+{
+  struct neighbor_entry *walker;
+  struct link_entry *lnk;
+  unsigned int count = 0;
+
+  OLSR_FOR_ALL_NBR_ENTRIES(walker) {
+    struct lq_msg_cache_entry *entry;
+
+    lnk = lq_tc_neighbor_link(walker);
+    if (!lnk) {
+      continue;
+    }
+
+    entry = lq_scan_entry(count++);
+    entry->addr = walker->neighbor_main_addr;
+    entry->link_type = 0;
+    entry->neigh_type = 0;
+    entry->cost = lnk->linkcost;
+    entry->link = lnk;
+  }
+  OLSR_FOR_ALL_NBR_ENTRIES_END(walker);
+
+  /* same order as create_lq_tc() */
+  if (count > 1) {
+    qsort(lq_scan, count, sizeof(*lq_scan), &lq_tc_entry_cmp);
+  }
+  return count;
+}
+
+/* head all scanned LQ_TC neighbors have in common */
+static int
+lq_tc_compact_head(unsigned int count)
+{
+  int head_len = count > 0 ? (int)OLSR_IPSIZE : 0;
+  unsigned int k;
+
+  for (k = 1; k < count && head_len > 0; k++) {
+    head_len = olsr_addr_block_head(&lq_scan[0].addr, &lq_scan[k].addr, head_len);
+  }
+  return olsr_addr_block_head_max(count, head_len);
+}
+
+/*
+ * Serialize the scanned LQ_TC neighbors into the cache. Returns
+ * false if they do not fit into a single message.
+ */
+static bool
+build_lq_tc_body(struct lq_msg_cache *cache, unsigned int count)
+{
+  unsigned char *buff = (unsigned char *)cache->body;
+  const int limit = sizeof(cache->body) - common_size() - sizeof(struct lq_tc_header);
+  int size = 0;
+  unsigned int k;
+
+  if (lq_scratch_tc == NULL) {
+    lq_scratch_tc = olsr_malloc_tc_mpr_addr("Build LQ_TC");
+  }
+
+  for (k = 0; k < count; k++) {
+    if ((int)(size + OLSR_IPSIZE + olsr_sizeof_tc_lqdata()) > limit)
+      return false;
+
+    genipcopy(buff + size, &lq_scan[k].addr);
+    size += OLSR_IPSIZE;
+
+    lq_scratch_tc->address = lq_scan[k].addr;
+    olsr_copylq_link_entry_2_tc_mpr_addr(lq_scratch_tc, lq_scan[k].link);
+    size += olsr_serialize_tc_lq_pair(&buff[size], lq_scratch_tc);
+  }
+
+  cache->body_len = size;
+  return true;
+}
+
+/*
+ * Serialize the scanned LQ_TC neighbors into the cache as one
+ * address block followed by their link qualities. Returns false
+ * if they do not fit into a single message.
+ */
+static bool
+build_lq_tc_compact_body(struct lq_msg_cache *cache, unsigned int count)
+{
+  unsigned char *buff = (unsigned char *)cache->body;
+  const int limit = sizeof(cache->body) - common_size() - sizeof(struct lq_tc_header);
+  int head_len = lq_tc_compact_head(count);
+  unsigned int k;
+
+  if (olsr_addr_block_size(count, head_len) + (int)(count * olsr_sizeof_tc_lqdata()) > limit)
+    return false;
+
+  if (lq_scratch_tc == NULL) {
+    lq_scratch_tc = olsr_malloc_tc_mpr_addr("Build LQ_TC");
+  }
+
+  pkt_put_addr_block_header(&buff, count, count > 0 ? &lq_scan[0].addr : NULL, head_len);
+  for (k = 0; k < count; k++) {
+    pkt_put_addr_suffix(&buff, &lq_scan[k].addr, head_len);
+  }
+  pkt_put_addr_block_pad(&buff, count, head_len);
+
+  for (k = 0; k < count; k++) {
+    lq_scratch_tc->address = lq_scan[k].addr;
+    olsr_copylq_link_entry_2_tc_mpr_addr(lq_scratch_tc, lq_scan[k].link);
+    buff += olsr_serialize_tc_lq_pair(buff, lq_scratch_tc);
+  }
+
+  cache->body_len = buff - (unsigned char *)cache->body;
+  return true;
+}
+
+/*
+ * Size of the LQ_TC for the scanned neighbors, if it fits
+ * into a single message.
+ */
+static int
+lq_tc_full_len(unsigned int count)
+{
+  int len = common_size() + sizeof(struct lq_tc_header) + count * olsr_sizeof_tc_lqdata();
+
+  if (olsr_cnf->compact_addrs) {
+    return len + olsr_addr_block_size(count, lq_tc_compact_head(count));
+  }
+  return len + count * OLSR_IPSIZE;
+}
+
+/*
+ * Rebuild the cached body if the scanned neighbors differ from
+ * the ones it was built from.
+ */
+static void
+lq_cache_update(struct lq_msg_cache *cache, unsigned int count, bool (*build) (struct lq_msg_cache *, unsigned int))
+{
+  if (lq_cache_matches(cache, count)) {
+    return;
+  }
+
+  cache->valid = build(cache, count);
+  lq_cache_store(cache, count);
+}
+
+/*
+ * Push the message header in msg_buffer (off bytes) followed by
+ * the cached body to the output buffer. Returns false if the
+ * message does not fit, it has to be fragmented by the caller.
+ */
+static bool
+lq_cache_push(struct interface *outif, struct lq_msg_cache *cache, struct olsr_common *comm, int off)
+{
+  int len = off + cache->body_len;
+
+  if (!cache->valid) {
+    return false;
+  }
+
+  /*
+   * Put the complete message into one packet,
+   * see serialize_lq_hello() and serialize_lq_tc().
+   */
+  if (net_outbuffer_bytes_left(outif) < len && 0 < net_output_pending(outif)) {
+    net_output(outif);
+  }
+  if (net_outbuffer_bytes_left(outif) < len) {
+    return false;
+  }
+
+  comm->size = len;
+  serialize_common(comm);
+
+  net_outbuffer_push(outif, msg_buffer, off);
+  net_outbuffer_push(outif, cache->body, cache->body_len);
+  return true;
+}
+
+static bool
+send_cached_lq_hello(struct lq_hello_message *lq_hello, struct interface *outif)
+{
+  int off = common_size();
+  struct lq_hello_header *head = (struct lq_hello_header *)ARM_NOWARN_ALIGN(msg_buffer + off);
+
+  head->reserved = 0;
+  head->htime = reltime_to_me(lq_hello->htime);
+  head->will = lq_hello->will;
+
+  return lq_cache_push(outif, outif->lq_hello_cache, &lq_hello->comm, off + sizeof(struct lq_hello_header));
+}
+
+static bool
+send_cached_lq_tc(struct lq_tc_message *lq_tc, struct interface *outif)
+{
+  int off = common_size();
+  struct lq_tc_header *head = (struct lq_tc_header *)ARM_NOWARN_ALIGN(msg_buffer + off);
+
+  head->ansn = htons(lq_tc->ansn);
+  head->lower_border = 0xff;
+  head->upper_border = 0xff;
+
+  if (olsr_cnf->compact_addrs) {
+    lq_tc->comm.type = LQ_TC_COMPACT_MESSAGE;
+  }
+
+  return lq_cache_push(outif, outif->lq_tc_cache, &lq_tc->comm, off + sizeof(struct lq_tc_header));
+}
+
+void
+olsr_free_lq_msg_cache(struct interface *outif)
+{
+  if (outif->lq_hello_cache) {
+    free(outif->lq_hello_cache->entries);
+    free(outif->lq_hello_cache);
+    outif->lq_hello_cache = NULL;
+  }
+  if (outif->lq_tc_cache) {
+    free(outif->lq_tc_cache->entries);
+    free(outif->lq_tc_cache->base);
+    free(outif->lq_tc_cache);
+    outif->lq_tc_cache = NULL;
+  }
+}
+
 void
 olsr_output_lq_hello(void *para)
 {
@@ -627,23 +1082,217 @@ olsr_output_lq_hello(void *para)
   if (outif == NULL) {
     return;
   }
-  // create LQ_HELLO in internal format
-  create_lq_hello(&lq_hello, outif);
 
-  // convert internal format into transmission format, send it
-  serialize_lq_hello(&lq_hello, outif);
+  // pick the interval to advertise
+  olsr_adapt_hello_interval(outif);
 
-  // destroy internal format
-  destroy_lq_hello(&lq_hello);
+  // refresh the serialized neighbors, if they changed
+  lq_cache_update(lq_cache_get(&outif->lq_hello_cache), scan_lq_hello(outif), &build_lq_hello_body);
 
-  if (net_output_pending(outif)) {
-    if (outif->immediate_send_tc) {
-      if (TIMED_OUT(outif->fwdtimer))
-        set_buffer_timer(outif);
-    } else {
-      net_output(outif);
+  init_lq_hello(&lq_hello, outif);
+
+  if (!send_cached_lq_hello(&lq_hello, outif)) {
+    // create LQ_HELLO in internal format
+    create_lq_hello(&lq_hello, outif);
+
+    // convert internal format into transmission format, send it
+    serialize_lq_hello(&lq_hello, outif);
+
+    // destroy internal format
+    destroy_lq_hello(&lq_hello);
+  }
+
+  net_output_periodic(outif, outif->olsr_if->cnf->hello_params.emission_interval, HELLO_JITTER);
+}
+
+/*
+ * Remember the neighbors of the full LQ_TC just sent, the
+ * following incremental ones are relative to them.
+ */
+static void
+lq_tc_set_base(struct lq_msg_cache *cache, uint16_t ansn)
+{
+  unsigned int i;
+
+  if (cache->count > cache->base_size) {
+    free(cache->base);
+    cache->base_size = cache->size;
+    cache->base = olsr_malloc(cache->base_size * sizeof(*cache->base), "LQ_TC delta base");
+  }
+  if (cache->count > 0) {
+    memcpy(cache->base, cache->entries, cache->count * sizeof(*cache->base));
+  }
+  for (i = 0; i < cache->count; i++) {
+    cache->base[i].reported = false;
+  }
+
+  cache->base_count = cache->count;
+  cache->base_ansn = ansn;
+  cache->base_valid = true;
+  cache->since_full = 0;
+}
+
+/*
+ * Serialize the changes of the scanned LQ_TC neighbors against the
+ * base into msg_buffer behind off bytes of header: first the removed
+ * neighbors, then the added and changed ones. A base neighbor which
+ * was listed once stays listed until the next full LQ_TC, so every
+ * incremental message holds all changes since the base. Returns the
+ * size of the body, -1 if it does not fit.
+ */
+static int
+build_lq_tc_delta(struct lq_msg_cache *cache, unsigned int count, int off, uint16_t *removed)
+{
+  unsigned char *buff = msg_buffer + off;
+  const int limit = (int)sizeof(msg_buffer_aligned) - off;
+  const int req = OLSR_IPSIZE + olsr_sizeof_tc_lqdata();
+  struct lq_msg_cache_entry *base;
+  int size = 0, cmp;
+  unsigned int i, j;
+
+  if (lq_scratch_tc == NULL) {
+    lq_scratch_tc = olsr_malloc_tc_mpr_addr("Build LQ_TC");
+  }
+
+  // both are sorted by address, see scan_lq_tc()
+  *removed = 0;
+  for (i = 0, j = 0; j < cache->base_count;) {
+    base = &cache->base[j];
+    cmp = i < count ? ipcmp(&lq_scan[i].addr, &base->addr) : 1;
+    if (cmp <= 0) {
+      i++;
+      j += cmp == 0;
+      continue;
     }
+
+    if ((int)(size + OLSR_IPSIZE) > limit)
+      return -1;
+
+    genipcopy(buff + size, &base->addr);
+    size += OLSR_IPSIZE;
+
+    base->reported = true;
+    (*removed)++;
+    j++;
+  }
+
+  for (i = 0, j = 0; i < count; i++) {
+    while (j < cache->base_count && ipcmp(&cache->base[j].addr, &lq_scan[i].addr) < 0)
+      j++;
+
+    if (j < cache->base_count && ipequal(&cache->base[j].addr, &lq_scan[i].addr)) {
+      olsr_linkcost diff;
+
+      base = &cache->base[j];
+      diff = base->cost > lq_scan[i].cost ? base->cost - lq_scan[i].cost : lq_scan[i].cost - base->cost;
+      if (!base->reported && diff < LQ_PLUGIN_RELEVANT_COSTCHANGE)
+        continue;
+      base->reported = true;
+    }
+
+    if (size + req > limit)
+      return -1;
+
+    genipcopy(buff + size, &lq_scan[i].addr);
+    size += OLSR_IPSIZE;
+
+    lq_scratch_tc->address = lq_scan[i].addr;
+    olsr_copylq_link_entry_2_tc_mpr_addr(lq_scratch_tc, lq_scan[i].link);
+    size += olsr_serialize_tc_lq_pair(&buff[size], lq_scratch_tc);
   }
+
+  return size;
+}
+
+/*
+ * Send the changes since the last full LQ_TC instead of the full
+ * message. Returns false if a full LQ_TC is due or smaller.
+ */
+static bool
+send_lq_tc_delta(struct lq_tc_message *lq_tc, struct interface *outif, unsigned int count)
+{
+  struct lq_msg_cache *cache = outif->lq_tc_cache;
+  int off = common_size();
+  struct lq_tc_delta_header *head = (struct lq_tc_delta_header *)ARM_NOWARN_ALIGN(msg_buffer + off);
+  int full_len = lq_tc_full_len(count);
+  int len;
+  uint16_t removed;
+
+  if (olsr_cnf->tc_delta == 0 || !cache->base_valid || cache->since_full + 1 >= olsr_cnf->tc_delta) {
+    return false;
+  }
+
+  off += sizeof(*head);
+  len = build_lq_tc_delta(cache, count, off, &removed);
+  if (len < 0) {
+    return false;
+  }
+  len += off;
+  if (len >= full_len) {
+    return false;
+  }
+
+  if (net_outbuffer_bytes_left(outif) < len && 0 < net_output_pending(outif)) {
+    net_output(outif);
+  }
+  if (net_outbuffer_bytes_left(outif) < len) {
+    return false;
+  }
+
+  head->ansn = htons(lq_tc->ansn);
+  head->base_ansn = htons(cache->base_ansn);
+  head->removed = htons(removed);
+  head->reserved = 0;
+
+  lq_tc->comm.type = LQ_TC_DELTA_MESSAGE;
+  lq_tc->comm.size = len;
+  serialize_common(&lq_tc->comm);
+
+  net_outbuffer_push(outif, msg_buffer, len);
+
+  cache->since_full++;
+
+  lq_tc_delta_stats.delta_msgs++;
+  lq_tc_delta_stats.delta_bytes += len;
+  lq_tc_delta_stats.saved_bytes += full_len - len;
+  return true;
+}
+
+/*
+ * Send our LQ_TC, from the cache if possible.
+ */
+static void
+send_lq_tc(struct lq_tc_message *lq_tc, struct interface *outif, unsigned int count)
+{
+  struct lq_msg_cache *cache = outif->lq_tc_cache;
+
+  // the base of the incremental LQ_TCs has to reach everybody
+  if (olsr_cnf->tc_delta > 0) {
+    lq_tc->comm.ttl = MAX_TTL;
+  }
+
+  // refresh the serialized neighbors, if they changed
+  lq_cache_update(cache, count, olsr_cnf->compact_addrs ? &build_lq_tc_compact_body : &build_lq_tc_body);
+
+  if (send_cached_lq_tc(lq_tc, outif)) {
+    lq_tc_delta_stats.full_msgs++;
+    lq_tc_delta_stats.full_bytes += lq_tc->comm.size;
+
+    lq_tc_set_base(cache, lq_tc->ansn);
+    return;
+  }
+
+  // a fragmented LQ_TC is no base
+  cache->base_valid = false;
+
+  // create LQ_TC in internal format
+  create_lq_tc(lq_tc, outif, lq_tc->comm.ttl);
+
+  // convert internal format into transmission format, send it
+  serialize_lq_tc(lq_tc, outif);
+
+  // destroy internal format
+  destroy_lq_tc(lq_tc);
 }
 
 void
@@ -652,21 +1301,34 @@ olsr_output_lq_tc(void *para)
   static int prev_empty = 1;
   struct lq_tc_message lq_tc;
   struct interface *outif = para;
+  unsigned int count;
 
   if (outif == NULL) {
     return;
   }
-  // create LQ_TC in internal format
 
-  create_lq_tc(&lq_tc, outif);
+  // pick the interval to advertise
+  olsr_adapt_tc_interval(outif);
+
+  // remember that we have generated an LQ TC message; this is
+  // checked in net_output()
+
+  lq_tc_pending = true;
+
+  init_lq_tc(&lq_tc, outif, lq_tc_ttl(outif));
+
+  count = scan_lq_tc();
+  lq_cache_get(&outif->lq_tc_cache);
 
   // a) the message is not empty
 
-  if (lq_tc.neigh != NULL) {
+  if (count > 0) {
     prev_empty = 0;
 
     // convert internal format into transmission format, send it
-    serialize_lq_tc(&lq_tc, outif);
+    if (!send_lq_tc_delta(&lq_tc, outif, count)) {
+      send_lq_tc(&lq_tc, outif, count);
+    }
 
     // b) this is the first empty message
   } else if (prev_empty == 0) {
@@ -678,24 +1340,14 @@ olsr_output_lq_tc(void *para)
 
     // convert internal format into transmission format, send it
 
-    serialize_lq_tc(&lq_tc, outif);
+    send_lq_tc(&lq_tc, outif, count);
 
     // c) this is not the first empty message, send if timer hasn't fired
   } else if (!TIMED_OUT(get_empty_tc_timer())) {
-    serialize_lq_tc(&lq_tc, outif);
+    send_lq_tc(&lq_tc, outif, count);
   }
-  // destroy internal format
 
-  destroy_lq_tc(&lq_tc);
-
-  if (net_output_pending(outif)) {
-    if (!outif->immediate_send_tc) {
-      if (TIMED_OUT(outif->fwdtimer))
-        set_buffer_timer(outif);
-    } else {
-      net_output(outif);
-    }
-  }
+  net_output_periodic(outif, outif->olsr_if->cnf->tc_params.emission_interval, TC_JITTER);
 }
 
 /*
@@ -49,6 +49,8 @@
 
 #define LQ_HELLO_MESSAGE      201
 #define LQ_TC_MESSAGE         202
+#define LQ_TC_DELTA_MESSAGE   203
+#define LQ_TC_COMPACT_MESSAGE 204
 
 /* deserialized OLSR header */
 
@@ -132,6 +134,47 @@ struct lq_tc_header {
   uint8_t upper_border;
 };
 
+/*
+ * serialized incremental LQ_TC, the removed neighbors come first
+ * (address only), followed by the added and changed ones (address
+ * and link quality)
+ */
+
+struct lq_tc_delta_header {
+  uint16_t ansn;
+  uint16_t base_ansn;                  /* ansn of the full LQ_TC it applies to */
+  uint16_t removed;                    /* number of removed neighbors */
+  uint16_t reserved;
+};
+
+/* bytes sent in full and incremental LQ_TCs */
+struct lq_tc_delta_stats {
+  uint32_t full_msgs;
+  uint32_t delta_msgs;
+  uint64_t full_bytes;
+  uint64_t delta_bytes;
+  uint64_t saved_bytes;                /* full size minus delta size of every delta sent */
+};
+
+/*
+ * Compact address block, see CompactAddresses. The common head of
+ * all addresses is sent once, followed by the remaining bytes of
+ * every address. The block is padded to a multiple of 4 bytes.
+ */
+struct olsr_addr_block_header {
+  uint16_t count;
+  uint8_t head_len;
+  uint8_t reserved;
+};
+
+/* deserialized address block */
+struct olsr_addr_block {
+  union olsr_ip_addr head;
+  int count;
+  int head_len;
+  const uint8_t *suffix;
+};
+
 static INLINE void
 pkt_get_u8(const uint8_t ** p, uint8_t * var)
 {
@@ -177,14 +220,14 @@ pkt_get_reltime(const uint8_t ** p, olsr_reltime * var)
 static INLINE void
 pkt_get_ipaddress(const uint8_t ** p, union olsr_ip_addr *var)
 {
-  memcpy(var, *p, olsr_cnf->ipsize);
-  *p += olsr_cnf->ipsize;
+  memcpy(var, *p, OLSR_IPSIZE);
+  *p += OLSR_IPSIZE;
 }
 static INLINE void
 pkt_get_prefixlen(const uint8_t ** p, uint8_t * var)
 {
-  *var = netmask_to_prefix(*p, olsr_cnf->ipsize);
-  *p += olsr_cnf->ipsize;
+  *var = netmask_to_prefix(*p, OLSR_IPSIZE);
+  *p += OLSR_IPSIZE;
 }
 
 static INLINE void
@@ -220,12 +263,12 @@ pkt_ignore_s32(const uint8_t ** p)
 static INLINE void
 pkt_ignore_ipaddress(const uint8_t ** p)
 {
-  *p += olsr_cnf->ipsize;
+  *p += OLSR_IPSIZE;
 }
 static INLINE void
 pkt_ignore_prefixlen(const uint8_t ** p)
 {
-  *p += olsr_cnf->ipsize;
+  *p += OLSR_IPSIZE;
 }
 
 static INLINE void
@@ -273,18 +316,123 @@ pkt_put_reltime(uint8_t ** p, olsr_reltime var)
 static INLINE void
 pkt_put_ipaddress(uint8_t ** p, const union olsr_ip_addr *var)
 {
-  memcpy(*p, var, olsr_cnf->ipsize);
-  *p += olsr_cnf->ipsize;
+  memcpy(*p, var, OLSR_IPSIZE);
+  *p += OLSR_IPSIZE;
+}
+
+/* length of the head two addresses have in common, at most head_len */
+static INLINE int
+olsr_addr_block_head(const union olsr_ip_addr *a, const union olsr_ip_addr *b, int head_len)
+{
+  const uint8_t *x = (const uint8_t *)a, *y = (const uint8_t *)b;
+  int i;
+
+  for (i = 0; i < head_len && x[i] == y[i]; i++);
+  return i;
+}
+
+/*
+ * Blocks with more than one address keep at least one byte of
+ * each address, so the message size bounds their count.
+ */
+static INLINE int
+olsr_addr_block_head_max(int count, int head_len)
+{
+  return count > 1 && head_len >= (int)OLSR_IPSIZE ? (int)OLSR_IPSIZE - 1 : head_len;
+}
+
+static INLINE int
+olsr_addr_block_size(int count, int head_len)
+{
+  int size = sizeof(struct olsr_addr_block_header) + head_len + count * ((int)OLSR_IPSIZE - head_len);
+
+  return (size + 3) & ~3;
+}
+
+static INLINE void
+pkt_put_addr_block_header(uint8_t ** p, int count, const union olsr_ip_addr *head, int head_len)
+{
+  pkt_put_u16(p, count);
+  pkt_put_u8(p, head_len);
+  pkt_put_u8(p, 0);
+  if (head_len > 0) {
+    memcpy(*p, head, head_len);
+    *p += head_len;
+  }
+}
+static INLINE void
+pkt_put_addr_suffix(uint8_t ** p, const union olsr_ip_addr *var, int head_len)
+{
+  memcpy(*p, (const uint8_t *)var + head_len, OLSR_IPSIZE - head_len);
+  *p += OLSR_IPSIZE - head_len;
+}
+static INLINE void
+pkt_put_addr_block_pad(uint8_t ** p, int count, int head_len)
+{
+  int pad = (sizeof(struct olsr_addr_block_header) + head_len + count * ((int)OLSR_IPSIZE - head_len)) & 3;
+
+  if (pad) {
+    memset(*p, 0, 4 - pad);
+    *p += 4 - pad;
+  }
+}
+
+/*
+ * Read the header of an address block, *p points behind the
+ * block afterwards. Returns false if it exceeds the limit.
+ */
+static INLINE bool
+pkt_get_addr_block(const uint8_t ** p, const uint8_t * limit, struct olsr_addr_block *block)
+{
+  uint16_t count;
+  uint8_t head_len;
+  int size;
+
+  if (*p + sizeof(struct olsr_addr_block_header) > limit) {
+    return false;
+  }
+  pkt_get_u16(p, &count);
+  pkt_get_u8(p, &head_len);
+  pkt_ignore_u8(p);
+
+  if (head_len > OLSR_IPSIZE || (head_len == OLSR_IPSIZE && count > 1)) {
+    return false;
+  }
+  size = olsr_addr_block_size(count, head_len) - sizeof(struct olsr_addr_block_header);
+  if (*p + size > limit) {
+    return false;
+  }
+
+  memset(&block->head, 0, sizeof(block->head));
+  memcpy(&block->head, *p, head_len);
+  block->count = count;
+  block->head_len = head_len;
+  block->suffix = *p + head_len;
+
+  *p += size;
+  return true;
+}
+static INLINE void
+olsr_addr_block_get(const struct olsr_addr_block *block, int idx, union olsr_ip_addr *var)
+{
+  int len = OLSR_IPSIZE - block->head_len;
+
+  *var = block->head;
+  memcpy((uint8_t *)var + block->head_len, block->suffix + idx * len, len);
 }
 
 void olsr_output_lq_hello(void *para);
 
 void olsr_output_lq_tc(void *para);
 
+void olsr_free_lq_msg_cache(struct interface *);
+
 void olsr_input_lq_hello(union olsr_message *ser, struct interface *inif, union olsr_ip_addr *from);
 
 extern bool lq_tc_pending;
 
+extern struct lq_tc_delta_stats lq_tc_delta_stats;
+
 #endif /* _OLSR_LQ_PACKET_H */
 
 /*
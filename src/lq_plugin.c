@@ -45,6 +45,7 @@
 #include "lq_packet.h"
 #include "packet.h"
 #include "olsr.h"
+#include "parser.h"
 #include "two_hop_neighbor_table.h"
 #include "common/avl.h"
 
@@ -59,8 +60,16 @@
 
 #include <assert.h>
 
+#ifdef LQ_ALGORITHM_FIXED
+/* the algorithm chosen at build time, see LQ_HANDLER_CONST */
+#include LQ_ALGORITHM_SOURCE
+#define LQ_HANDLER (&LQ_ALGORITHM_FIXED)
+#else
+#define LQ_HANDLER active_lq_handler
+#endif
+
 struct avl_tree lq_handler_tree;
-struct lq_handler *active_lq_handler = NULL;
+const struct lq_handler *active_lq_handler = NULL;
 
 /**
  * case-insensitive string comparator for avl-trees
@@ -109,12 +118,21 @@ init_lq_handler_tree(void)
   register_lq_handler(&lq_etx_ffeth_nl80211_handler, LQ_ALGORITHM_ETX_FFETH_NL80211_NAME);
 #endif
 
+#ifdef LQ_ALGORITHM_FIXED
+  if (olsr_cnf->lq_algorithm != NULL && strcasecmp(olsr_cnf->lq_algorithm, LQ_ALGORITHM_NAME) != 0) {
+    OLSR_PRINTF(1, "Error, lq_handler '%s' requested, this olsrd is built for '%s' only\n", olsr_cnf->lq_algorithm,
+                LQ_ALGORITHM_NAME);
+    olsr_exit("", 1);
+  }
+  activate_lq_handler(LQ_ALGORITHM_NAME);
+#else
   if (olsr_cnf->lq_algorithm == NULL) {
     activate_lq_handler(DEF_LQ_ALGORITHM);
   }
   else {
     activate_lq_handler(olsr_cnf->lq_algorithm);
   }
+#endif
 }
 
 /**
@@ -130,7 +148,7 @@ init_lq_handler_tree(void)
  * @param name name of the link quality handler for debug output
  */
 void
-register_lq_handler(struct lq_handler *handler, const char *name)
+register_lq_handler(const struct lq_handler *handler, const char *name)
 {
   struct lq_handler_node *node;
   size_t name_size = sizeof(*node) + strlen(name) + 1;
@@ -156,7 +174,7 @@ olsr_linkcost
 olsr_calc_tc_cost(const struct tc_edge_entry * tc_edge)
 {
   assert((const char *)tc_edge + sizeof(*tc_edge) >= (const char *)tc_edge->linkquality);
-  return active_lq_handler->calc_tc_cost(tc_edge->linkquality);
+  return LQ_HANDLER->calc_tc_cost(tc_edge->linkquality);
 }
 
 /**
@@ -173,7 +191,7 @@ int
 olsr_serialize_hello_lq_pair(unsigned char *buff, struct lq_hello_neighbor *neigh)
 {
   assert((const char *)neigh + sizeof(*neigh) >= (const char *)neigh->linkquality);
-  return active_lq_handler->serialize_hello_lq(buff, neigh->linkquality);
+  return LQ_HANDLER->serialize_hello_lq(buff, neigh->linkquality);
 }
 
 /**
@@ -189,8 +207,8 @@ void
 olsr_deserialize_hello_lq_pair(const uint8_t ** curr, struct hello_neighbor *neigh)
 {
   assert((const char *)neigh + sizeof(*neigh) >= (const char *)neigh->linkquality);
-  active_lq_handler->deserialize_hello_lq(curr, neigh->linkquality);
-  neigh->cost = active_lq_handler->calc_hello_cost(neigh->linkquality);
+  LQ_HANDLER->deserialize_hello_lq(curr, neigh->linkquality);
+  neigh->cost = LQ_HANDLER->calc_hello_cost(neigh->linkquality);
 }
 
 /**
@@ -207,7 +225,7 @@ int
 olsr_serialize_tc_lq_pair(unsigned char *buff, struct tc_mpr_addr *neigh)
 {
   assert((const char *)neigh + sizeof(*neigh) >= (const char *)neigh->linkquality);
-  return active_lq_handler->serialize_tc_lq(buff, neigh->linkquality);
+  return LQ_HANDLER->serialize_tc_lq(buff, neigh->linkquality);
 }
 
 /**
@@ -222,7 +240,7 @@ void
 olsr_deserialize_tc_lq_pair(const uint8_t ** curr, struct tc_edge_entry *edge)
 {
   assert((const char *)edge + sizeof(*edge) >= (const char *)edge->linkquality);
-  active_lq_handler->deserialize_tc_lq(curr, edge->linkquality);
+  LQ_HANDLER->deserialize_tc_lq(curr, edge->linkquality);
 }
 
 /**
@@ -239,7 +257,7 @@ void
 olsr_update_packet_loss_worker(struct link_entry *entry, bool lost)
 {
   assert((const char *)entry + sizeof(*entry) >= (const char *)entry->linkquality);
-  active_lq_handler->packet_loss_handler(entry, entry->linkquality, lost);
+  LQ_HANDLER->packet_loss_handler(entry, entry->linkquality, lost);
 }
 
 /**
@@ -258,9 +276,9 @@ olsr_memorize_foreign_hello_lq(struct link_entry *local, struct hello_neighbor *
   assert((const char *)local + sizeof(*local) >= (const char *)local->linkquality);
   if (foreign) {
     assert((const char *)foreign + sizeof(*foreign) >= (const char *)foreign->linkquality);
-    active_lq_handler->memorize_foreign_hello(local->linkquality, foreign->linkquality);
+    LQ_HANDLER->memorize_foreign_hello(local->linkquality, foreign->linkquality);
   } else {
-    active_lq_handler->memorize_foreign_hello(local->linkquality, NULL);
+    LQ_HANDLER->memorize_foreign_hello(local->linkquality, NULL);
   }
 }
 
@@ -280,7 +298,7 @@ const char *
 get_link_entry_text(struct link_entry *entry, char separator, struct lqtextbuffer *buffer)
 {
   assert((const char *)entry + sizeof(*entry) >= (const char *)entry->linkquality);
-  return active_lq_handler->print_hello_lq(entry->linkquality, separator, buffer);
+  return LQ_HANDLER->print_hello_lq(entry->linkquality, separator, buffer);
 }
 
 /**
@@ -299,7 +317,7 @@ const char *
 get_tc_edge_entry_text(struct tc_edge_entry *entry, char separator, struct lqtextbuffer *buffer)
 {
   assert((const char *)entry + sizeof(*entry) >= (const char *)entry->linkquality);
-  return active_lq_handler->print_tc_lq(entry->linkquality, separator, buffer);
+  return LQ_HANDLER->print_tc_lq(entry->linkquality, separator, buffer);
 }
 
 /**
@@ -327,7 +345,7 @@ get_linkcost_text(olsr_linkcost cost, bool route, struct lqtextbuffer *buffer)
       return infinite;
     }
   }
-  return active_lq_handler->print_cost(cost, buffer);
+  return LQ_HANDLER->print_cost(cost, buffer);
 }
 
 /**
@@ -344,7 +362,7 @@ olsr_copy_hello_lq(struct lq_hello_neighbor *target, struct link_entry *source)
 {
   assert((const char *)target + sizeof(*target) >= (const char *)target->linkquality);
   assert((const char *)source + sizeof(*source) >= (const char *)source->linkquality);
-  active_lq_handler->copy_link_lq_into_neigh(target->linkquality, source->linkquality);
+  LQ_HANDLER->copy_link_lq_into_neigh(target->linkquality, source->linkquality);
 }
 
 /**
@@ -361,7 +379,7 @@ olsr_copylq_link_entry_2_tc_mpr_addr(struct tc_mpr_addr *target, struct link_ent
 {
   assert((const char *)target + sizeof(*target) >= (const char *)target->linkquality);
   assert((const char *)source + sizeof(*source) >= (const char *)source->linkquality);
-  active_lq_handler->copy_link_lq_into_tc(target->linkquality, source->linkquality);
+  LQ_HANDLER->copy_link_lq_into_tc(target->linkquality, source->linkquality);
 }
 
 /**
@@ -378,12 +396,12 @@ olsr_copylq_link_entry_2_tc_edge_entry(struct tc_edge_entry *target, struct link
 {
   assert((const char *)target + sizeof(*target) >= (const char *)target->linkquality);
   assert((const char *)source + sizeof(*source) >= (const char *)source->linkquality);
-  active_lq_handler->copy_link_lq_into_tc(target->linkquality, source->linkquality);
+  LQ_HANDLER->copy_link_lq_into_tc(target->linkquality, source->linkquality);
 }
 
 /* clear the lq of a link set entry */
 void olsr_clear_hello_lq(struct link_entry *link) {
-  active_lq_handler->clear_hello(link->linkquality);
+  LQ_HANDLER->clear_hello(link->linkquality);
 }
 
 /**
@@ -397,7 +415,7 @@ void
 olsr_clear_tc_lq(struct tc_mpr_addr *target)
 {
   assert((const char *)target + sizeof(*target) >= (const char *)target->linkquality);
-  active_lq_handler->clear_tc(target->linkquality);
+  LQ_HANDLER->clear_tc(target->linkquality);
 }
 
 /**
@@ -415,10 +433,30 @@ olsr_malloc_hello_neighbor(const char *id)
 {
   struct hello_neighbor *h;
 
-  h = olsr_malloc(sizeof(struct hello_neighbor) + active_lq_handler->hello_lq_size, id);
+  h = olsr_malloc(sizeof(struct hello_neighbor) + LQ_HANDLER->hello_lq_size, id);
 
   assert((const char *)h + sizeof(*h) >= (const char *)h->linkquality);
-  active_lq_handler->clear_hello(h->linkquality);
+  LQ_HANDLER->clear_hello(h->linkquality);
+  return h;
+}
+
+/**
+ * olsr_parser_alloc_hello_neighbor
+ *
+ * this function allocates a hello_neighbor inclusive linkquality
+ * data from the parser arena. It is only valid while the current
+ * packet is parsed.
+ *
+ * @return pointer to hello_neighbor
+ */
+struct hello_neighbor *
+olsr_parser_alloc_hello_neighbor(void)
+{
+  struct hello_neighbor *h;
+
+  h = olsr_parser_arena_alloc(sizeof(struct hello_neighbor) + LQ_HANDLER->hello_lq_size);
+
+  LQ_HANDLER->clear_hello(h->linkquality);
   return h;
 }
 
@@ -437,10 +475,10 @@ olsr_malloc_tc_mpr_addr(const char *id)
 {
   struct tc_mpr_addr *t;
 
-  t = olsr_malloc(sizeof(struct tc_mpr_addr) + active_lq_handler->tc_lq_size, id);
+  t = olsr_malloc(sizeof(struct tc_mpr_addr) + LQ_HANDLER->tc_lq_size, id);
 
   assert((const char *)t + sizeof(*t) >= (const char *)t->linkquality);
-  active_lq_handler->clear_tc(t->linkquality);
+  LQ_HANDLER->clear_tc(t->linkquality);
   return t;
 }
 
@@ -459,10 +497,10 @@ olsr_malloc_lq_hello_neighbor(const char *id)
 {
   struct lq_hello_neighbor *h;
 
-  h = olsr_malloc(sizeof(struct lq_hello_neighbor) + active_lq_handler->hello_lq_size, id);
+  h = olsr_malloc(sizeof(struct lq_hello_neighbor) + LQ_HANDLER->hello_lq_size, id);
 
   assert((const char *)h + sizeof(*h) >= (const char *)h->linkquality);
-  active_lq_handler->clear_hello(h->linkquality);
+  LQ_HANDLER->clear_hello(h->linkquality);
   return h;
 }
 
@@ -470,30 +508,31 @@ olsr_malloc_lq_hello_neighbor(const char *id)
  * olsr_malloc_link_entry
  *
  * this function allocates memory for an link_entry inclusive
- * linkquality data.
+ * linkquality data from the link_entry memory cookie.
  *
- * @param id string for memory debugging
+ * @param id string for memory debugging (unused, the cookie
+ *   name identifies the allocation)
  *
  * @return pointer to link_entry
  */
 struct link_entry *
-olsr_malloc_link_entry(const char *id)
+olsr_malloc_link_entry(const char *id __attribute__ ((unused)))
 {
   struct link_entry *h;
 
-  h = olsr_malloc(sizeof(struct link_entry) + active_lq_handler->hello_lq_size, id);
+  h = olsr_cookie_malloc(link_mem_cookie);
 
   assert((const char *)h + sizeof(*h) >= (const char *)h->linkquality);
-  active_lq_handler->clear_hello(h->linkquality);
+  LQ_HANDLER->clear_hello(h->linkquality);
   return h;
 }
 
 size_t olsr_sizeof_hello_lqdata(void) {
-  return active_lq_handler->hello_lqdata_size;
+  return LQ_HANDLER->hello_lqdata_size;
 }
 
 size_t olsr_sizeof_tc_lqdata(void) {
-  return active_lq_handler->tc_lqdata_size;
+  return LQ_HANDLER->tc_lqdata_size;
 }
 
 /**
@@ -504,8 +543,11 @@ void olsr_relevant_linkcost_change(void) {
   changes_neighborhood = true;
   changes_topology = true;
 
-  /* XXX - we should check whether we actually announce this neighbour */
-  signal_link_changes(true);
+  /*
+   * XXX - we should check whether we actually announce this neighbour.
+   * Cost changes alone bump the ANSN, but do not reset the TC interval.
+   */
+  link_changes = true;
 }
 
 /*
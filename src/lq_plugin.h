@@ -63,6 +63,17 @@ struct lqtextbuffer {
   char buf[16];
 };
 
+/*
+ * Builds with "make LQ_ALGORITHM=<name>" compile the named algorithm
+ * into lq_plugin.c. The handlers are constant there, so the calls
+ * into the algorithm are direct and can be inlined.
+ */
+#ifdef LQ_ALGORITHM_FIXED
+#define LQ_HANDLER_CONST const
+#else
+#define LQ_HANDLER_CONST
+#endif
+
 struct lq_handler {
   void (*initialize) (void);
 
@@ -94,7 +105,7 @@ struct lq_handler {
 
 struct lq_handler_node {
   struct avl_node node;
-  struct lq_handler *handler;
+  const struct lq_handler *handler;
   char name[0];
 };
 
@@ -112,7 +123,7 @@ AVLNODE2STRUCT(lq_handler_tree2lq_handler_node, struct lq_handler_node, node);
 int avl_strcasecmp(const void *str1, const void *str2);
 void init_lq_handler_tree(void);
 
-void register_lq_handler(struct lq_handler *handler, const char *name);
+void register_lq_handler(const struct lq_handler *handler, const char *name);
 
 olsr_linkcost olsr_calc_tc_cost(const struct tc_edge_entry *);
 
@@ -135,6 +146,7 @@ void olsr_copylq_link_entry_2_tc_edge_entry(struct tc_edge_entry *target, struct
 void olsr_clear_tc_lq(struct tc_mpr_addr *target);
 
 struct hello_neighbor *olsr_malloc_hello_neighbor(const char *id);
+struct hello_neighbor *olsr_parser_alloc_hello_neighbor(void);
 struct tc_mpr_addr *olsr_malloc_tc_mpr_addr(const char *id);
 struct lq_hello_neighbor *olsr_malloc_lq_hello_neighbor(const char *id);
 struct link_entry *olsr_malloc_link_entry(const char *id);
@@ -145,7 +157,7 @@ size_t olsr_sizeof_tc_lqdata(void);
 void olsr_relevant_linkcost_change(void);
 
 /* Externals. */
-extern struct lq_handler *active_lq_handler;
+extern const struct lq_handler *active_lq_handler;
 
 #endif /* LQPLUGIN_H_ */
 
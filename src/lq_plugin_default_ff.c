@@ -75,7 +75,7 @@ static const char *default_lq_print_ff(void *ptr, char separator, struct lqtextb
 static const char *default_lq_print_cost_ff(olsr_linkcost cost, struct lqtextbuffer *buffer);
 
 /* etx lq plugin (freifunk fpm version) settings */
-struct lq_handler lq_etx_ff_handler = {
+LQ_HANDLER_CONST struct lq_handler lq_etx_ff_handler = {
   &default_lq_initialize_ff,
   &default_lq_calc_cost_ff,
   &default_lq_calc_cost_ff,
@@ -165,6 +165,26 @@ default_lq_ff_handle_lqchange(void) {
   olsr_relevant_linkcost_change();
 }
 
+/* add a window slot to the running sums */
+static void
+default_lq_ff_sum_slot(struct default_lq_ff_hello *lq, int slot)
+{
+  if (slot < lq->windowSize) {
+    lq->received_sum += lq->received[slot];
+    lq->total_sum += lq->total[slot];
+  }
+}
+
+/* remove a window slot from the running sums */
+static void
+default_lq_ff_unsum_slot(struct default_lq_ff_hello *lq, int slot)
+{
+  if (slot < lq->windowSize) {
+    lq->received_sum -= lq->received[slot];
+    lq->total_sum -= lq->total[slot];
+  }
+}
+
 static void
 default_lq_parser_ff(struct olsr *olsr, struct interface *in_if, union olsr_ip_addr *from_addr)
 {
@@ -203,8 +223,10 @@ default_lq_parser_ff(struct olsr *olsr, struct interface *in_if, union olsr_ip_a
     seq_diff = 1;
   }
 
+  default_lq_ff_unsum_slot(lq, lq->activePtr);
   lq->received[lq->activePtr]++;
   lq->total[lq->activePtr] += seq_diff;
+  default_lq_ff_sum_slot(lq, lq->activePtr);
 
   lq->last_seq_nr = olsr->olsr_seqno;
   lq->missed_hellos = 0;
@@ -218,19 +240,15 @@ default_lq_ff_timer(void __attribute__ ((unused)) * context)
   OLSR_FOR_ALL_LINK_ENTRIES(link) {
     struct default_lq_ff_hello *tlq = (struct default_lq_ff_hello *)link->linkquality;
     fpm ratio;
-    int i, received, total;
-
-    received = 0;
-    total = 0;
+    int received, total;
 
     /* enlarge window if still in quickstart phase */
     if (tlq->windowSize < LQ_FF_WINDOW) {
       tlq->windowSize++;
+      default_lq_ff_sum_slot(tlq, tlq->windowSize - 1);
     }
-    for (i = 0; i < tlq->windowSize; i++) {
-      received += tlq->received[i];
-      total += tlq->total[i];
-    }
+    received = tlq->received_sum;
+    total = tlq->total_sum;
 
     /* calculate link quality */
     if (total == 0) {
@@ -241,7 +259,10 @@ default_lq_ff_timer(void __attribute__ ((unused)) * context)
 
       /* keep missed hello periods in mind (round up hello interval to seconds) */
       if (tlq->missed_hellos > 1) {
-        received = received - received * tlq->missed_hellos * link->inter->hello_etime/1000 / LQ_FF_WINDOW;
+        /* stretched HELLO intervals can miss more than the whole window */
+        const uint64_t missed = (uint64_t)tlq->missed_hellos * link->loss_helloint / 1000;
+
+        received = missed >= LQ_FF_WINDOW ? 0 : received - received * (int)missed / LQ_FF_WINDOW;
       }
 
       // calculate received/total factor
@@ -254,6 +275,7 @@ default_lq_ff_timer(void __attribute__ ((unused)) * context)
 
     // shift buffer
     tlq->activePtr = (tlq->activePtr + 1) % LQ_FF_WINDOW;
+    default_lq_ff_unsum_slot(tlq, tlq->activePtr);
     tlq->total[tlq->activePtr] = 0;
     tlq->received[tlq->activePtr] = 0;
   } OLSR_FOR_ALL_LINK_ENTRIES_END(link);
@@ -392,6 +414,11 @@ default_lq_clear_ff_hello(void *target)
   for (i = 0; i < LQ_FF_WINDOW; i++) {
     local->total[i] = 3;
   }
+  local->received_sum = 0;
+  local->total_sum = 0;
+  for (i = 0; i < local->windowSize; i++) {
+    default_lq_ff_sum_slot(local, i);
+  }
 }
 
 static const char *
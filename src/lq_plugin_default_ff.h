@@ -64,10 +64,11 @@ struct default_lq_ff_hello {
   uint8_t windowSize, activePtr;
   uint16_t last_seq_nr;
   uint16_t missed_hellos;
+  uint32_t received_sum, total_sum;   /* sums over the first windowSize slots */
   uint16_t received[LQ_FF_WINDOW], total[LQ_FF_WINDOW];
 };
 
-extern struct lq_handler lq_etx_ff_handler;
+extern LQ_HANDLER_CONST struct lq_handler lq_etx_ff_handler;
 
 #endif /* LQ_ETX_FF_ */
 
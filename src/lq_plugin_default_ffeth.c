@@ -77,7 +77,7 @@ static const char *default_lq_print_ffeth(void *ptr, char separator, struct lqte
 static const char *default_lq_print_cost_ffeth(olsr_linkcost cost, struct lqtextbuffer *buffer);
 
 /* etx lq plugin (freifunk fpm version) settings */
-struct lq_handler lq_etx_ffeth_handler = {
+LQ_HANDLER_CONST struct lq_handler lq_etx_ffeth_handler = {
   &default_lq_initialize_ffeth,
   &default_lq_calc_cost_ffeth,
   &default_lq_calc_cost_ffeth,
@@ -167,6 +167,26 @@ default_lq_ffeth_handle_lqchange(void) {
   olsr_relevant_linkcost_change();
 }
 
+/* add a window slot to the running sums */
+static void
+default_lq_ffeth_sum_slot(struct default_lq_ffeth_hello *lq, int slot)
+{
+  if (slot < lq->windowSize) {
+    lq->received_sum += lq->received[slot];
+    lq->total_sum += lq->total[slot];
+  }
+}
+
+/* remove a window slot from the running sums */
+static void
+default_lq_ffeth_unsum_slot(struct default_lq_ffeth_hello *lq, int slot)
+{
+  if (slot < lq->windowSize) {
+    lq->received_sum -= lq->received[slot];
+    lq->total_sum -= lq->total[slot];
+  }
+}
+
 static void
 default_lq_parser_ffeth(struct olsr *olsr, struct interface *in_if, union olsr_ip_addr *from_addr)
 {
@@ -205,8 +225,10 @@ default_lq_parser_ffeth(struct olsr *olsr, struct interface *in_if, union olsr_i
     seq_diff = 1;
   }
 
+  default_lq_ffeth_unsum_slot(lq, lq->activePtr);
   lq->received[lq->activePtr]++;
   lq->total[lq->activePtr] += seq_diff;
+  default_lq_ffeth_sum_slot(lq, lq->activePtr);
 
   lq->last_seq_nr = olsr->olsr_seqno;
   lq->missed_hellos = 0;
@@ -220,19 +242,15 @@ default_lq_ffeth_timer(void __attribute__ ((unused)) * context)
   OLSR_FOR_ALL_LINK_ENTRIES(link) {
     struct default_lq_ffeth_hello *tlq = (struct default_lq_ffeth_hello *)link->linkquality;
     fpm ratio;
-    int i, received, total;
-
-    received = 0;
-    total = 0;
+    int received, total;
 
     /* enlarge window if still in quickstart phase */
     if (tlq->windowSize < LQ_FFETH_WINDOW) {
       tlq->windowSize++;
+      default_lq_ffeth_sum_slot(tlq, tlq->windowSize - 1);
     }
-    for (i = 0; i < tlq->windowSize; i++) {
-      received += tlq->received[i];
-      total += tlq->total[i];
-    }
+    received = tlq->received_sum;
+    total = tlq->total_sum;
 
     /* calculate link quality */
     if (total == 0) {
@@ -243,7 +261,10 @@ default_lq_ffeth_timer(void __attribute__ ((unused)) * context)
 
       /* keep missed hello periods in mind (round up hello interval to seconds) */
       if (tlq->missed_hellos > 1) {
-        received = received - received * tlq->missed_hellos * link->inter->hello_etime/1000 / LQ_FFETH_WINDOW;
+        /* stretched HELLO intervals can miss more than the whole window */
+        const uint64_t missed = (uint64_t)tlq->missed_hellos * link->loss_helloint / 1000;
+
+        received = missed >= LQ_FFETH_WINDOW ? 0 : received - received * (int)missed / LQ_FFETH_WINDOW;
       }
 
       // calculate received/total factor
@@ -273,6 +294,7 @@ default_lq_ffeth_timer(void __attribute__ ((unused)) * context)
 
     // shift buffer
     tlq->activePtr = (tlq->activePtr + 1) % LQ_FFETH_WINDOW;
+    default_lq_ffeth_unsum_slot(tlq, tlq->activePtr);
     tlq->total[tlq->activePtr] = 0;
     tlq->received[tlq->activePtr] = 0;
   } OLSR_FOR_ALL_LINK_ENTRIES_END(link);
@@ -431,6 +453,11 @@ default_lq_clear_ffeth_hello(void *target)
   for (i = 0; i < LQ_FFETH_WINDOW; i++) {
     local->total[i] = 3;
   }
+  local->received_sum = 0;
+  local->total_sum = 0;
+  for (i = 0; i < local->windowSize; i++) {
+    default_lq_ffeth_sum_slot(local, i);
+  }
 }
 
 static const char *
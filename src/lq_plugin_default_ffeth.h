@@ -61,11 +61,12 @@ struct default_lq_ffeth_hello {
   uint8_t windowSize, activePtr;
   uint16_t last_seq_nr;
   uint16_t missed_hellos;
+  uint32_t received_sum, total_sum;   /* sums over the first windowSize slots */
   bool perfect_eth;
   uint16_t received[LQ_FFETH_WINDOW], total[LQ_FFETH_WINDOW];
 };
 
-extern struct lq_handler lq_etx_ffeth_handler;
+extern LQ_HANDLER_CONST struct lq_handler lq_etx_ffeth_handler;
 
 #endif /* LQ_ETX_FFETH_ */
 
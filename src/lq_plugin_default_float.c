@@ -62,7 +62,7 @@ static const char *default_lq_print_cost_float(olsr_linkcost cost, struct lqtext
 
 
 /* Default lq plugin settings */
-struct lq_handler lq_etx_float_handler = {
+LQ_HANDLER_CONST struct lq_handler lq_etx_float_handler = {
   &default_lq_initialize_float,
 
   &default_lq_calc_cost_float,
@@ -54,7 +54,7 @@ struct default_lq_float {
   uint16_t quickstart;
 };
 
-extern struct lq_handler lq_etx_float_handler;
+extern LQ_HANDLER_CONST struct lq_handler lq_etx_float_handler;
 
 #endif /* LQ_PLUGIN_DEFAULT_H_ */
 
@@ -63,7 +63,7 @@ static const char *default_lq_print_cost_fpm(olsr_linkcost cost, struct lqtextbu
 
 
 /* etx lq plugin (fpm version) settings */
-struct lq_handler lq_etx_fpm_handler = {
+LQ_HANDLER_CONST struct lq_handler lq_etx_fpm_handler = {
   &default_lq_initialize_fpm,
 
   &default_lq_calc_cost_fpm,
@@ -58,7 +58,7 @@ struct default_lq_fpm {
   uint16_t quickstart;
 };
 
-extern struct lq_handler lq_etx_fpm_handler;
+extern LQ_HANDLER_CONST struct lq_handler lq_etx_fpm_handler;
 
 #endif /* LQ_ETX_FPM_ */
 
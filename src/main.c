@@ -473,7 +473,7 @@ int main(int argc, char *argv[]) {
 #endif /* DEFAULT_LOCKFILE_PREFIX */
     l = strlen(lock_file_name);
     snprintf(&lock_file_name[l], sizeof(lock_file_name) - l, "-ipv%d.lock",
-        olsr_cnf->ip_version == AF_INET ? 4 : 6);
+        OLSR_IP_VERSION == AF_INET ? 4 : 6);
   }
 
   /*
@@ -488,7 +488,7 @@ int main(int argc, char *argv[]) {
   /*
    * socket for ioctl calls
    */
-  olsr_cnf->ioctl_s = socket(olsr_cnf->ip_version, SOCK_DGRAM, 0);
+  olsr_cnf->ioctl_s = socket(OLSR_IP_VERSION, SOCK_DGRAM, 0);
   if (olsr_cnf->ioctl_s < 0) {
 #ifndef _WIN32
     olsr_syslog(OLSR_LOG_ERR, "ioctl socket: %m");
@@ -506,7 +506,9 @@ int main(int argc, char *argv[]) {
     olsr_syslog(OLSR_LOG_INFO, "rtnetlink could not be set to nonblocking");
   }
 
-  if ((olsr_cnf->rt_monitor_socket = rtnetlink_register_socket(RTMGRP_LINK)) < 0) {
+  if ((olsr_cnf->rt_monitor_socket = rtnetlink_register_socket(RTMGRP_LINK
+      | (OLSR_IP_VERSION == AF_INET ? RTMGRP_IPV4_IFADDR : RTMGRP_IPV6_IFADDR)
+      | (olsr_cnf->link_fail_detection ? RTMGRP_NEIGH : 0))) < 0) {
     olsr_syslog(OLSR_LOG_ERR, "rtmonitor socket: %m");
     olsr_exit(__func__, 0);
   }
@@ -655,22 +657,22 @@ int main(int argc, char *argv[]) {
 #ifdef __linux__
   /* create policy routing rules with priorities if necessary */
   if (DEF_RT_NONE != olsr_cnf->rt_table_pri) {
-    olsr_os_policy_rule(olsr_cnf->ip_version,
+    olsr_os_policy_rule(OLSR_IP_VERSION,
         olsr_cnf->rt_table, olsr_cnf->rt_table_pri, NULL, true);
   }
   if (DEF_RT_NONE != olsr_cnf->rt_table_tunnel_pri) {
-    olsr_os_policy_rule(olsr_cnf->ip_version,
+    olsr_os_policy_rule(OLSR_IP_VERSION,
         olsr_cnf->rt_table_tunnel, olsr_cnf->rt_table_tunnel_pri, NULL, true);
   }
   if (DEF_RT_NONE != olsr_cnf->rt_table_default_pri) {
-    olsr_os_policy_rule(olsr_cnf->ip_version,
+    olsr_os_policy_rule(OLSR_IP_VERSION,
         olsr_cnf->rt_table_default, olsr_cnf->rt_table_default_pri, NULL, true);
   }
 
   /* rule to default table on all olsrd interfaces */
   if (DEF_RT_NONE != olsr_cnf->rt_table_defaultolsr_pri) {
     for (ifn = ifnet; ifn; ifn = ifn->int_next) {
-      olsr_os_policy_rule(olsr_cnf->ip_version,
+      olsr_os_policy_rule(OLSR_IP_VERSION,
           olsr_cnf->rt_table_default, olsr_cnf->rt_table_defaultolsr_pri, ifn->int_name, true);
     }
   }
@@ -823,11 +825,8 @@ static void olsr_shutdown(int signo __attribute__ ((unused)))
   /* clear all links and send empty hellos/tcs */
   olsr_reset_all_links();
 
-  /* deactivate fisheye and immediate TCs */
+  /* deactivate fisheye */
   olsr_cnf->lq_fish = 0;
-  for (ifn = ifnet; ifn; ifn = ifn->int_next) {
-    ifn->immediate_send_tc = false;
-  }
   increase_local_ansn();
 
   /* send first shutdown message burst */
@@ -878,7 +877,7 @@ static void olsr_shutdown(int signo __attribute__ ((unused)))
 
 #ifdef __linux__
     if (DEF_RT_NONE != olsr_cnf->rt_table_defaultolsr_pri) {
-      olsr_os_policy_rule(olsr_cnf->ip_version, olsr_cnf->rt_table_default,
+      olsr_os_policy_rule(OLSR_IP_VERSION, olsr_cnf->rt_table_default,
           olsr_cnf->rt_table_defaultolsr_pri, ifn->int_name, false);
     }
 #endif /* __linux__ */
@@ -895,15 +894,15 @@ static void olsr_shutdown(int signo __attribute__ ((unused)))
 
 #ifdef __linux__
   if (DEF_RT_NONE != olsr_cnf->rt_table_pri) {
-    olsr_os_policy_rule(olsr_cnf->ip_version,
+    olsr_os_policy_rule(OLSR_IP_VERSION,
         olsr_cnf->rt_table, olsr_cnf->rt_table_pri, NULL, false);
   }
   if (DEF_RT_NONE != olsr_cnf->rt_table_tunnel_pri) {
-    olsr_os_policy_rule(olsr_cnf->ip_version,
+    olsr_os_policy_rule(OLSR_IP_VERSION,
         olsr_cnf->rt_table_tunnel, olsr_cnf->rt_table_tunnel_pri, NULL, false);
   }
   if (DEF_RT_NONE != olsr_cnf->rt_table_default_pri) {
-    olsr_os_policy_rule(olsr_cnf->ip_version,
+    olsr_os_policy_rule(OLSR_IP_VERSION,
         olsr_cnf->rt_table_default, olsr_cnf->rt_table_default_pri, NULL, false);
   }
   close(olsr_cnf->rtnl_s);
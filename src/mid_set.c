@@ -49,14 +49,19 @@
 #include "scheduler.h"
 #include "neighbor_table.h"
 #include "link_set.h"
+#include "lq_mpr.h"
 #include "tc_set.h"
 #include "packet.h"             /* struct mid_alias */
 #include "net_olsr.h"
 #include "duplicate_handler.h"
+#include "olsr_cookie.h"
 
 struct mid_entry mid_set[HASHSIZE];
 struct mid_address reverse_mid_set[HASHSIZE];
 
+struct olsr_cookie_info *mid_mem_cookie = NULL;
+struct olsr_cookie_info *mid_address_mem_cookie = NULL;
+
 struct mid_entry *mid_lookup_entry_bymain(const union olsr_ip_addr *adr);
 
 /**
@@ -70,6 +75,13 @@ olsr_init_mid_set(void)
 
   OLSR_PRINTF(5, "MID: init\n");
 
+  mid_mem_cookie = olsr_alloc_cookie("mid_entry", OLSR_COOKIE_TYPE_MEMORY);
+  olsr_cookie_set_memory_size(mid_mem_cookie, sizeof(struct mid_entry));
+
+  mid_address_mem_cookie = olsr_alloc_cookie("mid_address", OLSR_COOKIE_TYPE_MEMORY);
+  olsr_cookie_set_memory_size(mid_address_mem_cookie, sizeof(struct mid_address));
+  olsr_cookie_set_budget(mid_address_mem_cookie, olsr_cnf->max_mid_entries);
+
   for (idx = 0; idx < HASHSIZE; idx++) {
     mid_set[idx].next = &mid_set[idx];
     mid_set[idx].prev = &mid_set[idx];
@@ -188,7 +200,7 @@ insert_mid_tuple(union olsr_ip_addr *m_addr, struct mid_address *alias, olsr_rel
   } else {
 
     /*Create new node */
-    tmp = olsr_malloc(sizeof(struct mid_entry), "MID new alias");
+    tmp = olsr_cookie_malloc(mid_mem_cookie);
 
     tmp->aliases = alias;
     alias->main_entry = tmp;
@@ -234,10 +246,8 @@ insert_mid_tuple(union olsr_ip_addr *m_addr, struct mid_address *alias, olsr_rel
 
       replace_neighbor_link_set(tmp_neigh, real_neigh);
 
-      /* Dequeue */
-      DEQUEUE_ELEM(tmp_neigh);
-      /* Delete */
-      free(tmp_neigh);
+      /* Delete, including its two hop list */
+      olsr_delete_neighbor_table(&tmp_neigh->neighbor_main_addr);
 
       changes_neighborhood = true;
     }
@@ -266,10 +276,19 @@ insert_mid_alias(union olsr_ip_addr *main_add, const union olsr_ip_addr *alias,
   if (!olsr_validate_address(alias))
     return;
 
+  /*
+   * Refuse new aliases beyond the budget.
+   */
+  if (olsr_cookie_budget_exhausted(mid_address_mem_cookie)) {
+    mid_address_mem_cookie->ci_refused++;
+    OLSR_PRINTF(2, "MID: no room for alias %s\n", olsr_ip_to_string(&buf1, alias));
+    return;
+  }
+
   OLSR_PRINTF(1, "Inserting alias %s for ", olsr_ip_to_string(&buf1, alias));
   OLSR_PRINTF(1, "%s\n", olsr_ip_to_string(&buf1, main_add));
 
-  adr = olsr_malloc(sizeof(struct mid_address), "Insert MID alias");
+  adr = olsr_cookie_malloc(mid_address_mem_cookie);
 
   adr->alias = *alias;
   adr->next_alias = NULL;
@@ -305,7 +324,7 @@ insert_mid_alias(union olsr_ip_addr *main_add, const union olsr_ip_addr *alias,
   }
 
   if (!insert_mid_tuple(main_add, adr, vtime)) {
-    free(adr);
+    olsr_cookie_free(mid_address_mem_cookie, adr);
   }
 
   /*
@@ -472,7 +491,10 @@ olsr_prune_aliases(struct mid_message *message)
        */
       olsr_delete_routing_table(&current_alias->alias, olsr_cnf->maxplen, &entry->main_addr);
 
-      free(current_alias);
+      /* a two hop neighbor on the alias is no longer this node */
+      olsr_lq_mpr_touch_address(&current_alias->alias);
+
+      olsr_cookie_free(mid_address_mem_cookie, current_alias);
 
       /*
        *Recalculate topology
@@ -507,7 +529,9 @@ olsr_delete_mid_entry(struct mid_entry *mid)
      */
     olsr_delete_routing_table(&tmp_aliases->alias, olsr_cnf->maxplen, &mid->main_addr);
 
-    free(tmp_aliases);
+    olsr_lq_mpr_touch_address(&tmp_aliases->alias);
+
+    olsr_cookie_free(mid_address_mem_cookie, tmp_aliases);
   }
 
   /*
@@ -520,7 +544,7 @@ olsr_delete_mid_entry(struct mid_entry *mid)
 
   /* Dequeue */
   DEQUEUE_ELEM(mid);
-  free(mid);
+  olsr_cookie_free(mid_mem_cookie, mid);
 }
 
 /**
@@ -567,7 +591,10 @@ olsr_input_mid(union olsr_message *m, struct interface *in_if __attribute__ ((un
   struct mid_alias *tmp_adr;
   struct mid_message message;
 
-  mid_chgestruct(&message, m);
+  if (!mid_chgestruct(&message, m)) {
+    olsr_free_mid_packet(&message);
+    return false;
+  }
 
   if (!olsr_validate_address(&message.mid_origaddr)) {
     olsr_free_mid_packet(&message);
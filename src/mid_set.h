@@ -46,6 +46,7 @@
 #include "hashing.h"
 #include "mantissa.h"
 #include "packet.h"
+#include "olsr_cookie.h"
 
 struct mid_address {
   union olsr_ip_addr alias;
@@ -73,6 +74,8 @@ struct mid_entry {
 
 extern struct mid_entry mid_set[HASHSIZE];
 extern struct mid_address reverse_mid_set[HASHSIZE];
+extern struct olsr_cookie_info *mid_mem_cookie;
+extern struct olsr_cookie_info *mid_address_mem_cookie;
 
 int olsr_init_mid_set(void);
 void olsr_delete_all_mid_entries(void);
@@ -48,6 +48,31 @@
 #include "scheduler.h"
 #include "net_olsr.h"
 
+/*
+ * Every two hop neighbor has an index and every one hop neighbor
+ * a bitset of the indexes it reaches. The bitsets follow the two
+ * hop lists as they change, so the MPR calculation does not have
+ * to walk the lists.
+ */
+static struct neighbor_2_entry **mpr_two_hop;   /* two hop neighbors by index */
+static uint32_t mpr_index_count;                /* indexes handed out so far */
+static uint32_t *mpr_free_index;                /* released indexes */
+static uint32_t mpr_free_count;
+static uint32_t mpr_words;                      /* 64 bit words of a bitset */
+
+/* State of the running calculation */
+static struct neighbor_entry **mpr_nbrs;        /* neighbors in table order */
+static unsigned int mpr_nbr_count;
+static uint64_t *mpr_excluded;                  /* two hop neighbors which are symmetric neighbors */
+static uint64_t *mpr_scratch;
+static uint8_t *mpr_covered;                    /* MPRs covering each two hop neighbor */
+
+static inline unsigned int
+mpr_popcount(uint64_t bits)
+{
+  return __builtin_popcountll(bits);
+}
+
 /* Begin:
  * Prototypes for internal functions
  */
@@ -58,8 +83,6 @@ static void olsr_optimize_mpr_set(void);
 
 static void olsr_clear_mprs(void);
 
-static void olsr_clear_two_hop_processed(void);
-
 static struct neighbor_entry *olsr_find_maximum_covered(int);
 
 static uint16_t olsr_calculate_two_hop_neighbors(void);
@@ -68,69 +91,183 @@ static int olsr_check_mpr_changes(void);
 
 static int olsr_chosen_mpr(struct neighbor_entry *, uint16_t *);
 
-static struct neighbor_2_list_entry *olsr_find_2_hop_neighbors_with_1_link(int);
+static void olsr_chose_2_hop_neighbors_with_1_link(int, uint16_t *);
 
 /* End:
  * Prototypes for internal functions
  */
 
 /**
- *Find all 2 hop neighbors with 1 link
- *connecting them to us trough neighbors
- *with a given willingness.
- *
- *@param willingness the willigness of the neighbors
- *
- *@return a linked list of allocated neighbor_2_list_entry structures
+ *Double the size of the bitsets.
  */
-static struct neighbor_2_list_entry *
-olsr_find_2_hop_neighbors_with_1_link(int willingness)
+static void
+olsr_grow_mpr_index(void)
 {
+  const uint32_t words = mpr_words ? 2 * mpr_words : 1;
+  struct neighbor_2_entry **two_hop;
+  struct neighbor_entry *a_neighbor;
+  uint32_t *free_index;
+  uint64_t *reach;
+
+  two_hop = olsr_malloc(words * 64 * sizeof(*two_hop), "MPR two hop index");
+  free_index = olsr_malloc(words * 64 * sizeof(*free_index), "MPR free index");
+  if (mpr_words) {
+    memcpy(two_hop, mpr_two_hop, mpr_words * 64 * sizeof(*two_hop));
+    memcpy(free_index, mpr_free_index, mpr_free_count * sizeof(*free_index));
+  }
+  free(mpr_two_hop);
+  free(mpr_free_index);
+  mpr_two_hop = two_hop;
+  mpr_free_index = free_index;
 
-  uint8_t idx;
-  struct neighbor_2_list_entry *two_hop_list_tmp = NULL;
-  struct neighbor_2_list_entry *two_hop_list = NULL;
-  struct neighbor_entry *dup_neighbor;
-  struct neighbor_2_entry *two_hop_neighbor = NULL;
+  OLSR_FOR_ALL_NBR_ENTRIES(a_neighbor) {
+    if (a_neighbor->mpr_reach) {
+      reach = olsr_malloc(words * sizeof(*reach), "MPR reach set");
+      memcpy(reach, a_neighbor->mpr_reach, mpr_words * sizeof(*reach));
+      free(a_neighbor->mpr_reach);
+      a_neighbor->mpr_reach = reach;
+    }
+  }
+  OLSR_FOR_ALL_NBR_ENTRIES_END(a_neighbor);
 
-  for (idx = 0; idx < HASHSIZE; idx++) {
+  mpr_words = words;
+}
 
-    for (two_hop_neighbor = two_hop_neighbortable[idx].next; two_hop_neighbor != &two_hop_neighbortable[idx];
-         two_hop_neighbor = two_hop_neighbor->next) {
+/**
+ *Give a new two hop neighbor an index.
+ */
+void
+olsr_mpr_add_two_hop(struct neighbor_2_entry *two_hop_neighbor)
+{
+  uint32_t idx;
 
-      //two_hop_neighbor->neighbor_2_state=0;
-      //two_hop_neighbor->mpr_covered_count = 0;
+  if (mpr_free_count > 0) {
+    idx = mpr_free_index[--mpr_free_count];
+  } else {
+    if (mpr_index_count == mpr_words * 64) {
+      olsr_grow_mpr_index();
+    }
+    idx = mpr_index_count++;
+  }
 
-      dup_neighbor = olsr_lookup_neighbor_table(&two_hop_neighbor->neighbor_2_addr);
+  two_hop_neighbor->mpr_index = idx;
+  mpr_two_hop[idx] = two_hop_neighbor;
+}
 
-      if ((dup_neighbor != NULL) && (dup_neighbor->status != NOT_SYM)) {
+/**
+ *Release the index of a two hop neighbor which is about to be freed.
+ */
+void
+olsr_mpr_del_two_hop(struct neighbor_2_entry *two_hop_neighbor)
+{
+  const uint32_t idx = two_hop_neighbor->mpr_index;
+  struct neighbor_entry *a_neighbor;
 
-        //OLSR_PRINTF(1, "(1)Skipping 2h neighbor %s - already 1hop\n", olsr_ip_to_string(&buf, &two_hop_neighbor->neighbor_2_addr));
+  if (idx >= mpr_index_count || mpr_two_hop[idx] != two_hop_neighbor) {
+    return;
+  }
 
-        continue;
-      }
+  /* the index may be handed out again */
+  OLSR_FOR_ALL_NBR_ENTRIES(a_neighbor) {
+    if (a_neighbor->mpr_reach) {
+      a_neighbor->mpr_reach[idx / 64] &= ~(1ULL << (idx % 64));
+    }
+  }
+  OLSR_FOR_ALL_NBR_ENTRIES_END(a_neighbor);
 
-      if (two_hop_neighbor->neighbor_2_pointer == 1) {
-        if ((two_hop_neighbor->neighbor_2_nblist.next->neighbor->willingness == willingness)
-            && (two_hop_neighbor->neighbor_2_nblist.next->neighbor->status == SYM)) {
-          two_hop_list_tmp = olsr_malloc(sizeof(struct neighbor_2_list_entry), "MPR two hop list");
+  mpr_two_hop[idx] = NULL;
+  mpr_free_index[mpr_free_count++] = idx;
+}
 
-          //OLSR_PRINTF(1, "ONE LINK ADDING %s\n", olsr_ip_to_string(&buf, &two_hop_neighbor->neighbor_2_addr));
+/**
+ *A two hop neighbor was added to the two hop list of a neighbor.
+ */
+void
+olsr_mpr_link_two_hop(struct neighbor_entry *neighbor, const struct neighbor_2_entry *two_hop_neighbor)
+{
+  const uint32_t idx = two_hop_neighbor->mpr_index;
 
-          /* Only queue one way here */
-          two_hop_list_tmp->neighbor_2 = two_hop_neighbor;
+  if (neighbor->mpr_reach == NULL) {
+    neighbor->mpr_reach = olsr_malloc(mpr_words * sizeof(*neighbor->mpr_reach), "MPR reach set");
+  }
+  neighbor->mpr_reach[idx / 64] |= 1ULL << (idx % 64);
+}
 
-          two_hop_list_tmp->next = two_hop_list;
+/**
+ *A two hop neighbor was removed from the two hop list of a neighbor.
+ */
+void
+olsr_mpr_unlink_two_hop(struct neighbor_entry *neighbor, const struct neighbor_2_entry *two_hop_neighbor)
+{
+  const uint32_t idx = two_hop_neighbor->mpr_index;
 
-          two_hop_list = two_hop_list_tmp;
-        }
-      }
+  if (neighbor->mpr_reach && idx < mpr_index_count) {
+    neighbor->mpr_reach[idx / 64] &= ~(1ULL << (idx % 64));
+  }
+}
 
-    }
+/**
+ *Free the bitset of a neighbor which is about to be freed.
+ */
+void
+olsr_mpr_del_neighbor(struct neighbor_entry *neighbor)
+{
+  free(neighbor->mpr_reach);
+  neighbor->mpr_reach = NULL;
+}
 
+/**
+ *Count the two hop neighbors of a neighbor which are not
+ *symmetric neighbors themselves and are in a given set.
+ *
+ *@param neighbor the neighbor
+ *@param set the set or NULL for all two hop neighbors
+ */
+static unsigned int
+olsr_count_reach(const struct neighbor_entry *neighbor, const uint64_t *set)
+{
+  unsigned int count = 0;
+  uint32_t w;
+
+  if (neighbor->mpr_reach == NULL) {
+    return 0;
   }
 
-  return (two_hop_list_tmp);
+  for (w = 0; w < mpr_words; w++) {
+    count += mpr_popcount(neighbor->mpr_reach[w] & ~mpr_excluded[w] & (set ? set[w] : ~0ULL));
+  }
+  return count;
+}
+
+/**
+ *Choose the neighbors which are the only link to a two hop
+ *neighbor and have a given willingness.
+ *
+ *@param willingness the willigness of the neighbors
+ *@param two_hop_covered_count the counter of covered two hop neighbors
+ */
+static void
+olsr_chose_2_hop_neighbors_with_1_link(int willingness, uint16_t * two_hop_covered_count)
+{
+  struct neighbor_2_entry *two_hop_neighbor;
+  struct neighbor_entry *neighbor;
+  uint32_t idx;
+
+  for (idx = 0; idx < mpr_index_count; idx++) {
+    two_hop_neighbor = mpr_two_hop[idx];
+
+    if (two_hop_neighbor == NULL || (mpr_excluded[idx / 64] & (1ULL << (idx % 64))) != 0) {
+      continue;
+    }
+
+    if (two_hop_neighbor->neighbor_2_pointer == 1) {
+      neighbor = two_hop_neighbor->neighbor_2_nblist.next->neighbor;
+
+      if (neighbor->willingness == willingness && neighbor->status == SYM && !neighbor->is_mpr) {
+        olsr_chosen_mpr(neighbor, two_hop_covered_count);
+      }
+    }
+  }
 }
 
 /**
@@ -140,55 +277,48 @@ olsr_find_2_hop_neighbors_with_1_link(int willingness)
 static int
 olsr_chosen_mpr(struct neighbor_entry *one_hop_neighbor, uint16_t * two_hop_covered_count)
 {
-  struct neighbor_list_entry *the_one_hop_list;
-  struct neighbor_2_list_entry *second_hop_entries;
-  struct neighbor_entry *dup_neighbor;
+  uint64_t *saturated = mpr_scratch;
   uint16_t count;
+  bool any = false;
+  unsigned int i;
+  uint32_t w;
   struct ipaddr_str buf;
   count = *two_hop_covered_count;
 
   OLSR_PRINTF(1, "Setting %s as MPR\n", olsr_ip_to_string(&buf, &one_hop_neighbor->neighbor_main_addr));
 
-  //printf("PRE COUNT: %d\n\n", count);
-
   one_hop_neighbor->is_mpr = true;      //NBS_MPR;
 
-  for (second_hop_entries = one_hop_neighbor->neighbor_2_list.next; second_hop_entries != &one_hop_neighbor->neighbor_2_list;
-       second_hop_entries = second_hop_entries->next) {
-    dup_neighbor = olsr_lookup_neighbor_table(&second_hop_entries->neighbor_2->neighbor_2_addr);
-
-    if ((dup_neighbor != NULL) && (dup_neighbor->status == SYM)) {
-      //OLSR_PRINTF(7, "(2)Skipping 2h neighbor %s - already 1hop\n", olsr_ip_to_string(&buf, &second_hop_entries->neighbor_2->neighbor_2_addr));
-      continue;
-    }
-    //      if(!second_hop_entries->neighbor_2->neighbor_2_state)
-    //if(second_hop_entries->neighbor_2->mpr_covered_count < olsr_cnf->mpr_coverage)
-    //{
-    /*
-       Now the neighbor is covered by this mpr
-     */
-    second_hop_entries->neighbor_2->mpr_covered_count++;
-    the_one_hop_list = second_hop_entries->neighbor_2->neighbor_2_nblist.next;
-
-    //OLSR_PRINTF(1, "[%s](%x) has coverage %d\n", olsr_ip_to_string(&buf, &second_hop_entries->neighbor_2->neighbor_2_addr), second_hop_entries->neighbor_2, second_hop_entries->neighbor_2->mpr_covered_count);
+  if (one_hop_neighbor->mpr_reach == NULL) {
+    return count;
+  }
 
-    if (second_hop_entries->neighbor_2->mpr_covered_count >= olsr_cnf->mpr_coverage)
-      count++;
+  /* Now the two hop neighbors are covered by this mpr */
+  for (w = 0; w < mpr_words; w++) {
+    uint64_t bits = one_hop_neighbor->mpr_reach[w] & ~mpr_excluded[w];
 
-    while (the_one_hop_list != &second_hop_entries->neighbor_2->neighbor_2_nblist) {
+    saturated[w] = 0;
+    while (bits) {
+      const unsigned int bit = __builtin_ctzll(bits);
+      const uint32_t idx = w * 64 + bit;
 
-      if ((the_one_hop_list->neighbor->status == SYM)) {
-        if (second_hop_entries->neighbor_2->mpr_covered_count >= olsr_cnf->mpr_coverage) {
-          the_one_hop_list->neighbor->neighbor_2_nocov--;
-        }
+      if (++mpr_covered[idx] >= olsr_cnf->mpr_coverage) {
+        count++;
+        saturated[w] |= 1ULL << bit;
+        any = true;
       }
-      the_one_hop_list = the_one_hop_list->next;
+      bits &= bits - 1;
     }
-
-    //}
   }
 
-  //printf("POST COUNT %d\n\n", count);
+  /* The covered two hop neighbors do not count for the other neighbors anymore */
+  if (any) {
+    for (i = 0; i < mpr_nbr_count; i++) {
+      if (mpr_nbrs[i]->status == SYM) {
+        mpr_nbrs[i]->neighbor_2_nocov -= olsr_count_reach(mpr_nbrs[i], saturated);
+      }
+    }
+  }
 
   *two_hop_covered_count = count;
   return count;
@@ -209,15 +339,12 @@ olsr_find_maximum_covered(int willingness)
   uint16_t maximum;
   struct neighbor_entry *a_neighbor;
   struct neighbor_entry *mpr_candidate = NULL;
+  unsigned int i;
 
   maximum = 0;
 
-  OLSR_FOR_ALL_NBR_ENTRIES(a_neighbor) {
-
-#if 0
-    printf("[%s] nocov: %d mpr: %d will: %d max: %d\n\n", olsr_ip_to_string(&buf, &a_neighbor->neighbor_main_addr),
-           a_neighbor->neighbor_2_nocov, a_neighbor->is_mpr, a_neighbor->willingness, maximum);
-#endif /* 0 */
+  for (i = 0; i < mpr_nbr_count; i++) {
+    a_neighbor = mpr_nbrs[i];
 
     if ((!a_neighbor->is_mpr) && (a_neighbor->willingness == willingness) && (maximum < a_neighbor->neighbor_2_nocov)) {
 
@@ -225,20 +352,33 @@ olsr_find_maximum_covered(int willingness)
       mpr_candidate = a_neighbor;
     }
   }
-  OLSR_FOR_ALL_NBR_ENTRIES_END(a_neighbor);
 
   return mpr_candidate;
 }
 
 /**
- *Remove all MPR registrations
+ *Remove all MPR registrations and set up the state
+ *of the calculation.
  */
 static void
 olsr_clear_mprs(void)
 {
   struct neighbor_entry *a_neighbor;
-  struct neighbor_2_list_entry *two_hop_list;
+  struct neighbor_entry *dup_neighbor;
+  uint32_t idx;
+
+  mpr_nbr_count = 0;
+  OLSR_FOR_ALL_NBR_ENTRIES(a_neighbor) {
+    mpr_nbr_count++;
+  }
+  OLSR_FOR_ALL_NBR_ENTRIES_END(a_neighbor);
+
+  mpr_nbrs = olsr_malloc((mpr_nbr_count + 1) * sizeof(*mpr_nbrs), "MPR neighbors");
+  mpr_excluded = olsr_malloc((mpr_words + 1) * sizeof(*mpr_excluded), "MPR excluded set");
+  mpr_scratch = olsr_malloc((mpr_words + 1) * sizeof(*mpr_scratch), "MPR scratch set");
+  mpr_covered = olsr_malloc(mpr_words * 64 + 1, "MPR coverage");
 
+  mpr_nbr_count = 0;
   OLSR_FOR_ALL_NBR_ENTRIES(a_neighbor) {
 
     /* Clear MPR selection. */
@@ -246,15 +386,20 @@ olsr_clear_mprs(void)
       a_neighbor->was_mpr = true;
       a_neighbor->is_mpr = false;
     }
+    mpr_nbrs[mpr_nbr_count++] = a_neighbor;
+  }
+  OLSR_FOR_ALL_NBR_ENTRIES_END(a_neighbor);
 
-    /* Clear two hop neighbors coverage count/ */
-    for (two_hop_list = a_neighbor->neighbor_2_list.next; two_hop_list != &a_neighbor->neighbor_2_list;
-         two_hop_list = two_hop_list->next) {
-      two_hop_list->neighbor_2->mpr_covered_count = 0;
+  /* Two hop neighbors which are symmetric neighbors do not need to be covered */
+  for (idx = 0; idx < mpr_index_count; idx++) {
+    if (mpr_two_hop[idx] == NULL) {
+      continue;
+    }
+    dup_neighbor = olsr_lookup_neighbor_table(&mpr_two_hop[idx]->neighbor_2_addr);
+    if (dup_neighbor != NULL && dup_neighbor->status == SYM) {
+      mpr_excluded[idx / 64] |= 1ULL << (idx % 64);
     }
-
   }
-  OLSR_FOR_ALL_NBR_ENTRIES_END(a_neighbor);
 }
 
 /**
@@ -277,7 +422,10 @@ olsr_check_mpr_changes(void)
 
       if (!a_neighbor->is_mpr) {
         retval = 1;
+        olsr_hello_churn();
       }
+    } else if (a_neighbor->is_mpr) {
+      olsr_hello_churn();
     }
   }
   OLSR_FOR_ALL_NBR_ENTRIES_END(a_neighbor);
@@ -285,58 +433,37 @@ olsr_check_mpr_changes(void)
   return retval;
 }
 
-/**
- *Clears out proccess registration
- *on two hop neighbors
- */
-static void
-olsr_clear_two_hop_processed(void)
-{
-  int idx;
-
-  for (idx = 0; idx < HASHSIZE; idx++) {
-    struct neighbor_2_entry *neighbor_2;
-    for (neighbor_2 = two_hop_neighbortable[idx].next; neighbor_2 != &two_hop_neighbortable[idx]; neighbor_2 = neighbor_2->next) {
-      /* Clear */
-      neighbor_2->processed = 0;
-    }
-  }
-
-}
-
 /**
  *This function calculates the number of two hop neighbors
  */
 static uint16_t
 olsr_calculate_two_hop_neighbors(void)
 {
-  struct neighbor_entry *a_neighbor, *dup_neighbor;
-  struct neighbor_2_list_entry *twohop_neighbors;
+  struct neighbor_entry *a_neighbor;
+  uint64_t *seen = mpr_scratch;
   uint16_t count = 0;
   uint16_t n_count = 0;
   uint16_t sum = 0;
+  unsigned int i;
+  uint32_t w;
 
-  /* Clear 2 hop neighs */
-  olsr_clear_two_hop_processed();
+  memset(seen, 0, mpr_words * sizeof(*seen));
 
-  OLSR_FOR_ALL_NBR_ENTRIES(a_neighbor) {
+  for (i = 0; i < mpr_nbr_count; i++) {
+    a_neighbor = mpr_nbrs[i];
 
     if (a_neighbor->status == NOT_SYM) {
       a_neighbor->neighbor_2_nocov = count;
       continue;
     }
 
-    for (twohop_neighbors = a_neighbor->neighbor_2_list.next; twohop_neighbors != &a_neighbor->neighbor_2_list;
-         twohop_neighbors = twohop_neighbors->next) {
-
-      dup_neighbor = olsr_lookup_neighbor_table(&twohop_neighbors->neighbor_2->neighbor_2_addr);
+    if (a_neighbor->mpr_reach) {
+      for (w = 0; w < mpr_words; w++) {
+        const uint64_t bits = a_neighbor->mpr_reach[w] & ~mpr_excluded[w];
 
-      if ((dup_neighbor == NULL) || (dup_neighbor->status != SYM)) {
-        n_count++;
-        if (!twohop_neighbors->neighbor_2->processed) {
-          count++;
-          twohop_neighbors->neighbor_2->processed = 1;
-        }
+        n_count += mpr_popcount(bits);
+        count += mpr_popcount(bits & ~seen[w]);
+        seen[w] |= bits;
       }
     }
     a_neighbor->neighbor_2_nocov = n_count;
@@ -345,7 +472,6 @@ olsr_calculate_two_hop_neighbors(void)
     sum += count;
 
   }
-  OLSR_FOR_ALL_NBR_ENTRIES_END(a_neighbor);
 
   OLSR_PRINTF(3, "Two hop neighbors: %d\n", sum);
   return sum;
@@ -359,13 +485,11 @@ add_will_always_nodes(void)
 {
   struct neighbor_entry *a_neighbor;
   uint16_t count = 0;
+  unsigned int i;
 
-#if 0
-  printf("\nAdding WILL ALWAYS nodes....\n");
-#endif /* 0 */
-
-  OLSR_FOR_ALL_NBR_ENTRIES(a_neighbor) {
+  for (i = 0; i < mpr_nbr_count; i++) {
     struct ipaddr_str buf;
+    a_neighbor = mpr_nbrs[i];
     if ((a_neighbor->status == NOT_SYM) || (a_neighbor->willingness != WILL_ALWAYS)) {
       continue;
     }
@@ -374,11 +498,7 @@ add_will_always_nodes(void)
     OLSR_PRINTF(3, "Adding WILL_ALWAYS: %s\n", olsr_ip_to_string(&buf, &a_neighbor->neighbor_main_addr));
 
   }
-  OLSR_FOR_ALL_NBR_ENTRIES_END(a_neighbor);
 
-#if 0
-  OLSR_PRINTF(1, "Count: %d\n", count);
-#endif /* 0 */
   return count;
 }
 
@@ -405,26 +525,15 @@ olsr_calculate_mpr(void)
 
   for (i = WILL_ALWAYS - 1; i > WILL_NEVER; i--) {
     struct neighbor_entry *mprs;
-    struct neighbor_2_list_entry *two_hop_list = olsr_find_2_hop_neighbors_with_1_link(i);
-
-    while (two_hop_list != NULL) {
-      struct neighbor_2_list_entry *tmp;
-      //printf("CHOSEN FROM 1 LINK\n");
-      if (!two_hop_list->neighbor_2->neighbor_2_nblist.next->neighbor->is_mpr)
-        olsr_chosen_mpr(two_hop_list->neighbor_2->neighbor_2_nblist.next->neighbor, &two_hop_covered_count);
-      tmp = two_hop_list;
-      two_hop_list = two_hop_list->next;;
-      free(tmp);
-    }
+
+    olsr_chose_2_hop_neighbors_with_1_link(i, &two_hop_covered_count);
 
     if (two_hop_covered_count >= two_hop_count) {
       i = WILL_NEVER;
       break;
     }
-    //printf("two hop covered count: %d\n", two_hop_covered_count);
 
     while ((mprs = olsr_find_maximum_covered(i)) != NULL) {
-      //printf("CHOSEN FROM MAXCOV\n");
       olsr_chosen_mpr(mprs, &two_hop_covered_count);
 
       if (two_hop_covered_count >= two_hop_count) {
@@ -435,14 +544,18 @@ olsr_calculate_mpr(void)
     }
   }
 
-  /*
-     increment the mpr sequence number
-   */
-  //neighbortable.neighbor_mpr_seq++;
-
   /* Optimize selection */
   olsr_optimize_mpr_set();
 
+  free(mpr_nbrs);
+  free(mpr_excluded);
+  free(mpr_scratch);
+  free(mpr_covered);
+  mpr_nbrs = NULL;
+  mpr_excluded = NULL;
+  mpr_scratch = NULL;
+  mpr_covered = NULL;
+
   if (olsr_check_mpr_changes()) {
     OLSR_PRINTF(3, "CHANGES IN MPR SET\n");
     if (olsr_cnf->tc_redundancy > 0)
@@ -463,47 +576,36 @@ olsr_calculate_mpr(void)
 static void
 olsr_optimize_mpr_set(void)
 {
-  struct neighbor_entry *a_neighbor, *dup_neighbor;
-  struct neighbor_2_list_entry *two_hop_list;
-  int i, removeit;
+  struct neighbor_entry *a_neighbor;
+  uint64_t *needed = mpr_scratch;
+  unsigned int n;
+  uint32_t idx;
+  int i;
 
-#if 0
-  printf("\n**MPR OPTIMIZING**\n\n");
-#endif /* 0 */
+  /* Two hop neighbors which need all of their MPRs */
+  memset(needed, 0, mpr_words * sizeof(*needed));
+  for (idx = 0; idx < mpr_index_count; idx++) {
+    if (mpr_covered[idx] <= olsr_cnf->mpr_coverage) {
+      needed[idx / 64] |= 1ULL << (idx % 64);
+    }
+  }
 
   for (i = WILL_NEVER + 1; i < WILL_ALWAYS; i++) {
 
-    OLSR_FOR_ALL_NBR_ENTRIES(a_neighbor) {
+    for (n = 0; n < mpr_nbr_count; n++) {
+      a_neighbor = mpr_nbrs[n];
 
       if (a_neighbor->willingness != i) {
         continue;
       }
 
-      if (a_neighbor->is_mpr) {
-        removeit = 1;
-
-        for (two_hop_list = a_neighbor->neighbor_2_list.next; two_hop_list != &a_neighbor->neighbor_2_list;
-             two_hop_list = two_hop_list->next) {
-
-          dup_neighbor = olsr_lookup_neighbor_table(&two_hop_list->neighbor_2->neighbor_2_addr);
-
-          if ((dup_neighbor != NULL) && (dup_neighbor->status != NOT_SYM)) {
-            continue;
-          }
-          //printf("\t[%s] coverage %d\n", olsr_ip_to_string(&buf, &two_hop_list->neighbor_2->neighbor_2_addr), two_hop_list->neighbor_2->mpr_covered_count);
-          /* Do not remove if we find a entry which need this MPR */
-          if (two_hop_list->neighbor_2->mpr_covered_count <= olsr_cnf->mpr_coverage) {
-            removeit = 0;
-          }
-        }
-
-        if (removeit) {
-          struct ipaddr_str buf;
-          OLSR_PRINTF(3, "MPR OPTIMIZE: removiong mpr %s\n\n", olsr_ip_to_string(&buf, &a_neighbor->neighbor_main_addr));
-          a_neighbor->is_mpr = false;
-        }
+      /* Do not remove if we find a entry which need this MPR */
+      if (a_neighbor->is_mpr && olsr_count_reach(a_neighbor, needed) == 0) {
+        struct ipaddr_str buf;
+        OLSR_PRINTF(3, "MPR OPTIMIZE: removiong mpr %s\n\n", olsr_ip_to_string(&buf, &a_neighbor->neighbor_main_addr));
+        a_neighbor->is_mpr = false;
       }
-    } OLSR_FOR_ALL_NBR_ENTRIES_END(a_neighbor);
+    }
   }
 }
 
@@ -42,8 +42,21 @@
 #ifndef _OLSR_MPR
 #define _OLSR_MPR
 
+struct neighbor_entry;
+struct neighbor_2_entry;
+
 void olsr_calculate_mpr(void);
 
+void olsr_mpr_add_two_hop(struct neighbor_2_entry *);
+
+void olsr_mpr_del_two_hop(struct neighbor_2_entry *);
+
+void olsr_mpr_link_two_hop(struct neighbor_entry *, const struct neighbor_2_entry *);
+
+void olsr_mpr_unlink_two_hop(struct neighbor_entry *, const struct neighbor_2_entry *);
+
+void olsr_mpr_del_neighbor(struct neighbor_entry *);
+
 #ifndef NODEBUG
 void olsr_print_mpr_set(void);
 #else
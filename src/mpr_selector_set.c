@@ -152,6 +152,7 @@ olsr_add_mpr_selector(const union olsr_ip_addr *addr, olsr_reltime vtime)
   olsr_set_mpr_sel_timer(new_entry, vtime);
   /* Queue */
   QUEUE_ELEM(mprs_list, new_entry);
+  olsr_tc_churn();
   /*
      new_entry->prev = &mprs_list;
      new_entry->next = mprs_list.next;
@@ -44,6 +44,7 @@
 #include "two_hop_neighbor_table.h"
 #include "mid_set.h"
 #include "mpr.h"
+#include "lq_mpr.h"
 #include "neighbor_table.h"
 #include "olsr.h"
 #include "scheduler.h"
@@ -74,8 +75,12 @@ olsr_del_nbr2_list(struct neighbor_2_list_entry *nbr2_list)
 
   nbr2 = nbr2_list->neighbor_2;
 
+  olsr_mpr_unlink_two_hop(nbr2_list->nbr2_nbr, nbr2);
+
   if (nbr2->neighbor_2_pointer < 1) {
     DEQUEUE_ELEM(nbr2);
+    olsr_mpr_del_two_hop(nbr2);
+    olsr_lq_mpr_del_two_hop(nbr2);
     free(nbr2);
   }
 
@@ -214,6 +219,8 @@ olsr_delete_neighbor_table(const union olsr_ip_addr *neighbor_addr)
   /* Dequeue */
   DEQUEUE_ELEM(entry);
 
+  olsr_mpr_del_neighbor(entry);
+  olsr_lq_mpr_touch_neighbor(entry);
   free(entry);
 
   changes_neighborhood = true;
@@ -315,6 +322,8 @@ olsr_lookup_neighbor_table_alias(const union olsr_ip_addr *dst)
 int
 update_neighbor_status(struct neighbor_entry *entry, int lnk)
 {
+  const uint8_t old_status = entry->status;
+
   /*
    * Update neighbor entry
    */
@@ -331,6 +340,7 @@ update_neighbor_status(struct neighbor_entry *entry, int lnk)
 
       changes_neighborhood = true;
       changes_topology = true;
+      olsr_hello_churn();
       if (olsr_cnf->tc_redundancy > 1)
         signal_link_changes(true);
     }
@@ -339,6 +349,7 @@ update_neighbor_status(struct neighbor_entry *entry, int lnk)
     if (entry->status == SYM) {
       changes_neighborhood = true;
       changes_topology = true;
+      olsr_hello_churn();
       if (olsr_cnf->tc_redundancy > 1)
         signal_link_changes(true);
     }
@@ -347,6 +358,10 @@ update_neighbor_status(struct neighbor_entry *entry, int lnk)
     /* remove neighbor from routing list */
   }
 
+  if (entry->status != old_status) {
+    olsr_lq_mpr_touch_neighbor(entry);
+  }
+
   return entry->status;
 }
 
@@ -383,7 +398,7 @@ void
 olsr_print_neighbor_table(void)
 {
   /* The whole function doesn't do anything else. */
-  const int iplen = olsr_cnf->ip_version == AF_INET ? (INET_ADDRSTRLEN - 1) : (INET6_ADDRSTRLEN - 1);
+  const int iplen = OLSR_IP_VERSION == AF_INET ? (INET_ADDRSTRLEN - 1) : (INET6_ADDRSTRLEN - 1);
   int idx;
 
   OLSR_PRINTF(1,
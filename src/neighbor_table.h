@@ -61,8 +61,9 @@ struct neighbor_entry {
   uint8_t willingness;
   bool is_mpr;
   bool was_mpr;                        /* Used to detect changes in MPR */
-  bool skip;
   int neighbor_2_nocov;
+  uint64_t *mpr_reach;                 /* two hop neighbors by MPR index, see mpr.c */
+  unsigned int lq_mpr_count;           /* two hop neighbors selecting this LQ MPR, see lq_mpr.c */
   int linkcount;
   struct neighbor_2_list_entry neighbor_2_list;
   struct neighbor_entry *next;
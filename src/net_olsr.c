@@ -46,6 +46,7 @@
 #include "net_os.h"
 #include "link_set.h"
 #include "lq_packet.h"
+#include "scheduler.h"
 
 #include <stdlib.h>
 #include <assert.h>
@@ -72,6 +73,8 @@ static struct ptf *ptf_list;
 
 static struct deny_address_entry *deny_entries;
 
+static struct olsr_cookie_info *net_output_timer_cookie;
+
 static const char *const deny_ipv4_defaults[] = {
   "0.0.0.0",
   "127.0.0.1",
@@ -93,16 +96,18 @@ static const char *const deny_ipv6_defaults[] = {
 void
 init_net(void)
 {
-  const char *const *defaults = (olsr_cnf->ip_version == AF_INET) ? deny_ipv4_defaults : deny_ipv6_defaults;
+  const char *const *defaults = (OLSR_IP_VERSION == AF_INET) ? deny_ipv4_defaults : deny_ipv6_defaults;
 
   for (; *defaults != NULL; defaults++) {
     union olsr_ip_addr addr;
-    if (inet_pton(olsr_cnf->ip_version, *defaults, &addr) <= 0) {
+    if (inet_pton(OLSR_IP_VERSION, *defaults, &addr) <= 0) {
       fprintf(stderr, "Error converting fixed IP %s for deny rule!!\n", *defaults);
       continue;
     }
     olsr_add_invalid_address(&addr);
   }
+
+  net_output_timer_cookie = olsr_alloc_cookie("Output deadline", OLSR_COOKIE_TYPE_TIMER);
 }
 
 /**
@@ -155,6 +160,9 @@ net_remove_buffer(struct interface *ifp)
   if (ifp->netbuf.pending)
     net_output(ifp);
 
+  olsr_stop_timer(ifp->netbuf.timer);
+  ifp->netbuf.timer = NULL;
+
   free(ifp->netbuf.buff);
   ifp->netbuf.buff = NULL;
 
@@ -331,22 +339,37 @@ net_output(struct interface *ifp)
   struct sockaddr_in6 dst6;
   struct ptf *tmp_ptf_list;
   union olsr_packet *outmsg;
-  int retval;
+  int retval, off;
+  uint16_t msgsize;
 
   if (!ifp->netbuf.pending)
     return 0;
 
+  olsr_stop_timer(ifp->netbuf.timer);
+  ifp->netbuf.timer = NULL;
+
   ifp->netbuf.pending += OLSR_HEADERSIZE;
 
   retval = ifp->netbuf.pending;
 
+  /* Count the messages for the packets per message ratio */
+  ifp->netbuf.packets++;
+  for (off = OLSR_HEADERSIZE; off + 4 <= ifp->netbuf.pending; off += msgsize) {
+    memcpy(&msgsize, ifp->netbuf.buff + off + 2, sizeof(msgsize));
+    msgsize = ntohs(msgsize);
+    if (msgsize == 0) {
+      break;
+    }
+    ifp->netbuf.messages++;
+  }
+
   outmsg = (union olsr_packet *)ifp->netbuf.buff;
   /* Add the Packet seqno */
   outmsg->v4.olsr_seqno = htons(ifp->olsr_seqnum++);
   /* Set the packetlength */
   outmsg->v4.olsr_packlen = htons(ifp->netbuf.pending);
 
-  if (olsr_cnf->ip_version == AF_INET) {
+  if (OLSR_IP_VERSION == AF_INET) {
     /* IP version 4 */
     sin = (struct sockaddr_in *)&ifp->int_broadaddr;
 
@@ -371,7 +394,7 @@ net_output(struct interface *ifp)
     tmp_ptf_list->function(ifp, ifp->netbuf.buff, &ifp->netbuf.pending);
   }
 
-  if (olsr_cnf->ip_version == AF_INET) {
+  if (OLSR_IP_VERSION == AF_INET) {
     /* IP version 4 */
     if (olsr_sendto(ifp->send_socket, ifp->netbuf.buff, ifp->netbuf.pending, MSG_DONTROUTE, (struct sockaddr *)sin, sizeof(*sin)) <
         0) {
@@ -409,6 +432,66 @@ net_output(struct interface *ifp)
   return retval;
 }
 
+static void
+net_output_deadline(void *context)
+{
+  struct interface *ifp = context;
+
+  ifp->netbuf.timer = NULL;
+  net_output(ifp);
+}
+
+/**
+ * Schedule the data pending on an interface. The messages are
+ * collected until the first of them reaches its deadline or the
+ * buffer is full, so they share as few packets as possible.
+ *
+ * @param ifp the interface
+ * @param max_delay the time in milliseconds the last pushed message may wait
+ */
+void
+net_output_schedule(struct interface *ifp, uint32_t max_delay)
+{
+  uint32_t deadline;
+
+  if (!ifp->netbuf.pending)
+    return;
+
+  deadline = GET_TIMESTAMP(max_delay);
+  if (ifp->netbuf.timer && TIME_DUE(ifp->netbuf.deadline) <= TIME_DUE(deadline))
+    return;
+
+  ifp->netbuf.deadline = deadline;
+  olsr_set_timer(&ifp->netbuf.timer, max_delay, 0, OLSR_TIMER_ONESHOT, &net_output_deadline, ifp, net_output_timer_cookie);
+}
+
+/**
+ * Schedule a forwarded message. It waits a random time of up to
+ * MaxJitter, so neighbors forwarding the same message do not
+ * send at the same time.
+ *
+ * @param ifp the interface
+ */
+void
+net_output_forward(struct interface *ifp)
+{
+  net_output_schedule(ifp, random() * olsr_cnf->max_jitter * MSEC_PER_SEC / RAND_MAX);
+}
+
+/**
+ * Schedule a periodic message. It may wait as long as the jitter
+ * of its emission interval.
+ *
+ * @param ifp the interface
+ * @param interval the emission interval of the message in seconds
+ * @param jitter_pct the jitter of the interval in percent, see HELLO_JITTER
+ */
+void
+net_output_periodic(struct interface *ifp, float interval, uint8_t jitter_pct)
+{
+  net_output_schedule(ifp, interval * MSEC_PER_SEC * jitter_pct / 100);
+}
+
 /*
  * Adds the given IP-address to the invalid list.
  */
@@ -424,6 +507,22 @@ olsr_add_invalid_address(const union olsr_ip_addr *adr)
   OLSR_PRINTF(1, "Added %s to IP deny set\n", olsr_ip_to_string(&buf, &new_entry->addr));
 }
 
+/*
+ * Copies up to max addresses of the invalid list to addrs.
+ * Returns the number of addresses copied.
+ */
+unsigned int
+olsr_get_invalid_addresses(union olsr_ip_addr *addrs, unsigned int max)
+{
+  const struct deny_address_entry *deny_entry;
+  unsigned int count = 0;
+
+  for (deny_entry = deny_entries; deny_entry != NULL && count < max; deny_entry = deny_entry->next) {
+    addrs[count++] = deny_entry->addr;
+  }
+  return count;
+}
+
 bool
 olsr_validate_address(const union olsr_ip_addr *adr)
 {
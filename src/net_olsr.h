@@ -69,6 +69,12 @@ int net_outbuffer_push_reserved(struct interface *, const void *, const uint16_t
 
 int net_output(struct interface *);
 
+void net_output_schedule(struct interface *, uint32_t);
+
+void net_output_forward(struct interface *);
+
+void net_output_periodic(struct interface *, float, uint8_t);
+
 int net_sendroute(struct rt_entry *, struct sockaddr *);
 
 int add_ptf(packet_transform_function);
@@ -79,6 +85,8 @@ bool olsr_validate_address(const union olsr_ip_addr *);
 
 void olsr_add_invalid_address(const union olsr_ip_addr *);
 
+unsigned int olsr_get_invalid_addresses(union olsr_ip_addr *, unsigned int);
+
 #endif /* _NET_OLSR */
 
 /*
@@ -0,0 +1,205 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon(olsrd)
+ * Copyright (c) 2004, Andreas Tonnesen(andreto@olsr.org)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+#include <string.h>
+
+#include "node_id.h"
+#include "olsr.h"
+#include "olsr_cookie.h"
+
+/* Initial number of slots in the node table */
+#define NODE_TABLE_INITIAL_SIZE 64
+
+/* Address to node mapping */
+static struct avl_tree node_tree;
+
+/* Node id to node mapping, slot 0 is never used */
+struct olsr_node **olsr_node_table = NULL;
+static uint32_t node_table_size = 0;
+
+/* Stack of released node ids */
+static olsr_node_id *free_ids = NULL;
+static uint32_t free_ids_count = 0;
+
+/* Next never used node id */
+static olsr_node_id next_id = 1;
+
+static struct olsr_cookie_info *node_mem_cookie = NULL;
+
+/**
+ * Initialize the node id table.
+ */
+void
+olsr_init_node_ids(void)
+{
+  avl_init(&node_tree, avl_comp_default);
+
+  node_mem_cookie = olsr_alloc_cookie("node_id", OLSR_COOKIE_TYPE_MEMORY);
+  olsr_cookie_set_memory_size(node_mem_cookie, sizeof(struct olsr_node));
+
+  node_table_size = NODE_TABLE_INITIAL_SIZE;
+  olsr_node_table = olsr_malloc(node_table_size * sizeof(*olsr_node_table), "node table");
+  free_ids = olsr_malloc(node_table_size * sizeof(*free_ids), "node table");
+}
+
+/*
+ * Double the size of the node table.
+ * The stack of released ids grows along, it never holds more
+ * entries than there are slots.
+ */
+static void
+olsr_grow_node_table(void)
+{
+  struct olsr_node **table;
+  olsr_node_id *ids;
+
+  table = olsr_malloc(2 * node_table_size * sizeof(*table), "node table");
+  memcpy(table, olsr_node_table, node_table_size * sizeof(*table));
+  free(olsr_node_table);
+  olsr_node_table = table;
+
+  ids = olsr_malloc(2 * node_table_size * sizeof(*ids), "node table");
+  memcpy(ids, free_ids, free_ids_count * sizeof(*ids));
+  free(free_ids);
+  free_ids = ids;
+
+  node_table_size *= 2;
+}
+
+/**
+ * Map an address to its node id, allocating a new id if the
+ * address is not yet known. Every call takes a reference which
+ * must be given back with olsr_release_node_id().
+ *
+ * @param addr the address to intern
+ * @return the node id of the address
+ */
+olsr_node_id
+olsr_intern_node_id(const union olsr_ip_addr *addr)
+{
+  struct avl_node *node;
+  struct olsr_node *entry;
+
+  node = avl_find(&node_tree, addr);
+  if (node) {
+    entry = addr_tree2node(node);
+    entry->refcount++;
+    return entry->id;
+  }
+
+  entry = olsr_cookie_malloc(node_mem_cookie);
+  entry->addr = *addr;
+  entry->addr_node.key = &entry->addr;
+  entry->refcount = 1;
+
+  /*
+   * Reuse released ids first to keep the table dense.
+   */
+  if (free_ids_count) {
+    entry->id = free_ids[--free_ids_count];
+  } else {
+    if (next_id == node_table_size) {
+      olsr_grow_node_table();
+    }
+    entry->id = next_id++;
+  }
+
+  olsr_node_table[entry->id] = entry;
+  avl_insert(&node_tree, &entry->addr_node, AVL_DUP_NO);
+
+  return entry->id;
+}
+
+/**
+ * Look up the node id of an address without taking a reference.
+ *
+ * @param addr the address to look for
+ * @return the node id or OLSR_NODE_ID_NONE if the address is unknown
+ */
+olsr_node_id
+olsr_lookup_node_id(const union olsr_ip_addr *addr)
+{
+  struct avl_node *node;
+
+  node = avl_find(&node_tree, addr);
+
+  return (node ? addr_tree2node(node)->id : OLSR_NODE_ID_NONE);
+}
+
+/**
+ * Drop a reference to a node id. The id is recycled
+ * once all references are gone.
+ *
+ * @param id the node id to release
+ */
+void
+olsr_release_node_id(olsr_node_id id)
+{
+  struct olsr_node *entry;
+
+  entry = olsr_node_table[id];
+  if (--entry->refcount) {
+    return;
+  }
+
+  avl_delete(&node_tree, &entry->addr_node);
+  olsr_node_table[id] = NULL;
+  free_ids[free_ids_count++] = id;
+
+  olsr_cookie_free(node_mem_cookie, entry);
+}
+
+/**
+ * Return an upper bound for all node ids handed out so far,
+ * e.g. for sizing arrays indexed by node id.
+ */
+olsr_node_id
+olsr_node_id_limit(void)
+{
+  return next_id;
+}
+
+/*
+ * Local Variables:
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,103 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon(olsrd)
+ * Copyright (c) 2004, Andreas Tonnesen(andreto@olsr.org)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+#ifndef _OLSR_NODE_ID_H
+#define _OLSR_NODE_ID_H
+
+#include "olsr_types.h"
+#include "common/avl.h"
+
+struct tc_entry;
+
+/*
+ * A node id is a dense 32-bit handle for an originator or interface
+ * address. Topology structures store and compare node ids instead of
+ * full addresses, the address is only resolved at message and kernel
+ * boundaries. Id 0 is never handed out.
+ */
+typedef uint32_t olsr_node_id;
+
+#define OLSR_NODE_ID_NONE 0
+
+struct olsr_node {
+  struct avl_node addr_node;           /* node keyed by ip address */
+  union olsr_ip_addr addr;             /* addr_node key */
+  olsr_node_id id;                     /* index into the node table */
+  uint32_t refcount;                   /* reference counter */
+  struct tc_entry *tc;                 /* lsdb vertex of this node, if any */
+};
+
+AVLNODE2STRUCT(addr_tree2node, struct olsr_node, addr_node);
+
+/*
+ * Node ids sort and compare like IPv4 addresses, so trees keyed
+ * by node ids take the inline fast path of the avl code.
+ */
+#define avl_comp_node_id avl_comp_ipv4
+
+extern struct olsr_node **olsr_node_table;
+
+void olsr_init_node_ids(void);
+olsr_node_id olsr_intern_node_id(const union olsr_ip_addr *);
+olsr_node_id olsr_lookup_node_id(const union olsr_ip_addr *);
+void olsr_release_node_id(olsr_node_id);
+olsr_node_id olsr_node_id_limit(void);
+
+static inline struct olsr_node *
+olsr_node_by_id(olsr_node_id id)
+{
+  return olsr_node_table[id];
+}
+
+static inline union olsr_ip_addr *
+olsr_node_id_to_addr(olsr_node_id id)
+{
+  return &olsr_node_table[id]->addr;
+}
+
+#endif /* _OLSR_NODE_ID_H */
+
+/*
+ * Local Variables:
+ * c-basic-offset: 2
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -66,6 +66,10 @@
 #include "lq_plugin.h"
 #include "gateway.h"
 #include "duplicate_handler.h"
+#include "hna_set.h"
+#include "routing_table.h"
+#include "olsr_cookie.h"
+#include "node_id.h"
 
 #include <stdarg.h>
 #include <signal.h>
@@ -256,7 +260,7 @@ olsr_init_tables(void)
   changes_hna = false;
 
   /* Set avl tree comparator */
-  if (olsr_cnf->ipsize == 4) {
+  if (OLSR_IPSIZE == 4) {
     avl_comp_default = avl_comp_ipv4;
     avl_comp_prefix_default = avl_comp_ipv4_prefix;
   } else {
@@ -282,6 +286,9 @@ olsr_init_tables(void)
   /* Initialize two hop table */
   olsr_init_two_hop_table();
 
+  /* Initialize node ids */
+  olsr_init_node_ids();
+
   /* Initialize topology */
   olsr_init_tc();
 
@@ -298,6 +305,96 @@ olsr_init_tables(void)
 #ifndef NO_DUPLICATE_DETECTION_HANDLER
   olsr_duplicate_handler_init();
 #endif /* NO_DUPLICATE_DETECTION_HANDLER */
+
+  /* Initialize memory statistics */
+  olsr_init_memory_stats();
+}
+
+/**
+ * Fill in the number of entries of all the protocol tables.
+ * Every table is backed by a memory cookie, so this is just
+ * reading the cookie usage.
+ *
+ * @param sizes the structure to fill in
+ */
+void
+olsr_get_table_sizes(struct olsr_table_sizes *sizes)
+{
+  memset(sizes, 0, sizeof(*sizes));
+
+  sizes->tc = tc_mem_cookie ? tc_mem_cookie->ci_usage : 0;
+  sizes->tc_edge = tc_edge_mem_cookie ? tc_edge_mem_cookie->ci_usage : 0;
+  sizes->mid = mid_mem_cookie ? mid_mem_cookie->ci_usage : 0;
+  sizes->mid_alias = mid_address_mem_cookie ? mid_address_mem_cookie->ci_usage : 0;
+  sizes->hna_gw = hna_entry_mem_cookie ? hna_entry_mem_cookie->ci_usage : 0;
+  sizes->hna_net = hna_net_mem_cookie ? hna_net_mem_cookie->ci_usage : 0;
+  sizes->link = link_mem_cookie ? link_mem_cookie->ci_usage : 0;
+  sizes->dup = dup_mem_cookie ? dup_mem_cookie->ci_usage : 0;
+  sizes->rt = rt_mem_cookie ? rt_mem_cookie->ci_usage : 0;
+  sizes->rt_path = rtp_mem_cookie ? rtp_mem_cookie->ci_usage : 0;
+}
+
+/**
+ * Periodically refresh the allocation rates of all cookies.
+ */
+static void
+olsr_update_memory_stats(void *foo __attribute__ ((unused)))
+{
+  olsr_cookie_update_rates(COOKIE_STATS_INTERVAL);
+}
+
+/**
+ * Write a one line memory summary to syslog.
+ * Reports the total slab memory, the cookie with the biggest
+ * footprint and the size of the protocol tables.
+ */
+static void
+olsr_log_memory_stats(void *foo __attribute__ ((unused)))
+{
+  struct olsr_table_sizes sizes;
+  struct olsr_cookie_info *ci, *top = NULL;
+  size_t total = 0, footprint, top_footprint = 0;
+  unsigned int refused = 0, evicted = 0;
+  olsr_cookie_t ci_id;
+
+  for (ci_id = 1; ci_id < COOKIE_ID_MAX; ci_id++) {
+    ci = olsr_cookie_lookup(ci_id);
+    if (!ci) {
+      continue;
+    }
+    footprint = olsr_cookie_mem_footprint(ci);
+    total += footprint;
+    refused += ci->ci_refused;
+    evicted += ci->ci_evicted;
+    if (footprint > top_footprint) {
+      top_footprint = footprint;
+      top = ci;
+    }
+  }
+
+  olsr_get_table_sizes(&sizes);
+
+  olsr_syslog(OLSR_LOG_INFO,
+              "Memory: %lu bytes in cookies, top %s %lu bytes (peak %u); "
+              "tc %u, edges %u, mid %u/%u, hna %u/%u, links %u, dup %u, routes %u/%u; refused %u, evicted %u",
+              (unsigned long)total, top ? top->ci_name : "-", (unsigned long)top_footprint, top ? top->ci_usage_peak : 0,
+              sizes.tc, sizes.tc_edge, sizes.mid, sizes.mid_alias, sizes.hna_gw, sizes.hna_net,
+              sizes.link, sizes.dup, sizes.rt, sizes.rt_path, refused, evicted);
+}
+
+/**
+ * Start the timers for memory statistics.
+ * The syslog summary is only written if MemoryStatsInterval is set.
+ */
+void
+olsr_init_memory_stats(void)
+{
+  olsr_start_timer(COOKIE_STATS_INTERVAL, 0, OLSR_TIMER_PERIODIC, &olsr_update_memory_stats, NULL, 0);
+
+  if (olsr_cnf->mem_stats_interval > 0) {
+    olsr_start_timer(olsr_cnf->mem_stats_interval * MSEC_PER_SEC, 0, OLSR_TIMER_PERIODIC,
+                     &olsr_log_memory_stats, NULL, 0);
+  }
 }
 
 /**
@@ -324,7 +421,7 @@ olsr_forward_message(union olsr_message *m, struct interface *in_if, union olsr_
    * of a bug in parser.c:parse_packet, we have a lot of messages because
    * all older olsrd's have lq_fish enabled.
    */
-  if (AF_INET == olsr_cnf->ip_version) {
+  if (AF_INET == OLSR_IP_VERSION) {
     if (m->v4.ttl < 2 || 255 < (int)m->v4.hopcnt + (int)m->v4.ttl)
       is_ttl_1 = true;
   } else {
@@ -359,7 +456,7 @@ olsr_forward_message(union olsr_message *m, struct interface *in_if, union olsr_
 
   /* Treat TTL hopcnt except for ethernet link */
   if (!is_ttl_1) {
-    if (olsr_cnf->ip_version == AF_INET) {
+    if (OLSR_IP_VERSION == AF_INET) {
       /* IPv4 */
       m->v4.hopcnt++;
       m->v4.ttl--;
@@ -381,41 +478,26 @@ olsr_forward_message(union olsr_message *m, struct interface *in_if, union olsr_
     /* do not forward TTL 1 messages to non-ether interfaces */
     if (is_ttl_1 && ifn->mode != IF_MODE_ETHER) continue;
 
-    if (net_output_pending(ifn)) {
-      /*
-       * Check if message is to big to be piggybacked
-       */
-      if (net_outbuffer_push(ifn, m, msgsize) != msgsize) {
-        /* Send */
-        net_output(ifn);
-        /* Buffer message */
-        set_buffer_timer(ifn);
-
-        if (net_outbuffer_push(ifn, m, msgsize) != msgsize) {
-          OLSR_PRINTF(1, "Received message to big to be forwarded in %s(%d bytes)!", ifn->int_name, msgsize);
-          olsr_syslog(OLSR_LOG_ERR, "Received message to big to be forwarded on %s(%d bytes)!", ifn->int_name, msgsize);
-        }
-      }
-    } else {
-      /* No forwarding pending */
-      set_buffer_timer(ifn);
+    /*
+     * Check if message is to big to be piggybacked
+     */
+    if (net_outbuffer_push(ifn, m, msgsize) != msgsize) {
+      /* Send */
+      net_output(ifn);
 
       if (net_outbuffer_push(ifn, m, msgsize) != msgsize) {
         OLSR_PRINTF(1, "Received message to big to be forwarded in %s(%d bytes)!", ifn->int_name, msgsize);
         olsr_syslog(OLSR_LOG_ERR, "Received message to big to be forwarded on %s(%d bytes)!", ifn->int_name, msgsize);
+        continue;
       }
     }
+
+    /* Buffer message */
+    net_output_forward(ifn);
   }
   return 1;
 }
 
-void
-set_buffer_timer(struct interface *ifn)
-{
-  /* Set timer */
-  ifn->fwdtimer = GET_TIMESTAMP(random() * olsr_cnf->max_jitter * MSEC_PER_SEC / RAND_MAX);
-}
-
 void
 olsr_init_willingness(void)
 {
@@ -494,6 +576,14 @@ olsr_msgtype_to_string(uint8_t msgtype)
     return ("LQ-HELLO");
   case (LQ_TC_MESSAGE):
     return ("LQ-TC");
+  case (LQ_TC_DELTA_MESSAGE):
+    return ("LQ-TC-DELTA");
+  case (LQ_TC_COMPACT_MESSAGE):
+    return ("LQ-TC-COMPACT");
+  case (MID_COMPACT_MESSAGE):
+    return ("MID-COMPACT");
+  case (HNA_COMPACT_MESSAGE):
+    return ("HNA-COMPACT");
   default:
     break;
   }
@@ -67,10 +67,29 @@ bool olsr_is_bad_duplicate_msg_seqno(uint16_t seqno);
 
 int olsr_forward_message(union olsr_message *, struct interface *, union olsr_ip_addr *);
 
-void set_buffer_timer(struct interface *);
 
 void olsr_init_tables(void);
 
+/*
+ * Number of entries in the protocol tables
+ */
+struct olsr_table_sizes {
+  unsigned int tc;                     /* tc_entry, one per originator */
+  unsigned int tc_edge;                /* tc_edge_entry */
+  unsigned int mid;                    /* mid_entry, one per multi-interface node */
+  unsigned int mid_alias;              /* mid_address */
+  unsigned int hna_gw;                 /* hna_entry, one per HNA gateway */
+  unsigned int hna_net;                /* hna_net */
+  unsigned int link;                   /* link_entry */
+  unsigned int dup;                    /* dup_entry */
+  unsigned int rt;                     /* rt_entry */
+  unsigned int rt_path;                /* rt_path */
+};
+
+void olsr_get_table_sizes(struct olsr_table_sizes *);
+
+void olsr_init_memory_stats(void);
+
 void olsr_init_willingness(void);
 
 void olsr_update_willingness(void *);
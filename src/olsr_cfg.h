@@ -59,7 +59,20 @@
 /* Default values not declared in olsr_protocol.h */
 #define DEF_IP_VERSION       AF_INET
 #define DEF_POLLRATE         0.05
+#define DEF_INPUT_BUDGET     50
 #define DEF_NICCHGPOLLRT     2.5
+#define DEF_LINK_FAIL_DETECT true
+#define DEF_LINK_FAIL_DELAY  0.5
+#define DEF_ADAPTIVE_INTERVALS 1
+#define DEF_TC_TRIGGER_BURST 3
+#define DEF_TC_TRIGGER_GAP   1.0
+#define DEF_MEM_STATS_INT    0
+#define DEF_MAX_TC_ENTRIES   0
+#define DEF_MAX_TC_EDGES     0
+#define DEF_MAX_MID_ENTRIES  0
+#define DEF_MAX_HNA_NETS     0
+#define DEF_MAX_DUP_ENTRIES  0
+#define DEF_DUP_WINDOW       128
 #define DEF_WILL_AUTO        false
 #define DEF_WILLINGNESS      3
 #define DEF_ALLOW_NO_INTS    true
@@ -71,6 +84,8 @@
 #define DEF_LQ_LEVEL         2
 #define DEF_LQ_ALGORITHM     "etx_ff"
 #define DEF_LQ_FISH          1
+#define DEF_TC_DELTA         0
+#define DEF_COMPACT_ADDRS    false
 #define DEF_LQ_NAT_THRESH    1.0
 #define DEF_LQ_AGING         0.05
 #define DEF_CLEAR_SCREEN     true
@@ -110,6 +125,11 @@
 #define MIN_POLLRATE         0.01
 #define MAX_NICCHGPOLLRT     100.0
 #define MIN_NICCHGPOLLRT     1.0
+#define MAX_LINK_FAIL_DELAY  60.0
+#define MAX_ADAPTIVE_INTERVALS 16
+#define MAX_TC_TRIGGER_BURST 16
+#define MAX_TC_TRIGGER_GAP   60.0
+#define MAX_TC_DELTA         64
 #define MAX_DEBUGLVL         9
 #define MIN_DEBUGLVL         0
 #define MAX_TOS              252
@@ -276,12 +296,27 @@ struct olsrd_config {
   struct if_config_options *interface_defaults;
   struct olsr_if *interfaces;
   float pollrate;
+  uint8_t input_budget;
   float nic_chgs_pollrate;
+  bool link_fail_detection;
+  float link_fail_delay;
+  uint8_t adaptive_intervals;
+  uint8_t tc_trigger_burst;
+  float tc_trigger_gap;
+  uint32_t mem_stats_interval;
+  uint32_t max_tc_entries;
+  uint32_t max_tc_edges;
+  uint32_t max_mid_entries;
+  uint32_t max_hna_nets;
+  uint32_t max_dup_entries;
+  uint32_t dup_window;
   bool clear_screen;
   uint8_t tc_redundancy;
   uint8_t mpr_coverage;
   uint8_t lq_level;
   uint8_t lq_fish;
+  uint8_t tc_delta;
+  bool compact_addrs;
   float lq_aging;
   char *lq_algorithm;
 
@@ -44,10 +44,16 @@
 #include "log.h"
 
 #include <assert.h>
+#include <stdlib.h>
+#ifdef _WIN32
+#include <malloc.h>
+#endif /* _WIN32 */
 
 /* Root directory of the cookies we have in the system */
 static struct olsr_cookie_info *cookies[COOKIE_ID_MAX] = { 0 };
 
+LISTNODE2STRUCT(list2slab, struct olsr_cookie_slab, cs_node);
+
 /*
  * Allocate a cookie for the next available cookie id.
  */
@@ -79,22 +85,72 @@ olsr_alloc_cookie(const char *cookie_name, olsr_cookie_type cookie_type)
     ci->ci_name = strdup(cookie_name);
   }
 
-  /* Init the free list */
+  /* Init the slab lists */
   if (cookie_type == OLSR_COOKIE_TYPE_MEMORY) {
-    list_head_init(&ci->ci_free_list);
+    list_head_init(&ci->ci_partial_slabs);
+    list_head_init(&ci->ci_full_slabs);
   }
 
   return ci;
 }
 
+/*
+ * Allocate a slab aligned to its own size.
+ */
+static void *
+olsr_cookie_slab_alloc(size_t size)
+{
+  void *ptr;
+
+#ifdef _WIN32
+  ptr = _aligned_malloc(size, size);
+#else /* _WIN32 */
+  if (posix_memalign(&ptr, size, size)) {
+    ptr = NULL;
+  }
+#endif /* _WIN32 */
+
+  return ptr;
+}
+
+/*
+ * Give a slab back to the system.
+ */
+static void
+olsr_cookie_slab_release(struct olsr_cookie_info *ci, struct olsr_cookie_slab *slab)
+{
+  ci->ci_free_list_usage -= ci->ci_slab_blocks - slab->cs_usage;
+  ci->ci_slab_count--;
+
+#ifdef _WIN32
+  _aligned_free(slab);
+#else /* _WIN32 */
+  free(slab);
+#endif /* _WIN32 */
+}
+
+/*
+ * Release all slabs hanging off a slab list.
+ */
+static void
+olsr_cookie_flush_slab_list(struct olsr_cookie_info *ci, struct list_node *slab_list)
+{
+  struct list_node *slab_node;
+
+  while (!list_is_empty(slab_list)) {
+    slab_node = slab_list->next;
+    list_remove(slab_node);
+    olsr_cookie_slab_release(ci, list2slab(slab_node));
+  }
+}
+
 /*
  * Free a cookie that is no longer being used.
+ * All slabs are released, including those with blocks still in use.
  */
 void
 olsr_free_cookie(struct olsr_cookie_info *ci)
 {
-  struct list_node *memory_list;
-
   /* Mark the cookie as unused */
   cookies[ci->ci_id] = NULL;
 
@@ -103,12 +159,13 @@ olsr_free_cookie(struct olsr_cookie_info *ci)
     free(ci->ci_name);
   }
 
-  /* Flush all the memory on the free list */
+  /* Flush all the memory pools */
   if (ci->ci_type == OLSR_COOKIE_TYPE_MEMORY) {
-    while (!list_is_empty(&ci->ci_free_list)) {
-      memory_list = ci->ci_free_list.next;
-      list_remove(memory_list);
-      free(memory_list);
+    olsr_cookie_flush_slab_list(ci, &ci->ci_partial_slabs);
+    olsr_cookie_flush_slab_list(ci, &ci->ci_full_slabs);
+    if (ci->ci_spare_slab) {
+      olsr_cookie_slab_release(ci, ci->ci_spare_slab);
+      ci->ci_spare_slab = NULL;
     }
   }
 
@@ -136,17 +193,62 @@ olsr_delete_all_cookies(void)
 
 /*
  * Set the size for fixed block allocations.
- * This is only allowed for memory cookies.
+ * This is only allowed for memory cookies, before the first allocation.
+ * Derives the slab geometry from the block size.
  */
 void
 olsr_cookie_set_memory_size(struct olsr_cookie_info *ci, size_t size)
 {
+  size_t stride, header;
+
   if (!ci) {
     return;
   }
 
   assert(ci->ci_type == OLSR_COOKIE_TYPE_MEMORY);
+  assert(!ci->ci_slab_count);
   ci->ci_size = size;
+
+  /* Each block must at least hold the free list pointer */
+  stride = size < sizeof(void *) ? sizeof(void *) : size;
+#ifdef OLSR_COOKIE_DEBUG
+  stride += sizeof(struct olsr_cookie_mem_brand);
+#endif /* OLSR_COOKIE_DEBUG */
+  stride = (stride + COOKIE_BLOCK_ALIGN - 1) & ~(COOKIE_BLOCK_ALIGN - 1);
+  ci->ci_stride = stride;
+
+  /* Slabs are powers of two, at least one page, big enough for a minimum number of blocks */
+  header = (sizeof(struct olsr_cookie_slab) + COOKIE_CACHE_LINE - 1) & ~(size_t)(COOKIE_CACHE_LINE - 1);
+  ci->ci_slab_size = COOKIE_SLAB_SIZE;
+  while (ci->ci_slab_size - header < COOKIE_SLAB_MIN_BLOCKS * stride) {
+    ci->ci_slab_size <<= 1;
+  }
+  ci->ci_slab_blocks = (ci->ci_slab_size - header) / stride;
+}
+
+/*
+ * Set the maximum number of blocks a memory cookie may hand out.
+ * The budget is advisory, the owner of the cookie checks it with
+ * olsr_cookie_budget_exhausted() and decides to refuse or evict.
+ * A budget of 0 means unlimited.
+ */
+void
+olsr_cookie_set_budget(struct olsr_cookie_info *ci, unsigned int budget)
+{
+  if (!ci) {
+    return;
+  }
+
+  ci->ci_budget = budget;
+}
+
+/*
+ * Check if another allocation would exceed the budget of a cookie.
+ */
+bool
+olsr_cookie_budget_exhausted(const struct olsr_cookie_info *ci)
+{
+  return ci->ci_budget != 0 && ci->ci_usage >= ci->ci_budget;
 }
 
 /*
@@ -167,9 +269,16 @@ olsr_cookie_valid(olsr_cookie_t cookie_id)
 void
 olsr_cookie_usage_incr(olsr_cookie_t cookie_id)
 {
+  struct olsr_cookie_info *ci;
+
   if (olsr_cookie_valid(cookie_id)) {
-    cookies[cookie_id]->ci_usage++;
-    cookies[cookie_id]->ci_changes++;
+    ci = cookies[cookie_id];
+    ci->ci_usage++;
+    ci->ci_changes++;
+    ci->ci_allocs++;
+    if (ci->ci_usage > ci->ci_usage_peak) {
+      ci->ci_usage_peak = ci->ci_usage;
+    }
   }
 }
 
@@ -202,52 +311,154 @@ olsr_cookie_name(olsr_cookie_t cookie_id)
 }
 
 /*
- * Allocate a fixed amount of memory based on a passed in cookie type.
+ * Return a cookie by its id, NULL if unused.
+ * Used for walking all cookies when reporting statistics.
  */
-void *
-olsr_cookie_malloc(struct olsr_cookie_info *ci)
+struct olsr_cookie_info *
+olsr_cookie_lookup(olsr_cookie_t cookie_id)
 {
-  void *ptr;
-  struct olsr_cookie_mem_brand *branding;
-  struct list_node *free_list_node;
+  if (olsr_cookie_valid(cookie_id)) {
+    return cookies[cookie_id];
+  }
 
-#ifdef OLSR_COOKIE_DEBUG
-  bool reuse = false;
-#endif /* OLSR_COOKIE_DEBUG */
+  return NULL;
+}
 
-  /*
-   * Check first if we have reusable memory.
-   */
-  if (!ci->ci_free_list_usage) {
+/*
+ * Return the number of bytes a memory cookie holds in slabs,
+ * including unused blocks and the spare slab.
+ */
+size_t
+olsr_cookie_mem_footprint(const struct olsr_cookie_info *ci)
+{
+  if (ci->ci_type != OLSR_COOKIE_TYPE_MEMORY) {
+    return 0;
+  }
 
-    /*
-     * No reusable memory block on the free_list.
-     */
-    ptr = calloc(1, ci->ci_size + sizeof(struct olsr_cookie_mem_brand));
+  return ci->ci_slab_count * ci->ci_slab_size;
+}
+
+/*
+ * Recalculate the allocation rates of all cookies.
+ * Called every interval (in milliseconds).
+ */
+void
+olsr_cookie_update_rates(unsigned int interval)
+{
+  struct olsr_cookie_info *ci;
+  int ci_index;
+
+  if (!interval) {
+    return;
+  }
+
+  for (ci_index = 1; ci_index < COOKIE_ID_MAX; ci_index++) {
+    ci = cookies[ci_index];
+    if (!ci) {
+      continue;
+    }
+    ci->ci_alloc_rate = (unsigned int)((ci->ci_allocs - ci->ci_allocs_mark) * 1000ULL / interval);
+    ci->ci_allocs_mark = ci->ci_allocs;
+  }
+}
+
+/*
+ * Address of the first block in a slab.
+ */
+static inline unsigned char *
+olsr_cookie_slab_blocks(struct olsr_cookie_slab *slab)
+{
+  return (unsigned char *)slab + ((sizeof(struct olsr_cookie_slab) + COOKIE_CACHE_LINE - 1) & ~(size_t)(COOKIE_CACHE_LINE - 1));
+}
+
+/*
+ * Find the slab a block has been carved from.
+ */
+static inline struct olsr_cookie_slab *
+olsr_cookie_block_to_slab(struct olsr_cookie_info *ci, void *ptr)
+{
+  return (struct olsr_cookie_slab *)ARM_NOWARN_ALIGN((size_t)ptr & ~(ci->ci_slab_size - 1));
+}
+
+/*
+ * Get a slab with at least one unused block.
+ * Use the spare slab if there is one, otherwise get a fresh one.
+ */
+static struct olsr_cookie_slab *
+olsr_cookie_get_slab(struct olsr_cookie_info *ci)
+{
+  struct olsr_cookie_slab *slab;
+
+  if (!list_is_empty(&ci->ci_partial_slabs)) {
+    return list2slab(ci->ci_partial_slabs.next);
+  }
 
-    if (!ptr) {
+  if (ci->ci_spare_slab) {
+    slab = ci->ci_spare_slab;
+    ci->ci_spare_slab = NULL;
+  } else {
+    slab = olsr_cookie_slab_alloc(ci->ci_slab_size);
+    if (!slab) {
       const char *const err_msg = strerror(errno);
       OLSR_PRINTF(1, "OUT OF MEMORY: %s\n", err_msg);
       olsr_syslog(OLSR_LOG_ERR, "olsrd: out of memory!: %s\n", err_msg);
       olsr_exit(ci->ci_name, EXIT_FAILURE);
     }
-    assert(ptr);
-  } else {
+    assert(slab);
 
     /*
-     * There is a memory block on the free list.
-     * Carve it out of the list, and clean.
+     * Blocks are carved lazily, so only the header gets touched here.
      */
-    free_list_node = ci->ci_free_list.next;
-    list_remove(free_list_node);
-    ptr = (void *)free_list_node;
-    memset(ptr, 0, ci->ci_size);
-    ci->ci_free_list_usage--;
+    slab->cs_cookie = ci;
+    slab->cs_free = NULL;
+    slab->cs_usage = 0;
+    slab->cs_carved = 0;
+    ci->ci_slab_count++;
+    ci->ci_free_list_usage += ci->ci_slab_blocks;
+  }
+
+  list_node_init(&slab->cs_node);
+  list_add_after(&ci->ci_partial_slabs, &slab->cs_node);
+  return slab;
+}
+
+/*
+ * Allocate a fixed amount of memory based on a passed in cookie type.
+ */
+void *
+olsr_cookie_malloc(struct olsr_cookie_info *ci)
+{
+  void *ptr;
+  struct olsr_cookie_slab *slab;
 #ifdef OLSR_COOKIE_DEBUG
-    reuse = true;
+  struct olsr_cookie_mem_brand *branding;
 #endif /* OLSR_COOKIE_DEBUG */
+
+  slab = olsr_cookie_get_slab(ci);
+
+  /*
+   * Recycle a freed block first, carve a new one from the slab otherwise.
+   */
+  if (slab->cs_free) {
+    ptr = slab->cs_free;
+    slab->cs_free = *(void **)ptr;
+  } else {
+    assert(slab->cs_carved < ci->ci_slab_blocks);
+    ptr = olsr_cookie_slab_blocks(slab) + slab->cs_carved * ci->ci_stride;
+    slab->cs_carved++;
+  }
+  memset(ptr, 0, ci->ci_size);
+
+  slab->cs_usage++;
+  ci->ci_free_list_usage--;
+
+  /* Slab exhausted, park it on the full list */
+  if (slab->cs_usage == ci->ci_slab_blocks) {
+    list_remove(&slab->cs_node);
+    list_add_before(&ci->ci_full_slabs, &slab->cs_node);
   }
 
+#ifdef OLSR_COOKIE_DEBUG
   /*
    * Now brand mark the end of the memory block with a short signature
    * indicating presence of a cookie. This will be checked against
@@ -256,12 +467,13 @@ olsr_cookie_malloc(struct olsr_cookie_info *ci)
   branding = (struct olsr_cookie_mem_brand *)ARM_NOWARN_ALIGN(((unsigned char *)ptr + ci->ci_size));
   memcpy(&branding->cmb_sig[0], "cookie", 6);
   branding->cmb_id = ci->ci_id;
+#endif /* OLSR_COOKIE_DEBUG */
 
   /* Stats keeping */
   olsr_cookie_usage_incr(ci->ci_id);
 
 #ifdef OLSR_COOKIE_DEBUG
-  OLSR_PRINTF(1, "MEMORY: alloc %s, %p, %u bytes%s\n", ci->ci_name, ptr, ci->ci_size, reuse ? ", reuse" : "");
+  OLSR_PRINTF(1, "MEMORY: alloc %s, %p, %lu bytes, slab %p\n", ci->ci_name, ptr, (unsigned long)ci->ci_size, (void *)slab);
 #endif /* OLSR_COOKIE_DEBUG */
 
   return ptr;
@@ -274,13 +486,19 @@ olsr_cookie_malloc(struct olsr_cookie_info *ci)
 void
 olsr_cookie_free(struct olsr_cookie_info *ci, void *ptr)
 {
-  struct olsr_cookie_mem_brand *branding;
-  struct list_node *free_list_node;
-
+  struct olsr_cookie_slab *slab;
 #ifdef OLSR_COOKIE_DEBUG
-  bool reuse = false;
+  struct olsr_cookie_mem_brand *branding;
 #endif /* OLSR_COOKIE_DEBUG */
 
+  slab = olsr_cookie_block_to_slab(ci, ptr);
+
+  /*
+   * Verify that the block belongs to a slab of this owner.
+   */
+  assert(slab->cs_cookie == ci && slab->cs_usage > 0);
+
+#ifdef OLSR_COOKIE_DEBUG
   branding = (struct olsr_cookie_mem_brand *)ARM_NOWARN_ALIGN(((unsigned char *)ptr + ci->ci_size));
 
   /*
@@ -291,34 +509,37 @@ olsr_cookie_free(struct olsr_cookie_info *ci, void *ptr)
 
   /* Kill the brand */
   memset(branding, 0, sizeof(*branding));
+#endif /* OLSR_COOKIE_DEBUG */
 
-  /*
-   * Rather than freeing the memory right away, try to reuse at a later
-   * point. Keep at least ten percent of the active used blocks or at least
-   * ten blocks on the free list.
-   */
-  if ((ci->ci_free_list_usage < COOKIE_FREE_LIST_THRESHOLD) || (ci->ci_free_list_usage < ci->ci_usage / COOKIE_FREE_LIST_THRESHOLD)) {
+  /* Slab has a free block again, move it back to the partial list */
+  if (slab->cs_usage == ci->ci_slab_blocks) {
+    list_remove(&slab->cs_node);
+    list_add_before(&ci->ci_partial_slabs, &slab->cs_node);
+  }
 
-    free_list_node = (struct list_node *)ptr;
-    list_node_init(free_list_node);
-    list_add_before(&ci->ci_free_list, free_list_node);
-    ci->ci_free_list_usage++;
-#ifdef OLSR_COOKIE_DEBUG
-    reuse = true;
-#endif /* OLSR_COOKIE_DEBUG */
-  } else {
+  *(void **)ptr = slab->cs_free;
+  slab->cs_free = ptr;
+  slab->cs_usage--;
+  ci->ci_free_list_usage++;
 
-    /*
-     * No interest in reusing memory.
-     */
-    free(ptr);
+  /*
+   * Empty slab. Keep one around to damp alloc/free churn at a
+   * slab boundary, give the rest back to the system.
+   */
+  if (!slab->cs_usage) {
+    list_remove(&slab->cs_node);
+    if (!ci->ci_spare_slab) {
+      ci->ci_spare_slab = slab;
+    } else {
+      olsr_cookie_slab_release(ci, slab);
+    }
   }
 
   /* Stats keeping */
   olsr_cookie_usage_decr(ci->ci_id);
 
 #ifdef OLSR_COOKIE_DEBUG
-  OLSR_PRINTF(1, "MEMORY: free %s, %p, %u bytes%s\n", ci->ci_name, ptr, ci->ci_size, reuse ? ", reuse" : "");
+  OLSR_PRINTF(1, "MEMORY: free %s, %p, %lu bytes, slab %p\n", ci->ci_name, ptr, (unsigned long)ci->ci_size, (void *)slab);
 #endif /* OLSR_COOKIE_DEBUG */
 
 }
@@ -53,6 +53,8 @@ typedef enum olsr_cookie_type_ {
   OLSR_COOKIE_TYPE_MAX
 } olsr_cookie_type;
 
+struct olsr_cookie_slab;
+
 /*
  * This is a cookie. A cookie is a tool aimed for olsrd developers.
  * It is used for tracking resource usage in the system and also
@@ -63,14 +65,47 @@ struct olsr_cookie_info {
   char *ci_name;                       /* Name */
   olsr_cookie_type ci_type;            /* Type of cookie */
   size_t ci_size;                      /* Fixed size for block allocations */
+  size_t ci_stride;                    /* Distance between blocks in a slab */
+  size_t ci_slab_size;                 /* Size (and alignment) of a slab */
+  unsigned int ci_slab_blocks;         /* Number of blocks per slab */
   unsigned int ci_usage;               /* Stats, resource usage */
+  unsigned int ci_usage_peak;          /* Stats, high-water mark of resource usage */
   unsigned int ci_changes;             /* Stats, resource churn */
-  struct list_node ci_free_list;       /* List head for recyclable blocks */
-  unsigned int ci_free_list_usage;     /* Length of free list */
+  unsigned int ci_allocs;              /* Stats, total number of allocations */
+  unsigned int ci_allocs_mark;         /* Stats, ci_allocs at last rate update */
+  unsigned int ci_alloc_rate;          /* Stats, allocations per second over last interval */
+  unsigned int ci_budget;              /* Maximum number of blocks in use, 0 = unlimited */
+  unsigned int ci_refused;             /* Stats, allocations refused due to the budget */
+  unsigned int ci_evicted;             /* Stats, blocks evicted to stay within the budget */
+  struct list_node ci_partial_slabs;   /* List head for slabs with free blocks */
+  struct list_node ci_full_slabs;      /* List head for completely used slabs */
+  struct olsr_cookie_slab *ci_spare_slab; /* One empty slab kept for reuse */
+  unsigned int ci_slab_count;          /* Number of slabs held, including spare */
+  unsigned int ci_free_list_usage;     /* Number of unused blocks in all slabs */
+};
+
+/*
+ * Memory cookies carve their blocks out of slabs. A slab is a chunk of
+ * ci_slab_size bytes (at least one page) aligned to its own size, so the
+ * owning slab of a block is found by masking the block address.
+ * The slab header sits in the first cache line, the blocks follow.
+ */
+struct olsr_cookie_slab {
+  struct list_node cs_node;            /* Member of partial or full slab list */
+  struct olsr_cookie_info *cs_cookie;  /* Owner of this slab */
+  void *cs_free;                       /* Singly linked list of free blocks */
+  unsigned int cs_usage;               /* Blocks handed out */
+  unsigned int cs_carved;              /* Blocks carved from the slab so far */
 };
 
-#define COOKIE_FREE_LIST_THRESHOLD 10   /* Blocks / Percent  */
+#define COOKIE_STATS_INTERVAL  10000    /* Update interval of allocation rates in ms */
+
+#define COOKIE_SLAB_SIZE       4096     /* Minimum slab size, one page */
+#define COOKIE_SLAB_MIN_BLOCKS 8        /* Grow slab beyond a page to fit at least this many blocks */
+#define COOKIE_CACHE_LINE      64       /* Alignment of the first block in a slab */
+#define COOKIE_BLOCK_ALIGN     (2 * sizeof(void *)) /* Alignment of each block */
 
+#ifdef OLSR_COOKIE_DEBUG
 /*
  * Small brand which gets appended on the end of every block allocation.
  * Helps to detect memory corruption, like overruns, double frees.
@@ -79,13 +114,19 @@ struct olsr_cookie_mem_brand {
   char cmb_sig[6];
   olsr_cookie_t cmb_id;
 };
+#endif /* OLSR_COOKIE_DEBUG */
 
 /* Externals. */
 extern struct olsr_cookie_info *olsr_alloc_cookie(const char *, olsr_cookie_type);
 extern void olsr_free_cookie(struct olsr_cookie_info *);
 extern void olsr_delete_all_cookies(void);
 extern char *olsr_cookie_name(olsr_cookie_t);
+extern struct olsr_cookie_info *olsr_cookie_lookup(olsr_cookie_t);
+extern size_t olsr_cookie_mem_footprint(const struct olsr_cookie_info *);
+extern void olsr_cookie_update_rates(unsigned int);
 extern void olsr_cookie_set_memory_size(struct olsr_cookie_info *, size_t);
+extern void olsr_cookie_set_budget(struct olsr_cookie_info *, unsigned int);
+extern bool olsr_cookie_budget_exhausted(const struct olsr_cookie_info *);
 extern void olsr_cookie_usage_incr(olsr_cookie_t);
 extern void olsr_cookie_usage_decr(olsr_cookie_t);
 
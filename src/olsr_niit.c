@@ -18,7 +18,7 @@ static void handle_niit_ifchange (int if_index, struct interface *iface, enum ol
 static bool niit4to6_active, niit6to4_active;
 
 void olsr_init_niit(void) {
-  if (olsr_cnf->ip_version == AF_INET) {
+  if (OLSR_IP_VERSION == AF_INET) {
     olsr_cnf->use_niit = false;
     return;
   }
@@ -71,7 +71,7 @@ void olsr_cleanup_niit_routes(void) {
 }
 
 void olsr_niit_handle_route(const struct rt_entry *rt, bool set) {
-  if (olsr_cnf->ip_version == AF_INET6 && olsr_cnf->use_niit
+  if (OLSR_IP_VERSION == AF_INET6 && olsr_cnf->use_niit
       && niit4to6_active && niit6to4_active && is_prefix_niit_ipv6(&rt->rt_dst)) {
     struct olsr_ip_prefix dst_v4;
 
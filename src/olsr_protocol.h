@@ -95,6 +95,10 @@ struct olsr;
 #define HNA_MESSAGE           4
 #define MAX_MESSAGE           4
 
+/* MID and HNA with compact addresses, see CompactAddresses */
+#define MID_COMPACT_MESSAGE   205
+#define HNA_COMPACT_MESSAGE   206
+
 /*
  *Link Types
  */
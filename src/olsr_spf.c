@@ -42,13 +42,17 @@
  * Implementation of Dijkstras algorithm. Initially all nodes
  * are initialized to infinite cost. First we put ourselves
  * on the heap of reachable nodes. Our heap implementation
- * is based on an AVL tree which gives interesting performance
- * characteristics for the frequent operations of minimum key
- * extraction and re-keying. Next all neighbors of a node are
- * explored and put on the heap if the cost of reaching them is
- * better than reaching the current candidate node.
+ * is a binary heap of node ids, with ties broken first in first out.
+ * Next all neighbors of a node are explored and put on the heap if
+ * the cost of reaching them is better than reaching the current
+ * candidate node.
  * The SPF calculation is terminated if there are no more nodes
  * on the heap.
+ *
+ * The edges are not taken from the lsdb directly, but from a
+ * compressed sparse row view of it. All edges of a node sit next
+ * to each other in plain arrays of target node ids and costs, so
+ * the inner loop does not chase pointers through the edge trees.
  */
 
 #include "ipcalc.h"
@@ -71,69 +75,288 @@
 struct timer_entry *spf_backoff_timer = NULL;
 
 /*
- * avl_comp_etx
+ * Compressed sparse row view of the lsdb, indexed by node id.
+ * The edges of node id n sit in the slots [spf_row[n], spf_row[n + 1]).
+ * Only edges with an inverse edge are stored, all others are dead ends.
  *
- * compare two etx metrics.
- * return 0 if there is an exact match and
- * -1 / +1 depending on being smaller or bigger.
- * note that this results in the most optimal code
- * after compiler optimization.
+ * Cost changes are patched into the view in place and deleted edges
+ * are turned into tombstones. New edges mark the view stale, it is
+ * rebuilt on the next SPF run.
+ */
+#define SPF_SLOT_NONE 0xffffffff
+
+static uint32_t *spf_row = NULL;       /* first edge slot of each node */
+static olsr_node_id *spf_target = NULL; /* destination node of each edge slot */
+static olsr_linkcost *spf_cost = NULL; /* cost of each edge slot */
+static uint32_t spf_nodes = 0;         /* number of node ids covered by the view */
+static uint32_t spf_nodes_size = 0;    /* allocated node slots */
+static uint32_t spf_edges_size = 0;    /* allocated edge slots */
+static bool spf_graph_stale = true;
+
+/*
+ * Scratch space of the Dijkstra run, indexed by node id.
+ */
+static olsr_linkcost *spf_dist = NULL; /* best known path cost */
+static uint32_t *spf_seq = NULL;       /* queueing order, breaks ties */
+static uint32_t *spf_heap_pos = NULL;  /* position in spf_heap + 1, 0 if not queued */
+static olsr_node_id *spf_heap = NULL;  /* binary heap of candidate nodes */
+static uint32_t spf_heap_count;
+static uint32_t spf_seq_count;
+
+/*
+ * A new edge changes the shape of the view.
+ */
+void
+olsr_spf_add_edge(struct tc_edge_entry *tc_edge)
+{
+  tc_edge->spf_slot = SPF_SLOT_NONE;
+  spf_graph_stale = true;
+}
+
+/*
+ * Turn a deleted edge and its inverse into tombstones.
+ * The inverse edge becomes a dead end once this edge is gone.
+ */
+void
+olsr_spf_del_edge(struct tc_edge_entry *tc_edge)
+{
+  if (spf_graph_stale) {
+    return;
+  }
+
+  if (tc_edge->spf_slot != SPF_SLOT_NONE) {
+    spf_target[tc_edge->spf_slot] = OLSR_NODE_ID_NONE;
+    spf_cost[tc_edge->spf_slot] = LINK_COST_BROKEN;
+  }
+  if (tc_edge->edge_inv && tc_edge->edge_inv->spf_slot != SPF_SLOT_NONE) {
+    spf_target[tc_edge->edge_inv->spf_slot] = OLSR_NODE_ID_NONE;
+    spf_cost[tc_edge->edge_inv->spf_slot] = LINK_COST_BROKEN;
+    tc_edge->edge_inv->spf_slot = SPF_SLOT_NONE;
+  }
+}
+
+/*
+ * Patch the cost of an edge into the view.
  */
-static int
-avl_comp_etx(const void *etx1, const void *etx2)
+void
+olsr_spf_update_edge_cost(struct tc_edge_entry *tc_edge)
 {
-  if (*(const olsr_linkcost *)etx1 < *(const olsr_linkcost *)etx2) {
-    return -1;
+  if (spf_graph_stale || tc_edge->spf_slot == SPF_SLOT_NONE) {
+    return;
   }
 
-  if (*(const olsr_linkcost *)etx1 > *(const olsr_linkcost *)etx2) {
-    return +1;
+  spf_cost[tc_edge->spf_slot] = tc_edge->cost;
+}
+
+/*
+ * olsr_spf_grow
+ *
+ * Make sure an array has room for a given number of elements.
+ * The array grows in powers of two and loses its contents.
+ */
+static void *
+olsr_spf_grow(void *array, uint32_t *size, uint32_t needed, size_t elem_size)
+{
+  if (*size >= needed && array) {
+    return array;
   }
 
-  return 0;
+  free(array);
+  if (*size == 0) {
+    *size = 64;
+  }
+  while (*size < needed) {
+    *size <<= 1;
+  }
+  return olsr_malloc(*size * elem_size, "SPF graph");
 }
 
 /*
- * olsr_spf_add_cand_tree
+ * olsr_spf_build_graph
  *
- * Key an existing vertex to a candidate tree.
+ * Rebuild the compressed sparse row view from the lsdb.
  */
 static void
-olsr_spf_add_cand_tree(struct avl_tree *tree, struct tc_entry *tc)
+olsr_spf_build_graph(void)
 {
-#if !defined(NODEBUG) && defined(DEBUG)
-  struct ipaddr_str buf;
-  struct lqtextbuffer lqbuffer;
-#endif /* !defined(NODEBUG) && defined(DEBUG) */
-  tc->cand_tree_node.key = &tc->path_cost;
+  struct tc_entry *tc;
+  struct tc_edge_entry *tc_edge;
+  struct olsr_node *node;
+  uint32_t nodes_size, edges, slot;
+  olsr_node_id id;
 
-#ifdef DEBUG
-  OLSR_PRINTF(2, "SPF: insert candidate %s, cost %s\n", olsr_ip_to_string(&buf, &tc->addr),
-              get_linkcost_text(tc->path_cost, false, &lqbuffer));
-#endif /* DEBUG */
+  spf_nodes = olsr_node_id_limit();
 
-  avl_insert(tree, &tc->cand_tree_node, AVL_DUP);
+  edges = 0;
+  OLSR_FOR_ALL_TC_ENTRIES(tc) {
+    edges += tc->edge_tree.count;
+  } OLSR_FOR_ALL_TC_ENTRIES_END(tc);
+
+  /*
+   * All node indexed arrays share one size.
+   */
+  nodes_size = spf_nodes_size;
+  spf_row = olsr_spf_grow(spf_row, &nodes_size, spf_nodes + 1, sizeof(*spf_row));
+  if (nodes_size != spf_nodes_size) {
+    uint32_t size;
+
+    size = spf_nodes_size;
+    spf_dist = olsr_spf_grow(spf_dist, &size, nodes_size, sizeof(*spf_dist));
+    size = spf_nodes_size;
+    spf_seq = olsr_spf_grow(spf_seq, &size, nodes_size, sizeof(*spf_seq));
+    size = spf_nodes_size;
+    spf_heap_pos = olsr_spf_grow(spf_heap_pos, &size, nodes_size, sizeof(*spf_heap_pos));
+    size = spf_nodes_size;
+    spf_heap = olsr_spf_grow(spf_heap, &size, nodes_size, sizeof(*spf_heap));
+    spf_nodes_size = nodes_size;
+  }
+
+  if (edges > spf_edges_size || !spf_target) {
+    uint32_t size;
+
+    size = spf_edges_size;
+    spf_target = olsr_spf_grow(spf_target, &size, edges, sizeof(*spf_target));
+    size = spf_edges_size;
+    spf_cost = olsr_spf_grow(spf_cost, &size, edges, sizeof(*spf_cost));
+    spf_edges_size = size;
+  }
+
+  slot = 0;
+  for (id = 0; id < spf_nodes; id++) {
+    spf_row[id] = slot;
+
+    node = olsr_node_table[id];
+    if (!node || !node->tc) {
+      continue;
+    }
+
+    OLSR_FOR_ALL_TC_EDGE_ENTRIES(node->tc, tc_edge) {
+      if (!tc_edge->edge_inv) {
+        tc_edge->spf_slot = SPF_SLOT_NONE;
+        continue;
+      }
+      tc_edge->spf_slot = slot;
+      spf_target[slot] = tc_edge->edge_inv->tc->node_id;
+      spf_cost[slot] = tc_edge->cost;
+      slot++;
+    } OLSR_FOR_ALL_TC_EDGE_ENTRIES_END(node->tc, tc_edge);
+  }
+  spf_row[spf_nodes] = slot;
+
+  spf_graph_stale = false;
+}
+
+/*
+ * olsr_spf_heap_less
+ *
+ * Order two queued nodes by path cost, then by queueing order.
+ */
+static inline bool
+olsr_spf_heap_less(olsr_node_id a, olsr_node_id b)
+{
+  if (spf_dist[a] != spf_dist[b]) {
+    return spf_dist[a] < spf_dist[b];
+  }
+  return spf_seq[a] < spf_seq[b];
 }
 
 /*
- * olsr_spf_del_cand_tree
+ * olsr_spf_heap_up
  *
- * Unkey an existing vertex from a candidate tree.
+ * Move a node towards the root of the heap until the order is restored.
  */
 static void
-olsr_spf_del_cand_tree(struct avl_tree *tree, struct tc_entry *tc)
+olsr_spf_heap_up(uint32_t pos)
 {
+  olsr_node_id id = spf_heap[pos];
 
-#ifdef DEBUG
-#ifndef NODEBUG
-  struct ipaddr_str buf;
-  struct lqtextbuffer lqbuffer;
-#endif /* NODEBUG */
-  OLSR_PRINTF(2, "SPF: delete candidate %s, cost %s\n", olsr_ip_to_string(&buf, &tc->addr),
-              get_linkcost_text(tc->path_cost, false, &lqbuffer));
-#endif /* DEBUG */
+  while (pos > 0) {
+    uint32_t parent = (pos - 1) / 2;
+
+    if (!olsr_spf_heap_less(id, spf_heap[parent])) {
+      break;
+    }
+    spf_heap[pos] = spf_heap[parent];
+    spf_heap_pos[spf_heap[pos]] = pos + 1;
+    pos = parent;
+  }
+  spf_heap[pos] = id;
+  spf_heap_pos[id] = pos + 1;
+}
+
+/*
+ * olsr_spf_heap_down
+ *
+ * Move a node away from the root of the heap until the order is restored.
+ */
+static void
+olsr_spf_heap_down(uint32_t pos)
+{
+  olsr_node_id id = spf_heap[pos];
+
+  for (;;) {
+    uint32_t child = 2 * pos + 1;
+
+    if (child >= spf_heap_count) {
+      break;
+    }
+    if (child + 1 < spf_heap_count && olsr_spf_heap_less(spf_heap[child + 1], spf_heap[child])) {
+      child++;
+    }
+    if (!olsr_spf_heap_less(spf_heap[child], id)) {
+      break;
+    }
+    spf_heap[pos] = spf_heap[child];
+    spf_heap_pos[spf_heap[pos]] = pos + 1;
+    pos = child;
+  }
+  spf_heap[pos] = id;
+  spf_heap_pos[id] = pos + 1;
+}
+
+/*
+ * olsr_spf_add_cand
+ *
+ * Queue a node with a new path cost, or re-key it if it is queued already.
+ * Equal costs are served in the order they were queued.
+ */
+static void
+olsr_spf_add_cand(olsr_node_id id, olsr_linkcost cost)
+{
+  spf_dist[id] = cost;
+  spf_seq[id] = spf_seq_count++;
+
+  if (spf_heap_pos[id]) {
+    olsr_spf_heap_up(spf_heap_pos[id] - 1);
+    return;
+  }
 
-  avl_delete(tree, &tc->cand_tree_node);
+  spf_heap[spf_heap_count] = id;
+  olsr_spf_heap_up(spf_heap_count++);
+}
+
+/*
+ * olsr_spf_extract_best
+ *
+ * Remove and return the node with the minimum pathcost.
+ */
+static olsr_node_id
+olsr_spf_extract_best(void)
+{
+  olsr_node_id best;
+
+  if (!spf_heap_count) {
+    return OLSR_NODE_ID_NONE;
+  }
+
+  best = spf_heap[0];
+  spf_heap_pos[best] = 0;
+
+  if (--spf_heap_count) {
+    spf_heap[0] = spf_heap[spf_heap_count];
+    olsr_spf_heap_down(0);
+  }
+  return best;
 }
 
 /*
@@ -160,31 +383,18 @@ olsr_spf_add_path_list(struct list_node *head, int *path_count, struct tc_entry
   *path_count = *path_count + 1;
 }
 
-/*
- * olsr_spf_extract_best
- *
- * return the node with the minimum pathcost.
- */
-static struct tc_entry *
-olsr_spf_extract_best(struct avl_tree *tree)
-{
-  struct avl_node *node = avl_walk_first(tree);
-
-  return (node ? cand_tree2tc(node) : NULL);
-}
-
 /*
  * olsr_spf_relax
  *
  * Explore all edges of a node and add the node
- * to the candidate tree if the if the aggregate
+ * to the candidate heap if the if the aggregate
  * path cost is better.
  */
 static void
-olsr_spf_relax(struct avl_tree *cand_tree, struct tc_entry *tc)
+olsr_spf_relax(olsr_node_id id, struct tc_entry *tc)
 {
-  struct avl_node *edge_node;
   olsr_linkcost new_cost;
+  uint32_t slot;
 
 #ifdef DEBUG
 #ifndef NODEBUG
@@ -197,73 +407,49 @@ olsr_spf_relax(struct avl_tree *cand_tree, struct tc_entry *tc)
 
   /*
    * loop through all edges of this vertex.
+   * Tombstones and edges without an inverse never show up with
+   * a usable cost.
    */
-  for (edge_node = avl_walk_first(&tc->edge_tree); edge_node; edge_node = avl_walk_next(edge_node)) {
-
+  for (slot = spf_row[id]; slot < spf_row[id + 1]; slot++) {
     struct tc_entry *new_tc;
-    struct tc_edge_entry *tc_edge = edge_tree2tc_edge(edge_node);
+    olsr_node_id new_id;
 
-    /*
-     * We are not interested in dead-end edges.
-     */
-    if (!tc_edge->edge_inv) {
-#ifdef DEBUG
-      OLSR_PRINTF(2, "SPF:   ignoring edge %s\n", olsr_ip_to_string(&buf, &tc_edge->T_dest_addr));
-      if (!tc_edge->edge_inv) {
-        OLSR_PRINTF(2, "SPF:     no inverse edge\n");
-      }
-#endif /* DEBUG */
+    if (spf_cost[slot] == LINK_COST_BROKEN) {
       continue;
     }
 
-    if (tc_edge->cost == LINK_COST_BROKEN) {
-#ifdef DEBUG
-      OLSR_PRINTF(2, "SPF:   ignore edge %s (broken)\n", olsr_ip_to_string(&buf, &tc_edge->T_dest_addr));
-#endif /* DEBUG */
-      continue;
-    }
     /*
      * total quality of the path through this vertex
      * to the destination of this edge
      */
-    new_cost = tc->path_cost + tc_edge->cost;
-
-#ifdef DEBUG
-    OLSR_PRINTF(2, "SPF:   exploring edge %s, cost %s\n", olsr_ip_to_string(&buf, &tc_edge->T_dest_addr),
-                get_linkcost_text(new_cost, true, &lqbuffer));
-#endif /* DEBUG */
+    new_cost = spf_dist[id] + spf_cost[slot];
+    new_id = spf_target[slot];
 
     /*
      * if it's better than the current path quality of this edge's
      * destination node, then we've found a better path to this node.
      */
-    new_tc = tc_edge->edge_inv->tc;
-
-    if (new_cost < new_tc->path_cost) {
-
-      /* if this node has been on the candidate tree delete it */
-      if (new_tc->path_cost < ROUTE_COST_BROKEN) {
-        olsr_spf_del_cand_tree(cand_tree, new_tc);
-      }
+    if (new_cost >= spf_dist[new_id]) {
+      continue;
+    }
 
-      /* re-insert on candidate tree with the better metric */
-      new_tc->path_cost = new_cost;
-      olsr_spf_add_cand_tree(cand_tree, new_tc);
+    /* re-key on the candidate heap with the better metric */
+    new_tc = olsr_node_by_id(new_id)->tc;
+    new_tc->path_cost = new_cost;
+    olsr_spf_add_cand(new_id, new_cost);
 
-      /* pull-up the next-hop and bump the hop count */
-      if (tc->next_hop) {
-        new_tc->next_hop = tc->next_hop;
-      }
-      new_tc->hops = tc->hops + 1;
+    /* pull-up the next-hop and bump the hop count */
+    if (tc->next_hop) {
+      new_tc->next_hop = tc->next_hop;
+    }
+    new_tc->hops = tc->hops + 1;
 
 #ifdef DEBUG
-      OLSR_PRINTF(2, "SPF:   better path to %s, cost %s, via %s, hops %u\n", olsr_ip_to_string(&buf, &new_tc->addr),
-                  get_linkcost_text(new_cost, true, &lqbuffer), tc->next_hop ? olsr_ip_to_string(&nbuf,
-                                                                                                 &tc->next_hop->neighbor_iface_addr)
-                  : "<none>", new_tc->hops);
+    OLSR_PRINTF(2, "SPF:   better path to %s, cost %s, via %s, hops %u\n", olsr_ip_to_string(&buf, &new_tc->addr),
+                get_linkcost_text(new_cost, true, &lqbuffer), tc->next_hop ? olsr_ip_to_string(&nbuf,
+                                                                                               &tc->next_hop->neighbor_iface_addr)
+                : "<none>", new_tc->hops);
 #endif /* DEBUG */
-
-    }
   }
 }
 
@@ -272,29 +458,46 @@ olsr_spf_relax(struct avl_tree *cand_tree, struct tc_entry *tc)
  *
  * Run the Dijkstra algorithm.
  *
- * A node gets added to the candidate tree when one of its edges has
+ * A node gets added to the candidate heap when one of its edges has
  * an overall better root path cost than the node itself.
- * The node with the shortest metric gets moved from the candidate to
+ * The node with the shortest metric gets moved from the candidate heap to
  * the path list every pass.
  * The SPF computation is completed when there are no more nodes
- * on the candidate tree.
+ * on the candidate heap.
  */
 static void
-olsr_spf_run_full(struct avl_tree *cand_tree, struct list_node *path_list, int *path_count)
+olsr_spf_run_full(struct list_node *path_list, int *path_count)
 {
   struct tc_entry *tc;
+  olsr_node_id id;
 
   *path_count = 0;
 
-  while ((tc = olsr_spf_extract_best(cand_tree))) {
+  if (spf_graph_stale || olsr_node_id_limit() > spf_nodes) {
+    olsr_spf_build_graph();
+  }
+
+  for (id = 0; id < spf_nodes; id++) {
+    spf_dist[id] = ROUTE_COST_BROKEN;
+    spf_heap_pos[id] = 0;
+  }
+  spf_heap_count = 0;
+  spf_seq_count = 0;
+
+  /*
+   * Start with ourselves.
+   */
+  olsr_spf_add_cand(tc_myself->node_id, tc_myself->path_cost);
+
+  while ((id = olsr_spf_extract_best()) != OLSR_NODE_ID_NONE) {
+    tc = olsr_node_by_id(id)->tc;
 
-    olsr_spf_relax(cand_tree, tc);
+    olsr_spf_relax(id, tc);
 
     /*
-     * move the best path from the candidate tree
+     * move the best path from the candidate heap
      * to the path list.
      */
-    olsr_spf_del_cand_tree(cand_tree, tc);
     olsr_spf_add_path_list(path_list, path_count, tc);
   }
 }
@@ -314,7 +517,6 @@ olsr_calculate_routing_table(bool force)
 #ifdef SPF_PROFILING
   struct timeval t1, t2, t3, t4, t5, spf_init, spf_run, route, kernel, total;
 #endif /* SPF_PROFILING */
-  struct avl_tree cand_tree;
   struct avl_node *rtp_tree_node;
   struct list_node path_list;          /* head of the path_list */
   struct tc_entry *tc;
@@ -339,9 +541,8 @@ olsr_calculate_routing_table(bool force)
 #endif /* SPF_PROFILING */
 
   /*
-   * Prepare the candidate tree and result list.
+   * Prepare the result list.
    */
-  avl_init(&cand_tree, avl_comp_etx);
   list_head_init(&path_list);
   olsr_bump_routingtree_version();
 
@@ -371,10 +572,9 @@ olsr_calculate_routing_table(bool force)
   }
 
   /*
-   * zero ourselves and add us to the candidate tree.
+   * zero ourselves, the SPF run starts from here.
    */
   tc_myself->path_cost = ZERO_ROUTE_COST;
-  olsr_spf_add_cand_tree(&cand_tree, tc_myself);
 
   /*
    * add edges to and from our neighbours.
@@ -436,7 +636,7 @@ olsr_calculate_routing_table(bool force)
   /*
    * Run the SPF calculation.
    */
-  olsr_spf_run_full(&cand_tree, &path_list, &path_count);
+  olsr_spf_run_full(&path_list, &path_count);
 
   OLSR_PRINTF(2, "\n--- %s ------------------------------------------------- DIJKSTRA\n\n", olsr_wallclock_string());
 
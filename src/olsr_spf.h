@@ -42,8 +42,14 @@
 #ifndef _OLSR_SPF_H
 #define _OLSR_SPF_H
 
+struct tc_edge_entry;
+
 void olsr_calculate_routing_table(bool force);
 
+void olsr_spf_add_edge(struct tc_edge_entry *);
+void olsr_spf_del_edge(struct tc_edge_entry *);
+void olsr_spf_update_edge_cost(struct tc_edge_entry *);
+
 #endif /* _OLSR_SPF_H */
 
 /*
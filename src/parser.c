@@ -53,6 +53,11 @@
 #include "log.h"
 #include "net_olsr.h"
 #include "duplicate_handler.h"
+#include "mpr_selector_set.h"
+#include "lq_packet.h"
+#include "scheduler.h"
+#include "olsr_cookie.h"
+#include "common/avl.h"
 
 #ifdef _WIN32
 #undef EWOULDBLOCK
@@ -64,21 +69,124 @@ char *StrError(unsigned int ErrNo);
 #define strerror(x) StrError(x)
 #endif /* _WIN32 */
 
-    /* Sven-Ola: On very slow devices used in huge networks
- * the amount of lq_tc messages is so high, that the
- * recv() loop never ends. This is a small hack to end
- * the loop in this cases
+/*
+ * Packets read from one socket per poll. Their messages are only
+ * queued, so this just ends the recv() loop on sockets which
+ * never run empty.
  */
+#define PARSER_READ_LIMIT 256
 
-unsigned int cpu_overload_exit = 0;
+/* Interval for removing the token buckets of silent originators */
+#define PARSER_BUCKET_CLEANUP (10*1000)  /* milliseconds */
 
 struct parse_function_entry *parse_functions;
+
+/* Dispatch table of the parse functions, indexed by message type */
+static struct parse_function_vector parse_vectors[256];
+static struct parse_function_vector parse_promiscuous;
+
+static struct parser_msg_stats parser_stats[256];
+
+/*
+ * Received messages wait in the queue of their ingress class
+ * until olsr_parser_run_queue() gets to them.
+ */
+struct parser_queue_entry {
+  struct parser_queue_entry *next;
+  struct interface *in_if;
+  union olsr_ip_addr from_addr;
+  uint64_t msg[0];                     /* copy of the message */
+};
+
+struct parser_queue {
+  struct parser_queue_entry *head;
+  struct parser_queue_entry **tail;
+};
+
+static struct parser_queue parser_queues[PARSER_CLASSES];
+static struct parser_class_stats parser_class_stats[PARSER_CLASSES];
+
+static const char *const parser_class_names[PARSER_CLASSES] = {
+  "link",
+  "topology",
+  "other"
+};
+
+/* End of the current poll interval and the CPU time left in it */
+static uint32_t parser_period_end;
+static long parser_budget;
+
+/* Set while messages are left over from the last run */
+static bool parser_overload;
+
+static struct timer_entry *parser_queue_timer;
+static struct olsr_cookie_info *parser_queue_timer_cookie;
+
+/* Token bucket of one originator */
+struct parser_bucket {
+  struct avl_node bucket_node;
+  union olsr_ip_addr originator;
+  uint32_t refill;                     /* time of the last refill */
+  uint32_t tokens;                     /* in 1/1000 messages */
+};
+
+AVLNODE2STRUCT(bucket_tree2bucket, struct parser_bucket, bucket_node);
+
+static struct avl_tree parser_bucket_tree;
+static struct olsr_cookie_info *parser_bucket_cookie;
+static struct timer_entry *parser_bucket_timer;
+
+/*
+ * Memory for transient objects created while parsing a packet.
+ * Everything allocated from it is released in one go when
+ * parse_packet() is done with the packet.
+ */
+#define PARSER_ARENA_CHUNK 4096
+
+struct parser_arena_chunk {
+  struct parser_arena_chunk *next;
+  size_t size;
+  size_t used;
+  uint64_t data[0];
+};
+
+static struct parser_arena_chunk *parser_arena;
 struct preprocessor_function_entry *preprocessor_functions;
 struct packetparser_function_entry *packetparser_functions;
 
 static uint32_t inbuf_aligned[MAXMESSAGESIZE/sizeof(uint32_t) + 1];
 static char *inbuf = (char *)inbuf_aligned;
 
+static void olsr_parser_run_queue(void);
+
+/**
+ *Remove the token buckets which have been refilled completely.
+ *Their originators did not send anything for a while.
+ */
+static void
+olsr_parser_cleanup_buckets(void *unused __attribute__ ((unused)))
+{
+  struct avl_node *node, *next;
+  struct parser_bucket *bucket;
+
+  for (node = avl_walk_first(&parser_bucket_tree); node; node = next) {
+    next = avl_walk_next(node);
+    bucket = bucket_tree2bucket(node);
+
+    if (now_times - bucket->refill > PARSER_BUCKET_BURST * MSEC_PER_SEC / PARSER_BUCKET_RATE) {
+      avl_delete(&parser_bucket_tree, &bucket->bucket_node);
+      olsr_cookie_free(parser_bucket_cookie, bucket);
+    }
+  }
+}
+
+static void
+olsr_parser_queue_expired(void *unused __attribute__ ((unused)))
+{
+  parser_queue_timer = NULL;
+  olsr_parser_run_queue();
+}
+
 /**
  *Initialize the parser.
  *
@@ -87,23 +195,184 @@ static char *inbuf = (char *)inbuf_aligned;
 void
 olsr_init_parser(void)
 {
+  int i;
+
   OLSR_PRINTF(3, "Initializing parser...\n");
 
+  for (i = 0; i < PARSER_CLASSES; i++) {
+    parser_queues[i].tail = &parser_queues[i].head;
+  }
+
+  /* avl_comp_default is not set up yet */
+  avl_init(&parser_bucket_tree, OLSR_IP_VERSION == AF_INET ? &avl_comp_ipv4 : &avl_comp_ipv6);
+
+  parser_bucket_cookie = olsr_alloc_cookie("Input bucket", OLSR_COOKIE_TYPE_MEMORY);
+  olsr_cookie_set_memory_size(parser_bucket_cookie, sizeof(struct parser_bucket));
+  parser_queue_timer_cookie = olsr_alloc_cookie("Input queue", OLSR_COOKIE_TYPE_TIMER);
+
+  olsr_set_timer(&parser_bucket_timer, PARSER_BUCKET_CLEANUP, 0, OLSR_TIMER_PERIODIC,
+                 &olsr_parser_cleanup_buckets, NULL, 0);
+
   /* Initialize the packet functions */
   olsr_init_package_process();
 
 }
 
+/**
+ *Rebuild the dispatch vector of one message type (or the
+ *promiscuous one) from the list of registered parse functions.
+ *
+ *@param type the message type or PROMISCUOUS
+ */
+static void
+olsr_parser_rebuild_vector(uint32_t type)
+{
+  struct parse_function_vector *vector;
+  struct parse_function_entry *entry;
+  unsigned int count = 0;
+
+  if (type == PROMISCUOUS) {
+    vector = &parse_promiscuous;
+  } else if (type < 256) {
+    vector = &parse_vectors[type];
+  } else {
+    /* no message can have this type */
+    return;
+  }
+
+  for (entry = parse_functions; entry; entry = entry->next) {
+    if (entry->type == type) {
+      count++;
+    }
+  }
+
+  free(vector->functions);
+  vector->functions = NULL;
+  vector->count = 0;
+
+  if (count == 0) {
+    return;
+  }
+
+  vector->functions = olsr_malloc(count * sizeof(*vector->functions), "Parse function vector");
+  for (entry = parse_functions; entry; entry = entry->next) {
+    if (entry->type == type) {
+      vector->functions[vector->count++] = entry->function;
+    }
+  }
+}
+
+/**
+ *Allocate zeroed memory which is only valid until the
+ *current packet has been parsed.
+ *
+ *@param size the number of bytes
+ *@return pointer to the memory
+ */
+void *
+olsr_parser_arena_alloc(size_t size)
+{
+  struct parser_arena_chunk *chunk;
+  void *ptr;
+
+  /* keep everything aligned to 8 bytes */
+  size = (size + 7) & ~(size_t)7;
+
+  if (parser_arena == NULL || parser_arena->size - parser_arena->used < size) {
+    size_t chunk_size = size > PARSER_ARENA_CHUNK ? size : PARSER_ARENA_CHUNK;
+
+    chunk = olsr_malloc(sizeof(*chunk) + chunk_size, "Parser arena");
+    chunk->size = chunk_size;
+    chunk->used = 0;
+    chunk->next = parser_arena;
+    parser_arena = chunk;
+  }
+
+  ptr = (char *)parser_arena->data + parser_arena->used;
+  parser_arena->used += size;
+
+  memset(ptr, 0, size);
+  return ptr;
+}
+
+/**
+ *Release all memory allocated from the arena. If the last
+ *packet needed more than one chunk, they are replaced by a
+ *single chunk large enough for all of them.
+ */
+static void
+olsr_parser_arena_reset(void)
+{
+  struct parser_arena_chunk *chunk, *next;
+  size_t total;
+
+  if (parser_arena == NULL) {
+    return;
+  }
+
+  if (parser_arena->next == NULL) {
+    parser_arena->used = 0;
+    return;
+  }
+
+  total = 0;
+  for (chunk = parser_arena; chunk; chunk = next) {
+    next = chunk->next;
+    total += chunk->size;
+    free(chunk);
+  }
+
+  parser_arena = olsr_malloc(sizeof(*parser_arena) + total, "Parser arena");
+  parser_arena->size = total;
+}
+
 void
 olsr_destroy_parser(void) {
   struct parse_function_entry *pe, *pe_next;
   struct preprocessor_function_entry *ppe, *ppe_next;
   struct packetparser_function_entry *pae, *pae_next;
+  struct parser_queue_entry *entry, *next;
+  struct avl_node *node;
+  int i;
+
+  olsr_stop_timer(parser_queue_timer);
+  parser_queue_timer = NULL;
+  olsr_stop_timer(parser_bucket_timer);
+  parser_bucket_timer = NULL;
+
+  for (i = 0; i < PARSER_CLASSES; i++) {
+    for (entry = parser_queues[i].head; entry; entry = next) {
+      next = entry->next;
+      free(entry);
+    }
+    parser_queues[i].head = NULL;
+    parser_queues[i].tail = &parser_queues[i].head;
+    parser_class_stats[i].length = 0;
+  }
+
+  while ((node = avl_walk_first(&parser_bucket_tree)) != NULL) {
+    avl_delete(&parser_bucket_tree, node);
+    olsr_cookie_free(parser_bucket_cookie, bucket_tree2bucket(node));
+  }
 
   for (pe = parse_functions; pe; pe = pe_next) {
     pe_next = pe->next;
     free (pe);
   }
+  parse_functions = NULL;
+  for (i = 0; i < 256; i++) {
+    free(parse_vectors[i].functions);
+    parse_vectors[i].functions = NULL;
+    parse_vectors[i].count = 0;
+  }
+  free(parse_promiscuous.functions);
+  parse_promiscuous.functions = NULL;
+  parse_promiscuous.count = 0;
+
+  olsr_parser_arena_reset();
+  free(parser_arena);
+  parser_arena = NULL;
+
   for (ppe = preprocessor_functions; ppe; ppe = ppe_next) {
     ppe_next = ppe->next;
     free (ppe);
@@ -130,6 +399,8 @@ olsr_parser_add_function(parse_function * function, uint32_t type)
   new_entry->next = parse_functions;
   parse_functions = new_entry;
 
+  olsr_parser_rebuild_vector(type);
+
   OLSR_PRINTF(3, "Register parse function: Added function for type %d\n", type);
 
 }
@@ -150,6 +421,7 @@ olsr_parser_remove_function(parse_function * function, uint32_t type)
         prev->next = entry->next;
       }
       free(entry);
+      olsr_parser_rebuild_vector(type);
       return 1;
     }
 
@@ -160,6 +432,216 @@ olsr_parser_remove_function(parse_function * function, uint32_t type)
   return 0;
 }
 
+/**
+ *Get the message counters and processing time histogram
+ *of one message type.
+ *
+ *@param type the message type
+ *@return pointer to the statistics
+ */
+const struct parser_msg_stats *
+olsr_parser_get_stats(uint8_t type)
+{
+  return &parser_stats[type];
+}
+
+/**
+ *Get the queue counters of one ingress class.
+ *
+ *@param cls the ingress class
+ *@return pointer to the statistics
+ */
+const struct parser_class_stats *
+olsr_parser_get_class_stats(enum parser_class cls)
+{
+  return &parser_class_stats[cls];
+}
+
+const char *
+olsr_parser_class_to_string(enum parser_class cls)
+{
+  return parser_class_names[cls];
+}
+
+/**
+ *Drop the queued messages received on an interface
+ *which is about to be removed.
+ *
+ *@param ifp the interface
+ */
+void
+olsr_parser_flush_interface(const struct interface *ifp)
+{
+  struct parser_queue_entry **prev, *entry;
+  int i;
+
+  for (i = 0; i < PARSER_CLASSES; i++) {
+    prev = &parser_queues[i].head;
+    while ((entry = *prev) != NULL) {
+      if (entry->in_if == ifp) {
+        *prev = entry->next;
+        free(entry);
+        parser_class_stats[i].length--;
+      } else {
+        prev = &entry->next;
+      }
+    }
+    parser_queues[i].tail = prev;
+  }
+}
+
+/**
+ *Sort a message into its ingress class.
+ */
+static enum parser_class
+olsr_parser_classify(const union olsr_message *m)
+{
+  union olsr_ip_addr originator;
+
+  /* Should be the same for IPv4 and IPv6 */
+  switch (m->v4.olsr_msgtype) {
+  case HELLO_MESSAGE:
+  case LQ_HELLO_MESSAGE:
+    return PARSER_CLASS_LINK;
+  case TC_MESSAGE:
+  case LQ_TC_MESSAGE:
+  case LQ_TC_DELTA_MESSAGE:
+  case LQ_TC_COMPACT_MESSAGE:
+    /* our MPR selectors rely on us to forward their TCs */
+    memcpy(&originator, &m->v4.originator, OLSR_IPSIZE);
+    if (olsr_lookup_mprs_set(&originator) != NULL) {
+      return PARSER_CLASS_LINK;
+    }
+    return PARSER_CLASS_TOPOLOGY;
+  case MID_MESSAGE:
+  case MID_COMPACT_MESSAGE:
+  case HNA_MESSAGE:
+  case HNA_COMPACT_MESSAGE:
+    return PARSER_CLASS_TOPOLOGY;
+  default:
+    return PARSER_CLASS_OTHER;
+  }
+}
+
+/**
+ *Take a token from the bucket of an originator.
+ *
+ *@return false if the bucket is empty
+ */
+static bool
+olsr_parser_take_token(const union olsr_ip_addr *originator)
+{
+  struct parser_bucket *bucket;
+  uint32_t elapsed;
+
+  bucket = bucket_tree2bucket(avl_find(&parser_bucket_tree, originator));
+  if (bucket == NULL) {
+    bucket = olsr_cookie_malloc(parser_bucket_cookie);
+    memcpy(&bucket->originator, originator, OLSR_IPSIZE);
+    bucket->bucket_node.key = &bucket->originator;
+    bucket->tokens = PARSER_BUCKET_BURST * 1000;
+    avl_insert(&parser_bucket_tree, &bucket->bucket_node, AVL_DUP_NO);
+  } else {
+    elapsed = now_times - bucket->refill;
+    if (elapsed >= PARSER_BUCKET_BURST * MSEC_PER_SEC / PARSER_BUCKET_RATE) {
+      bucket->tokens = PARSER_BUCKET_BURST * 1000;
+    } else {
+      bucket->tokens += elapsed * PARSER_BUCKET_RATE;
+      if (bucket->tokens > PARSER_BUCKET_BURST * 1000) {
+        bucket->tokens = PARSER_BUCKET_BURST * 1000;
+      }
+    }
+  }
+  bucket->refill = now_times;
+
+  if (bucket->tokens < 1000) {
+    return false;
+  }
+  bucket->tokens -= 1000;
+  return true;
+}
+
+/**
+ *Put a copy of a message into the queue of its ingress class.
+ */
+static void
+olsr_parser_enqueue(union olsr_message *m, uint32_t msgsize, struct interface *in_if, union olsr_ip_addr *from_addr)
+{
+  const enum parser_class cls = olsr_parser_classify(m);
+  struct parser_class_stats *stats = &parser_class_stats[cls];
+  struct parser_queue *queue = &parser_queues[cls];
+  struct parser_queue_entry *entry;
+  union olsr_ip_addr originator;
+
+  /* Should be the same for IPv4 and IPv6 */
+  memcpy(&originator, &m->v4.originator, OLSR_IPSIZE);
+  if (!olsr_parser_take_token(&originator) && parser_overload) {
+    stats->rate_drops++;
+    return;
+  }
+
+  if (stats->length >= PARSER_QUEUE_LIMIT) {
+    stats->full_drops++;
+    return;
+  }
+
+  entry = olsr_malloc(sizeof(*entry) + msgsize, "Input queue entry");
+  entry->in_if = in_if;
+  entry->from_addr = *from_addr;
+  memcpy(entry->msg, m, msgsize);
+
+  *queue->tail = entry;
+  queue->tail = &entry->next;
+
+  stats->queued++;
+  stats->length++;
+}
+
+/**
+ *Hand a message to the parse functions of its type and to
+ *the promiscuous ones, and account the processing time.
+ *
+ *@return false if one of the functions does not want the message to be forwarded
+ */
+static bool
+olsr_parser_dispatch(union olsr_message *m, struct interface *in_if, union olsr_ip_addr *from_addr)
+{
+  /* Should be the same for IPv4 and IPv6 */
+  const uint8_t type = m->v4.olsr_msgtype;
+  const struct parse_function_vector *vector = &parse_vectors[type];
+  struct parser_msg_stats *stats = &parser_stats[type];
+  struct timeval start, end;
+  unsigned int i, bucket;
+  long usec;
+  bool forward = true;
+
+  if (vector->count + parse_promiscuous.count == 0) {
+    return true;
+  }
+
+  gettimeofday(&start, NULL);
+
+  for (i = 0; i < vector->count; i++) {
+    if (!vector->functions[i](m, in_if, from_addr)) {
+      forward = false;
+    }
+  }
+  for (i = 0; i < parse_promiscuous.count; i++) {
+    if (!parse_promiscuous.functions[i](m, in_if, from_addr)) {
+      forward = false;
+    }
+  }
+
+  gettimeofday(&end, NULL);
+  usec = (end.tv_sec - start.tv_sec) * 1000000 + (end.tv_usec - start.tv_usec);
+
+  for (bucket = 0; bucket < PARSER_HISTOGRAM_BUCKETS - 1 && usec >= (1L << (2 * bucket)); bucket++);
+  stats->histogram[bucket]++;
+  stats->processed++;
+
+  return forward;
+}
+
 void
 olsr_preprocessor_add_function(preprocessor_function * function)
 {
@@ -267,7 +749,6 @@ parse_packet(struct olsr *olsr, int size, struct interface *in_if, union olsr_ip
   uint32_t count;
   uint32_t msgsize;
   uint16_t seqno;
-  struct parse_function_entry *entry;
   struct packetparser_function_entry *packetparser;
 
   count = size - ((char *)m - (char *)olsr);
@@ -300,7 +781,7 @@ parse_packet(struct olsr *olsr, int size, struct interface *in_if, union olsr_ip
    * Hysteresis update - for every OLSR package
    */
   if (olsr_cnf->use_hysteresis) {
-    if (olsr_cnf->ip_version == AF_INET) {
+    if (OLSR_IP_VERSION == AF_INET) {
       /* IPv4 */
       update_hysteresis_incoming(from_addr, in_if, olsr->olsr_seqno);
     } else {
@@ -310,14 +791,13 @@ parse_packet(struct olsr *olsr, int size, struct interface *in_if, union olsr_ip
   }
 
   for (; count > 0; m = (union olsr_message *)((char *)m + (msgsize))) {
-    bool forward = true;
     bool validated;
 
     /* minimum message size is 8 + ipsize */
-    if (count < 8 + olsr_cnf->ipsize)
+    if (count < 8 + OLSR_IPSIZE)
       break;
 
-    if (olsr_cnf->ip_version == AF_INET) {
+    if (OLSR_IP_VERSION == AF_INET) {
       msgsize = ntohs(m->v4.olsr_msgsize);
       seqno = ntohs(m->v4.seqno);
     }
@@ -327,7 +807,7 @@ parse_packet(struct olsr *olsr, int size, struct interface *in_if, union olsr_ip
     }
 
     /* sanity check for msgsize */
-    if (msgsize < 8 + olsr_cnf->ipsize) {
+    if (msgsize < 8 + OLSR_IPSIZE) {
       struct ipaddr_str buf;
       union olsr_ip_addr *msgorig = (union olsr_ip_addr *) &m->v4.originator;
       OLSR_PRINTF(1, "Error, OLSR message from %s (type %d) is to small (%d bytes)"
@@ -365,6 +845,9 @@ parse_packet(struct olsr *olsr, int size, struct interface *in_if, union olsr_ip
 
     count -= msgsize;
 
+    /* Should be the same for IPv4 and IPv6 */
+    parser_stats[m->v4.olsr_msgtype].received++;
+
     /*RFC 3626 section 3.4:
      *  2    If the time to live of the message is less than or equal to
      *  '0' (zero), or if the message was sent by the receiving node
@@ -389,42 +872,85 @@ parse_packet(struct olsr *olsr, int size, struct interface *in_if, union olsr_ip
       continue;
     }
 
-    entry = parse_functions;
-    while (entry) {
-      /* Should be the same for IPv4 and IPv6 */
+    olsr_parser_enqueue(m, msgsize, in_if, from_addr);
+  }                             /* for olsr_msg */
+}
 
-      /* Promiscuous or exact match */
-      if ((entry->type == PROMISCUOUS) || (entry->type == m->v4.olsr_msgtype)) {
-        if (!entry->function(m, in_if, from_addr))
-          forward = false;
-      }
-      entry = entry->next;
+/**
+ *Process the queued messages, the highest ingress class first,
+ *until the CPU budget of the current poll interval is used up.
+ *The rest waits for the next interval.
+ */
+static void
+olsr_parser_run_queue(void)
+{
+  struct parser_queue_entry *entry;
+  union olsr_message *m;
+  struct timeval start, end;
+  long used = 0;
+  int cls;
+
+  if (TIME_DUE(parser_period_end) <= 0) {
+    parser_period_end = GET_TIMESTAMP(olsr_cnf->pollrate * MSEC_PER_SEC);
+    parser_budget = olsr_cnf->pollrate * USEC_PER_SEC * olsr_cnf->input_budget / 100;
+  }
+
+  gettimeofday(&start, NULL);
+
+  while (used < parser_budget) {
+    for (cls = 0; cls < PARSER_CLASSES && parser_queues[cls].head == NULL; cls++);
+    if (cls == PARSER_CLASSES) {
+      break;
     }
 
-    if (forward) {
-      olsr_forward_message(m, in_if, from_addr);
+    entry = parser_queues[cls].head;
+    parser_queues[cls].head = entry->next;
+    if (entry->next == NULL) {
+      parser_queues[cls].tail = &parser_queues[cls].head;
     }
-  }                             /* for olsr_msg */
+    parser_class_stats[cls].length--;
+    parser_class_stats[cls].processed++;
+
+    m = (union olsr_message *)entry->msg;
+    if (olsr_parser_dispatch(m, entry->in_if, &entry->from_addr)) {
+      olsr_forward_message(m, entry->in_if, &entry->from_addr);
+    }
+    olsr_parser_arena_reset();
+    free(entry);
+
+    gettimeofday(&end, NULL);
+    used = (end.tv_sec - start.tv_sec) * USEC_PER_SEC + (end.tv_usec - start.tv_usec);
+  }
+  parser_budget -= used;
+
+  parser_overload = false;
+  for (cls = 0; cls < PARSER_CLASSES; cls++) {
+    if (parser_queues[cls].head != NULL) {
+      parser_overload = true;
+    }
+  }
+
+  if (parser_overload && parser_queue_timer == NULL) {
+    used = TIME_DUE(parser_period_end);
+    olsr_set_timer(&parser_queue_timer, used > 0 ? used : 0, 0, OLSR_TIMER_ONESHOT,
+                   &olsr_parser_queue_expired, NULL, parser_queue_timer_cookie);
+  }
 }
 
 /**
- *Processing OLSR data from socket. Reading data, setting
- *wich interface received the message, Sends IPC(if used)
- *and passes the packet on to parse_packet().
+ *Reading data from socket, setting wich interface received
+ *the message and passing the packets on to parse_packet().
  *
  *@param fd the filedescriptor that data should be read from.
- *@param data unused
- *@param flags unused
  */
-void
-olsr_input(int fd, void *data __attribute__ ((unused)), unsigned int flags __attribute__ ((unused)))
+static void
+olsr_input_read(int fd)
 {
   struct interface *olsr_in_if;
   union olsr_ip_addr from_addr;
   struct preprocessor_function_entry *entry;
   char *packet;
-
-  cpu_overload_exit = 0;
+  int reads = 0;
 
   for (;;) {
     struct ipaddr_str buf;
@@ -433,7 +959,7 @@ olsr_input(int fd, void *data __attribute__ ((unused)), unsigned int flags __att
     socklen_t fromlen;
     int cc;
 
-    if (32 < ++cpu_overload_exit) {
+    if (PARSER_READ_LIMIT < ++reads) {
       OLSR_PRINTF(1, "CPU overload detected, ending olsr_input() loop\n");
       break;
     }
@@ -450,7 +976,7 @@ olsr_input(int fd, void *data __attribute__ ((unused)), unsigned int flags __att
       }
       break;
     }
-    if (olsr_cnf->ip_version == AF_INET) {
+    if (OLSR_IP_VERSION == AF_INET) {
       /* IPv4 sender address */
       void * src = &((struct sockaddr_in *)&from)->sin_addr;
       memcpy(&from_addr.v4, src, sizeof(from_addr.v4));
@@ -465,9 +991,9 @@ olsr_input(int fd, void *data __attribute__ ((unused)), unsigned int flags __att
         olsr_ip_to_string(&buf, &from_addr));
 #endif /* DEBUG */
 
-    if ((olsr_cnf->ip_version == AF_INET) && (fromlen != sizeof(struct sockaddr_in)))
+    if ((OLSR_IP_VERSION == AF_INET) && (fromlen != sizeof(struct sockaddr_in)))
       break;
-    else if ((olsr_cnf->ip_version == AF_INET6) && (fromlen != sizeof(struct sockaddr_in6)))
+    else if ((OLSR_IP_VERSION == AF_INET6) && (fromlen != sizeof(struct sockaddr_in6)))
       break;
 
     /* are we talking to ourselves? */
@@ -503,6 +1029,22 @@ olsr_input(int fd, void *data __attribute__ ((unused)), unsigned int flags __att
   }
 }
 
+/**
+ *Processing OLSR data from socket. Reads the received packets
+ *into the ingress queues and processes as many messages as the
+ *CPU budget allows.
+ *
+ *@param fd the filedescriptor that data should be read from.
+ *@param data unused
+ *@param flags unused
+ */
+void
+olsr_input(int fd, void *data __attribute__ ((unused)), unsigned int flags __attribute__ ((unused)))
+{
+  olsr_input_read(fd);
+  olsr_parser_run_queue();
+}
+
 /**
  *Processing OLSR data from socket. Reading data, setting
  *wich interface received the message, Sends IPC(if used)
@@ -527,10 +1069,10 @@ olsr_input_hostemu(int fd, void *data __attribute__ ((unused)), unsigned int fla
   /* Host emulator receives IP address first to emulate
      direct link */
 
-  int cc = recv(fd, (void*)from_addr.v6.s6_addr, olsr_cnf->ipsize, 0);
-  if (cc != (int)olsr_cnf->ipsize) {
+  int cc = recv(fd, (void*)from_addr.v6.s6_addr, OLSR_IPSIZE, 0);
+  if (cc != (int)OLSR_IPSIZE) {
     fprintf(stderr, "Error receiving host-client IP hook(%d) %s!\n", cc, strerror(errno));
-    memcpy(&from_addr, &((struct olsr *)inbuf)->olsr_msg->originator, olsr_cnf->ipsize);
+    memcpy(&from_addr, &((struct olsr *)inbuf)->olsr_msg->originator, OLSR_IPSIZE);
   }
 
   /* are we talking to ourselves? */
@@ -593,7 +1135,7 @@ olsr_input_hostemu(int fd, void *data __attribute__ ((unused)), unsigned int fla
    * cc - bytes read
    */
   parse_packet((struct olsr *)inbuf, cc, olsr_in_if, &from_addr);
-
+  olsr_parser_run_queue();
 }
 
 /*
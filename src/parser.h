@@ -56,6 +56,55 @@ struct parse_function_entry {
   struct parse_function_entry *next;
 };
 
+/* Parse functions of one message type, rebuilt from the registered entries */
+struct parse_function_vector {
+  unsigned int count;
+  parse_function **functions;
+};
+
+/*
+ * Processing time histogram, bucket n counts messages which took
+ * less than 4^n microseconds. The last bucket takes everything above.
+ */
+#define PARSER_HISTOGRAM_BUCKETS 8
+
+struct parser_msg_stats {
+  uint32_t received;                   /* messages which passed the sanity checks */
+  uint32_t processed;                  /* messages handed to the parse functions */
+  uint32_t histogram[PARSER_HISTOGRAM_BUCKETS];
+};
+
+/*
+ * Received messages are queued by ingress class. A class is only
+ * processed when the queues of all classes above it are empty.
+ */
+enum parser_class {
+  PARSER_CLASS_LINK,                   /* HELLOs and the TCs of our MPR selectors */
+  PARSER_CLASS_TOPOLOGY,               /* other TC, MID and HNA messages */
+  PARSER_CLASS_OTHER,                  /* plugin messages */
+  PARSER_CLASSES
+};
+
+/* Messages which may wait in the queue of one class */
+#define PARSER_QUEUE_LIMIT 256
+
+/*
+ * Token bucket of each originator, refilled with PARSER_BUCKET_RATE
+ * messages per second up to PARSER_BUCKET_BURST messages. Empty
+ * buckets only lead to drops while messages are left over from
+ * the last poll.
+ */
+#define PARSER_BUCKET_RATE 50
+#define PARSER_BUCKET_BURST 200
+
+struct parser_class_stats {
+  uint32_t queued;                     /* messages put into the queue */
+  uint32_t processed;                  /* messages taken out of the queue */
+  uint32_t rate_drops;                 /* originator exceeded its token bucket */
+  uint32_t full_drops;                 /* queue was at PARSER_QUEUE_LIMIT */
+  uint32_t length;                     /* messages waiting now */
+};
+
 typedef char *preprocessor_function(char *packet, struct interface *, union olsr_ip_addr *, int *length);
 
 struct preprocessor_function_entry {
@@ -82,6 +131,17 @@ void olsr_parser_add_function(parse_function, uint32_t);
 
 int olsr_parser_remove_function(parse_function, uint32_t);
 
+const struct parser_msg_stats *olsr_parser_get_stats(uint8_t);
+
+const struct parser_class_stats *olsr_parser_get_class_stats(enum parser_class);
+
+const char *olsr_parser_class_to_string(enum parser_class);
+
+void olsr_parser_flush_interface(const struct interface *);
+
+/* transient memory, released when the current message has been processed */
+void *olsr_parser_arena_alloc(size_t);
+
 void olsr_preprocessor_add_function(preprocessor_function);
 
 int olsr_preprocessor_remove_function(preprocessor_function);
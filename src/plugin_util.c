@@ -74,11 +74,11 @@ set_plugin_ipaddress(const char *value, void *data, set_plugin_parameter_addon a
 {
   char buf[INET6_ADDRSTRLEN];
   union olsr_ip_addr ip_addr;
-  if (inet_pton(olsr_cnf->ip_version, value, &ip_addr) <= 0) {
+  if (inet_pton(OLSR_IP_VERSION, value, &ip_addr) <= 0) {
     OLSR_PRINTF(0, "Illegal IP address \"%s\"", value);
     return 1;
   }
-  inet_ntop(olsr_cnf->ip_version, &ip_addr, buf, sizeof(buf));
+  inet_ntop(OLSR_IP_VERSION, &ip_addr, buf, sizeof(buf));
   if (data != NULL) {
     union olsr_ip_addr *v = data;
     *v = ip_addr;
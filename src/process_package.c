@@ -45,6 +45,8 @@
 #include "lq_packet.h"
 #include "hysteresis.h"
 #include "two_hop_neighbor_table.h"
+#include "mpr.h"
+#include "lq_mpr.h"
 #include "tc_set.h"
 #include "mpr_selector_set.h"
 #include "mid_set.h"
@@ -127,6 +129,7 @@ process_message_neighbors(struct neighbor_entry *neighbor, const struct hello_me
 
             if (walker->neighbor == neighbor) {
               walker->path_linkcost = LINK_COST_BROKEN;
+              olsr_lq_mpr_touch_two_hop(two_hop_neighbor);
             }
           }
         }
@@ -230,6 +233,7 @@ process_message_neighbors(struct neighbor_entry *neighbor, const struct hello_me
               walker->path_linkcost = new_path_linkcost;
 
               walker->saved_path_linkcost = new_path_linkcost;
+              olsr_lq_mpr_touch_two_hop(two_hop_neighbor);
 
               changes_neighborhood = true;
               changes_topology = true;
@@ -279,6 +283,9 @@ linking_this_2_entries(struct neighbor_entry *neighbor, struct neighbor_2_entry
 
   /*increment the pointer counter */
   two_hop_neighbor->neighbor_2_pointer++;
+
+  olsr_mpr_link_two_hop(neighbor, two_hop_neighbor);
+  olsr_lq_mpr_touch_two_hop(two_hop_neighbor);
 }
 
 /**
@@ -296,7 +303,7 @@ lookup_mpr_status(const struct hello_message *message, const struct interface *i
 
   for (neighbors = message->neighbors; neighbors; neighbors = neighbors->next) {
     if ( neighbors->link != UNSPEC_LINK
-        && (olsr_cnf->ip_version == AF_INET
+        && (OLSR_IP_VERSION == AF_INET
             ? ip4equal(&neighbors->address.v4, &in_if->ip_addr.v4)
             : ip6equal(&neighbors->address.v6, &in_if->int6_addr.sin6_addr))) {
 
@@ -352,7 +359,7 @@ deserialize_hello(struct hello_message *hello, const void *ser)
 
     limit2 += size2;
     while (curr < limit2) {
-      struct hello_neighbor *neigh = olsr_malloc_hello_neighbor("HELLO deserialization");
+      struct hello_neighbor *neigh = olsr_parser_alloc_hello_neighbor();
       pkt_get_ipaddress(&curr, &neigh->address);
       if (type == LQ_HELLO_MESSAGE) {
         olsr_deserialize_hello_lq_pair(&curr, neigh);
@@ -396,12 +403,20 @@ olsr_init_package_process(void)
   } else {
     olsr_parser_add_function(&olsr_input_hello, LQ_HELLO_MESSAGE);
     olsr_parser_add_function(&olsr_input_tc, LQ_TC_MESSAGE);
+    olsr_parser_add_function(&olsr_input_tc_delta, LQ_TC_DELTA_MESSAGE);
+    olsr_parser_add_function(&olsr_input_tc, LQ_TC_COMPACT_MESSAGE);
   }
 
   olsr_parser_add_function(&olsr_input_mid, MID_MESSAGE);
   olsr_parser_add_function(&olsr_input_hna, HNA_MESSAGE);
+  olsr_parser_add_function(&olsr_input_mid, MID_COMPACT_MESSAGE);
+  olsr_parser_add_function(&olsr_input_hna, HNA_COMPACT_MESSAGE);
 }
 
+/*
+ * The neighbors of the message come from the parser arena,
+ * they are released by the parser and not here.
+ */
 void
 olsr_hello_tap(struct hello_message *message, struct interface *in_if, const union olsr_ip_addr *from_addr)
 {
@@ -490,8 +505,6 @@ olsr_hello_tap(struct hello_message *message, struct interface *in_if, const uni
   /* Process changes immediately in case of MPR updates */
   olsr_process_changes();
 
-  olsr_free_hello_packet(message);
-
   return;
 }
 
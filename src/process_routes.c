@@ -168,7 +168,7 @@ olsr_delete_kernel_route(struct rt_entry *rt)
   }
 
   if (!olsr_cnf->host_emul) {
-    int16_t error = olsr_cnf->ip_version == AF_INET ? olsr_delroute_function(rt) : olsr_delroute6_function(rt);
+    int16_t error = OLSR_IP_VERSION == AF_INET ? olsr_delroute_function(rt) : olsr_delroute6_function(rt);
 
     if (error != 0) {
       const char *const err_msg = strerror(errno);
@@ -204,7 +204,7 @@ olsr_add_kernel_route(struct rt_entry *rt)
     }
   }
   if (!olsr_cnf->host_emul) {
-    int16_t error = (olsr_cnf->ip_version == AF_INET) ? olsr_addroute_function(rt) : olsr_addroute6_function(rt);
+    int16_t error = (OLSR_IP_VERSION == AF_INET) ? olsr_addroute_function(rt) : olsr_addroute6_function(rt);
 
     if (error != 0) {
       const char *const err_msg = strerror(errno);
@@ -260,7 +260,7 @@ olsr_chg_kernel_routes(struct list_node *head_node)
     *        As NLM_F_REPLACE is not supported with IPv6, or simply of no use with varying route metrics.
     *        We also actively delete routes if custom route functions are in place. (e.g. quagga plugin)
     */
-    if (((olsr_cnf->ip_version != AF_INET ) || (olsr_cnf->fib_metric != FIBM_FLAT)
+    if (((OLSR_IP_VERSION != AF_INET ) || (olsr_cnf->fib_metric != FIBM_FLAT)
          || (olsr_addroute_function != olsr_ioctl_add_route) || (olsr_addroute6_function != olsr_ioctl_add_route6)
          || (olsr_delroute_function != olsr_ioctl_del_route) || (olsr_delroute6_function != olsr_ioctl_del_route6))
         && (rt->rt_nexthop.iif_index > -1)) {
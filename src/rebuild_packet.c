@@ -46,6 +46,47 @@
 #include "mid_set.h"
 #include "mantissa.h"
 #include "net_olsr.h"
+#include "lq_packet.h"
+
+/**
+ *Process/rebuild a MID message with compact addresses.
+ *@param mmsg the mid_message struct in wich infomation
+ *is to be put.
+ *@param m the entire OLSR message revieved.
+ *@return false on error
+ */
+
+static bool
+mid_compact_chgestruct(struct mid_message *mmsg, const union olsr_message *m)
+{
+  const uint8_t *curr = (const uint8_t *)m;
+  struct olsr_addr_block block;
+  struct mid_alias *alias;
+  uint16_t size;
+  int i;
+
+  pkt_ignore_u8(&curr);
+  pkt_get_reltime(&curr, &mmsg->vtime);
+  pkt_get_u16(&curr, &size);
+  pkt_get_ipaddress(&curr, &mmsg->mid_origaddr);
+  pkt_get_u8(&curr, &mmsg->mid_ttl);
+  pkt_get_u8(&curr, &mmsg->mid_hopcnt);
+  pkt_get_u16(&curr, &mmsg->mid_seqno);
+  mmsg->addr = mmsg->mid_origaddr;
+
+  if (!pkt_get_addr_block(&curr, (const uint8_t *)m + size, &block)) {
+    return false;
+  }
+
+  for (i = 0; i < block.count; i++) {
+    alias = olsr_malloc(sizeof(struct mid_alias), "MID chgestruct 3");
+
+    olsr_addr_block_get(&block, i, &alias->alias_addr);
+    alias->next = mmsg->mid_addr;
+    mmsg->mid_addr = alias;
+  }
+  return true;
+}
 
 /**
  *Process/rebuild MID message. Converts the OLSR
@@ -53,23 +94,31 @@
  *@param mmsg the mid_message struct in wich infomation
  *is to be put.
  *@param m the entire OLSR message revieved.
- *@return negative on error
+ *@return false on error
  */
 
-void
+bool
 mid_chgestruct(struct mid_message *mmsg, const union olsr_message *m)
 {
   int i;
   struct mid_alias *alias, *alias_tmp;
   int no_aliases;
 
+  mmsg->mid_addr = NULL;
+
   /* Checking if everything is ok */
-  if ((!m) || (m->v4.olsr_msgtype != MID_MESSAGE))
-    return;
+  if (!m)
+    return false;
+
+  if (m->v4.olsr_msgtype == MID_COMPACT_MESSAGE)
+    return mid_compact_chgestruct(mmsg, m);
+
+  if (m->v4.olsr_msgtype != MID_MESSAGE)
+    return false;
 
   alias = NULL;
 
-  if (olsr_cnf->ip_version == AF_INET) {
+  if (OLSR_IP_VERSION == AF_INET) {
     /* IPv4 */
     const struct midaddr *maddr = m->v4.message.mid.mid_addr;
     /*
@@ -158,6 +207,7 @@ mid_chgestruct(struct mid_message *mmsg, const union olsr_message *m)
     }
   }
 
+  return true;
 }
 
 /*
@@ -45,7 +45,7 @@
 #include "olsr_protocol.h"
 #include "packet.h"
 
-void mid_chgestruct(struct mid_message *, const union olsr_message *);
+bool mid_chgestruct(struct mid_message *, const union olsr_message *);
 
 void hello_chgestruct(struct hello_message *, const union olsr_message *);
 
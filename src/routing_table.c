@@ -459,7 +459,7 @@ olsr_cmp_rtp(const struct rt_path *rtp1, const struct rt_path *rtp2, const struc
   }
 
   /* originator (which is guaranteed to be unique) is final tie breaker */
-  if (memcmp(&rtp1->rtp_originator, &rtp2->rtp_originator, olsr_cnf->ipsize) < 0) {
+  if (memcmp(&rtp1->rtp_originator, &rtp2->rtp_originator, OLSR_IPSIZE) < 0) {
     return true;
   }
 
@@ -545,6 +545,9 @@ olsr_insert_routing_table(union olsr_ip_addr *dst, int plen, union olsr_ip_addr
    * be explored during SPF run.
    */
   tc = olsr_locate_tc_entry(originator);
+  if (!tc) {
+    return NULL;
+  }
 
   /*
    * first check if there is a rt_path for the prefix.
@@ -196,6 +196,7 @@ union olsr_kernel_route {
 extern struct avl_tree routingtree;
 extern unsigned int routingtree_version;
 extern struct olsr_cookie_info *rt_mem_cookie;
+extern struct olsr_cookie_info *rtp_mem_cookie;
 
 void olsr_init_routing_table(void);
 
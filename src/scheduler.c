@@ -490,6 +490,9 @@ olsr_scheduler(void)
       increase_local_ansn();
       OLSR_PRINTF(3, "ANSN UPDATED %d\n\n", get_local_ansn());
       link_changes = false;
+
+      /* and tell the others right away */
+      olsr_trigger_tc();
     }
 
     /* Read incoming data and handle it immediiately */
@@ -54,6 +54,7 @@
 #include "olsr_cookie.h"
 #include "duplicate_set.h"
 #include "gateway.h"
+#include "parser.h"
 
 #include <assert.h>
 
@@ -145,6 +146,14 @@ olsr_add_tc_entry(union olsr_ip_addr *adr)
   if (ipequal(&olsr_cnf->main_addr, &all_zero)) {
     return NULL;
   }
+
+  /*
+   * Refuse new originators beyond the budget, but never ourselves.
+   */
+  if (olsr_cookie_budget_exhausted(tc_mem_cookie) && !ipequal(adr, &olsr_cnf->main_addr)) {
+    tc_mem_cookie->ci_refused++;
+    return NULL;
+  }
 #ifdef DEBUG
   OLSR_PRINTF(1, "TC: add entry %s\n", olsr_ip_to_string(&buf, adr));
 #endif /* DEBUG */
@@ -157,6 +166,13 @@ olsr_add_tc_entry(union olsr_ip_addr *adr)
   /* Fill entry */
   tc->addr = *adr;
   tc->vertex_node.key = &tc->addr;
+  tc->node_id = olsr_intern_node_id(adr);
+  olsr_node_by_id(tc->node_id)->tc = tc;
+
+  /*
+   * Unreachable until the next SPF run.
+   */
+  tc->path_cost = ROUTE_COST_BROKEN;
 
   /*
    * Insert into the global tc tree.
@@ -167,7 +183,7 @@ olsr_add_tc_entry(union olsr_ip_addr *adr)
   /*
    * Initialize subtrees for edges and prefixes.
    */
-  avl_init(&tc->edge_tree, avl_comp_default);
+  avl_init(&tc->edge_tree, avl_comp_node_id);
   avl_init(&tc->prefix_tree, avl_comp_prefix_default);
 
   /*
@@ -201,6 +217,9 @@ olsr_init_tc(void)
   tc_mem_cookie = olsr_alloc_cookie("tc_entry", OLSR_COOKIE_TYPE_MEMORY);
   olsr_cookie_set_memory_size(tc_mem_cookie, sizeof(struct tc_entry));
 
+  olsr_cookie_set_budget(tc_mem_cookie, olsr_cnf->max_tc_entries);
+  olsr_cookie_set_budget(tc_edge_mem_cookie, olsr_cnf->max_tc_edges);
+
   /*
    * Add a TC entry for ourselves.
    */
@@ -266,6 +285,7 @@ olsr_unlock_tc_entry(struct tc_entry *tc)
   /*
    * All references are gone.
    */
+  olsr_release_node_id(tc->node_id);
   olsr_cookie_free(tc_mem_cookie, tc);
 }
 
@@ -305,6 +325,9 @@ olsr_delete_tc_entry(struct tc_entry *tc)
   tc->validity_timer = NULL;
 
   avl_delete(&tc_tree, &tc->vertex_node);
+  if (olsr_node_by_id(tc->node_id)->tc == tc) {
+    olsr_node_by_id(tc->node_id)->tc = NULL;
+  }
   olsr_unlock_tc_entry(tc);
 }
 
@@ -324,6 +347,18 @@ olsr_lookup_tc_entry(union olsr_ip_addr *adr)
   return (node ? vertex_tree2tc(node) : NULL);
 }
 
+/**
+ * Look up a entry from the TC tree based on its node id
+ *
+ * @param id the node id to look for
+ * @return the entry found or NULL
+ */
+struct tc_entry *
+olsr_lookup_tc_entry_by_id(olsr_node_id id)
+{
+  return (id != OLSR_NODE_ID_NONE ? olsr_node_by_id(id)->tc : NULL);
+}
+
 /*
  * Lookup a tc entry. Creates one if it does not exist yet.
  */
@@ -350,7 +385,7 @@ olsr_tc_edge_to_string(struct tc_edge_entry *tc_edge)
   struct lqtextbuffer lqbuffer1, lqbuffer2;
 
   snprintf(buf, sizeof(buf), "%s > %s, cost (%6s) %s", olsr_ip_to_string(&addrbuf, &tc->addr),
-           olsr_ip_to_string(&dstbuf, &tc_edge->T_dest_addr), get_tc_edge_entry_text(tc_edge, '/', &lqbuffer1),
+           olsr_ip_to_string(&dstbuf, olsr_node_id_to_addr(tc_edge->T_dest_id)), get_tc_edge_entry_text(tc_edge, '/', &lqbuffer1),
            get_linkcost_text(tc_edge->cost, false, &lqbuffer2));
 
   return buf;
@@ -417,6 +452,48 @@ olsr_calc_tc_edge_entry_etx(struct tc_edge_entry *tc_edge)
   }
 
   tc_edge->cost = olsr_calc_tc_cost(tc_edge);
+  olsr_spf_update_edge_cost(tc_edge);
+  return true;
+}
+
+/**
+ * Make room in the edge budget for an edge of a given tc entry.
+ * Drops all edges of the most distant node, as long as that node is
+ * further away than the one asking. Our own edges always get a slot.
+ *
+ * @param tc the tc entry which wants to add an edge
+ * @return true if there is room for another edge
+ */
+static bool
+olsr_admit_tc_edge(struct tc_entry *tc)
+{
+  struct tc_entry *tc_iter, *victim = NULL;
+  struct tc_edge_entry *tc_edge;
+
+  if (!olsr_cookie_budget_exhausted(tc_edge_mem_cookie) || tc == tc_myself) {
+    return true;
+  }
+
+  OLSR_FOR_ALL_TC_ENTRIES(tc_iter) {
+    if (tc_iter == tc_myself || tc_iter->edge_tree.count == 0) {
+      continue;
+    }
+    if (!victim || tc_iter->path_cost > victim->path_cost) {
+      victim = tc_iter;
+    }
+  } OLSR_FOR_ALL_TC_ENTRIES_END(tc_iter);
+
+  if (!victim || victim == tc || victim->path_cost <= tc->path_cost) {
+    tc_edge_mem_cookie->ci_refused++;
+    return false;
+  }
+
+  OLSR_FOR_ALL_TC_EDGE_ENTRIES(victim, tc_edge) {
+    olsr_delete_tc_edge_entry(tc_edge);
+    tc_edge_mem_cookie->ci_evicted++;
+  } OLSR_FOR_ALL_TC_EDGE_ENTRIES_END(victim, tc_edge);
+
+  changes_topology = true;
   return true;
 }
 
@@ -437,21 +514,26 @@ olsr_add_tc_edge_entry(struct tc_entry *tc, union olsr_ip_addr *addr, uint16_t a
   struct tc_entry *tc_neighbor;
   struct tc_edge_entry *tc_edge, *tc_edge_inv;
 
+  if (!olsr_admit_tc_edge(tc)) {
+    return NULL;
+  }
+
   tc_edge = olsr_cookie_malloc(tc_edge_mem_cookie);
   if (!tc_edge) {
     return NULL;
   }
 
   /* Fill entry */
-  tc_edge->T_dest_addr = *addr;
+  tc_edge->T_dest_id = olsr_intern_node_id(addr);
   tc_edge->ansn = ansn;
-  tc_edge->edge_node.key = &tc_edge->T_dest_addr;
+  tc_edge->edge_node.key = &tc_edge->T_dest_id;
 
   /*
    * Insert into the edge tree.
    */
   avl_insert(&tc->edge_tree, &tc_edge->edge_node, AVL_DUP_NO);
   olsr_lock_tc_entry(tc);
+  olsr_spf_add_edge(tc_edge);
 
   /*
    * Connect backpointer.
@@ -462,16 +544,16 @@ olsr_add_tc_edge_entry(struct tc_entry *tc, union olsr_ip_addr *addr, uint16_t a
    * Check if the neighboring router and the inverse edge is in the lsdb.
    * Create short cuts to the inverse edge for faster SPF execution.
    */
-  tc_neighbor = olsr_lookup_tc_entry(&tc_edge->T_dest_addr);
+  tc_neighbor = olsr_lookup_tc_entry_by_id(tc_edge->T_dest_id);
   if (tc_neighbor) {
 #ifdef DEBUG
     OLSR_PRINTF(1, "TC:   found neighbor tc_entry %s\n", olsr_ip_to_string(&buf, &tc_neighbor->addr));
 #endif /* DEBUG */
 
-    tc_edge_inv = olsr_lookup_tc_edge(tc_neighbor, &tc->addr);
+    tc_edge_inv = olsr_lookup_tc_edge_by_id(tc_neighbor, tc->node_id);
     if (tc_edge_inv) {
 #ifdef DEBUG
-      OLSR_PRINTF(1, "TC:   found inverse edge for %s\n", olsr_ip_to_string(&buf, &tc_edge_inv->T_dest_addr));
+      OLSR_PRINTF(1, "TC:   found inverse edge for %s\n", olsr_ip_to_string(&buf, olsr_node_id_to_addr(tc_edge_inv->T_dest_id)));
 #endif /* DEBUG */
 
       /*
@@ -510,6 +592,8 @@ olsr_delete_tc_edge_entry(struct tc_edge_entry *tc_edge)
   OLSR_PRINTF(1, "TC: del edge entry %s\n", olsr_tc_edge_to_string(tc_edge));
 #endif /* DEBUG */
 
+  olsr_spf_del_edge(tc_edge);
+
   tc = tc_edge->tc;
   avl_delete(&tc->edge_tree, &tc_edge->edge_node);
   olsr_unlock_tc_entry(tc);
@@ -522,6 +606,7 @@ olsr_delete_tc_edge_entry(struct tc_edge_entry *tc_edge)
     tc_edge_inv->edge_inv = NULL;
   }
 
+  olsr_release_node_id(tc_edge->T_dest_id);
   olsr_cookie_free(tc_edge_mem_cookie, tc_edge);
 }
 
@@ -548,122 +633,307 @@ olsr_delete_outdated_tc_edges(struct tc_entry *tc)
   return retval;
 }
 
+/*
+ * A neighbor advertised in a TC message.
+ */
+struct tc_advertised_edge {
+  union olsr_ip_addr addr;
+  olsr_node_id id;                     /* OLSR_NODE_ID_NONE for unknown nodes */
+  const unsigned char *lq;             /* link quality data in the message */
+};
+
+static int
+olsr_comp_advertised_edge(const void *adv1, const void *adv2)
+{
+  return avl_comp_node_id(&((const struct tc_advertised_edge *)adv1)->id, &((const struct tc_advertised_edge *)adv2)->id);
+}
+
 /**
- * Delete all destinations that are inside the borders but
- * not updated in the last tc.
+ * Update a known edge from a received TC message.
  *
- * @param tc the entry to delete edges from
+ * @param tc_edge the edge to update
+ * @param ansn the ansn of the edge
+ * @param lq the link quality data of the edge in the message
+ * @return 1 if the edge changed 0 if not
+ */
+static int
+olsr_tc_update_edge(struct tc_edge_entry *tc_edge, uint16_t ansn, const unsigned char *lq)
+{
+  int edge_change = 0;
+
+  tc_edge->ansn = ansn;
+
+  /*
+   * Update link quality if configured.
+   */
+  if (olsr_cnf->lq_level > 0) {
+    olsr_deserialize_tc_lq_pair(&lq, tc_edge);
+  }
+
+  /*
+   * Update the etx.
+   */
+  if (olsr_calc_tc_edge_entry_etx(tc_edge)) {
+    edge_change = 1;
+  }
+#if defined DEBUG && DEBUG
+  if (edge_change) {
+    OLSR_PRINTF(1, "TC:   chg edge entry %s\n", olsr_tc_edge_to_string(tc_edge));
+  }
+#endif /* defined DEBUG && DEBUG */
+
+  return edge_change;
+}
+
+/**
+ * Create an edge for a neighbor advertised in a TC message.
+ *
+ * @param tc the TC entry
+ * @param ansn the ansn of the edge
+ * @param adv the advertised neighbor
+ * @return the new edge, NULL if it was not added
+ */
+static struct tc_edge_entry *
+olsr_tc_create_edge(struct tc_entry *tc, uint16_t ansn, struct tc_advertised_edge *adv)
+{
+  struct tc_edge_entry *tc_edge;
+  const unsigned char *lq = adv->lq;
+
+  /*
+   * Check if the address is allowed.
+   */
+  if (!olsr_validate_address(&adv->addr)) {
+    return NULL;
+  }
+
+  tc_edge = olsr_add_tc_edge_entry(tc, &adv->addr, ansn);
+  if (!tc_edge) {
+
+    /*
+     * Over budget.
+     */
+    return NULL;
+  }
+
+  if (olsr_cnf->lq_level > 0) {
+    olsr_deserialize_tc_lq_pair(&lq, tc_edge);
+  }
+  return tc_edge;
+}
+
+/**
+ * Merge the neighbors advertised in a TC message into the edge tree
+ * of its originator. The neighbors are sorted by node id, so both
+ * can be walked in order and every edge is added, updated or revoked
+ * in a single pass. Neighbors without a node id are new to the lsdb
+ * and get their edge afterwards.
+ *
+ * Edges which are not advertised are revoked if they are inside the
+ * borders and have an older ansn.
+ *
+ * @param tc the TC entry
  * @param ansn the advertised neighbor set sequence number
- * @param lower_border the lower border
+ * @param adv the advertised neighbors, gets sorted
+ * @param count the number of advertised neighbors
+ * @param lower_border the lower border, NULL if there is none
  * @param upper_border the upper border
- * @return 1 if any destinations were deleted 0 if not
+ * @return true if the topology changed
  */
-static int
-olsr_delete_revoked_tc_edges(struct tc_entry *tc, uint16_t ansn, union olsr_ip_addr *lower_border, union olsr_ip_addr *upper_border)
+static bool
+olsr_tc_merge_edges(struct tc_entry *tc, uint16_t ansn, struct tc_advertised_edge *adv, int count,
+                    union olsr_ip_addr *lower_border, union olsr_ip_addr *upper_border)
 {
+  struct avl_node *edge_node;
   struct tc_edge_entry *tc_edge;
-  int retval = 0;
+  union olsr_ip_addr *dest;
+  bool changes = false;
+  int i, known, cmp;
 
-  bool passedLowerBorder = false;
+  if (count > 1) {
+    qsort(adv, count, sizeof(*adv), &olsr_comp_advertised_edge);
+  }
 
-  OLSR_FOR_ALL_TC_EDGE_ENTRIES(tc, tc_edge) {
-    if (!passedLowerBorder) {
-      if (avl_comp_default(lower_border, &tc_edge->T_dest_addr) <= 0) {
-        passedLowerBorder = true;
-      } else {
+  /* unknown nodes sort first */
+  for (known = 0; known < count && adv[known].id == OLSR_NODE_ID_NONE; known++);
+
+  i = known;
+  edge_node = avl_walk_first(&tc->edge_tree);
+  while (edge_node || i < count) {
+    if (!edge_node) {
+      cmp = 1;
+    } else if (i == count) {
+      cmp = -1;
+    } else {
+      cmp = avl_comp_node_id(&edge_tree2tc_edge(edge_node)->T_dest_id, &adv[i].id);
+    }
+
+    if (cmp < 0) {
+
+      /*
+       * Not advertised - revoke it if it is inside the borders.
+       */
+      tc_edge = edge_tree2tc_edge(edge_node);
+      edge_node = avl_walk_next(edge_node);
+
+      if (!lower_border || !SEQNO_GREATER_THAN(ansn, tc_edge->ansn)) {
         continue;
       }
-    }
+      dest = olsr_node_id_to_addr(tc_edge->T_dest_id);
+      if (avl_comp_default(lower_border, dest) > 0 || avl_comp_default(upper_border, dest) <= 0) {
+        continue;
+      }
+      olsr_delete_tc_edge_entry(tc_edge);
+      changes = true;
+
+    } else if (cmp == 0) {
 
-    if (passedLowerBorder) {
-      if (avl_comp_default(upper_border, &tc_edge->T_dest_addr) <= 0) {
-        break;
+      /*
+       * We know this edge - update it.
+       */
+      tc_edge = edge_tree2tc_edge(edge_node);
+      tc_edge->delta_added = false;
+      if (olsr_tc_update_edge(tc_edge, ansn, adv[i].lq)) {
+        changes = true;
       }
+      i++;
+
+    } else {
+
+      /*
+       * Yet unknown - create it, unless the neighbor is listed twice.
+       */
+      if (i > known && adv[i - 1].id == adv[i].id) {
+        tc_edge = olsr_lookup_tc_edge_by_id(tc, adv[i].id);
+        if (tc_edge && olsr_tc_update_edge(tc_edge, ansn, adv[i].lq)) {
+          changes = true;
+        }
+      } else if (olsr_tc_create_edge(tc, ansn, &adv[i])) {
+        changes = true;
+      }
+      i++;
     }
+  }
 
-    if (SEQNO_GREATER_THAN(ansn, tc_edge->ansn)) {
-      olsr_delete_tc_edge_entry(tc_edge);
-      retval = 1;
+  for (i = 0; i < known; i++) {
+    tc_edge = olsr_lookup_tc_edge(tc, &adv[i].addr);
+    if (tc_edge) {
+      tc_edge->delta_added = false;
+      if (olsr_tc_update_edge(tc_edge, ansn, adv[i].lq)) {
+        changes = true;
+      }
+    } else if (olsr_tc_create_edge(tc, ansn, &adv[i])) {
+      changes = true;
     }
   }
-  OLSR_FOR_ALL_TC_EDGE_ENTRIES_END(tc, tc_edge);
 
-  if (retval)
-    changes_topology = true;
-  return retval;
+  return changes;
 }
 
 /**
- * Update an edge registered on an entry.
- * Creates new edge-entries if not registered.
- * Bases update on a received TC message
+ * Merge the neighbors of an incremental TC message into the edge tree
+ * of its originator. The message lists every neighbor which was removed,
+ * added or changed since the full TC with the base ansn. Removed neighbors
+ * carry no link quality data.
  *
- * @param tc the TC entry to check
- * @param ansn the ansn of the edge
- * @param curr pointer to the packet
- * @param neighbor the neighbor of the edge
- * @return 1 if entries are added 0 if not
+ * Edges which are not listed are part of the base and stay, unless an
+ * earlier incremental TC added them.
+ *
+ * @param tc the TC entry
+ * @param ansn the advertised neighbor set sequence number
+ * @param adv the listed neighbors, gets sorted
+ * @param count the number of listed neighbors
+ * @return true if the topology changed
  */
-static int
-olsr_tc_update_edge(struct tc_entry *tc, uint16_t ansn, const unsigned char **curr, union olsr_ip_addr *neighbor)
+static bool
+olsr_tc_merge_delta(struct tc_entry *tc, uint16_t ansn, struct tc_advertised_edge *adv, int count)
 {
+  struct avl_node *edge_node;
   struct tc_edge_entry *tc_edge;
-  int edge_change;
-
-  edge_change = 0;
+  bool changes = false;
+  int i, known, cmp;
 
-  /*
-   * Fetch the per-edge data
-   */
-  pkt_get_ipaddress(curr, neighbor);
+  if (count > 1) {
+    qsort(adv, count, sizeof(*adv), &olsr_comp_advertised_edge);
+  }
 
-  /* First check if we know this edge */
-  tc_edge = olsr_lookup_tc_edge(tc, neighbor);
+  /* unknown nodes sort first */
+  for (known = 0; known < count && adv[known].id == OLSR_NODE_ID_NONE; known++);
+
+  i = known;
+  edge_node = avl_walk_first(&tc->edge_tree);
+  while (edge_node || i < count) {
+    if (!edge_node) {
+      cmp = 1;
+    } else if (i == count) {
+      cmp = -1;
+    } else {
+      cmp = avl_comp_node_id(&edge_tree2tc_edge(edge_node)->T_dest_id, &adv[i].id);
+    }
 
-  if (!tc_edge) {
+    if (cmp < 0) {
 
-    /*
-     * Yet unknown - create it.
-     * Check if the address is allowed.
-     */
-    if (!olsr_validate_address(neighbor)) {
-      return 0;
-    }
+      /*
+       * Not listed - only edges added by an older delta go away.
+       */
+      tc_edge = edge_tree2tc_edge(edge_node);
+      edge_node = avl_walk_next(edge_node);
 
-    tc_edge = olsr_add_tc_edge_entry(tc, neighbor, ansn);
+      if (tc_edge->delta_added) {
+        olsr_delete_tc_edge_entry(tc_edge);
+        changes = true;
+      }
 
-    olsr_deserialize_tc_lq_pair(curr, tc_edge);
-    edge_change = 1;
+    } else if (cmp == 0) {
 
-  } else {
+      /*
+       * We know this edge - remove or update it.
+       */
+      tc_edge = edge_tree2tc_edge(edge_node);
+      edge_node = avl_walk_next(edge_node);
+
+      if (!adv[i].lq) {
+        olsr_delete_tc_edge_entry(tc_edge);
+        changes = true;
+      } else if (olsr_tc_update_edge(tc_edge, ansn, adv[i].lq)) {
+        changes = true;
+      }
+      i++;
 
-    /*
-     * We know this edge - Update entry.
-     */
-    tc_edge->ansn = ansn;
+    } else {
 
-    /*
-     * Update link quality if configured.
-     */
-    if (olsr_cnf->lq_level > 0) {
-      olsr_deserialize_tc_lq_pair(curr, tc_edge);
+      /*
+       * Yet unknown - create it, unless it was removed or listed twice.
+       */
+      if (adv[i].lq && (i == known || adv[i - 1].id != adv[i].id)) {
+        tc_edge = olsr_tc_create_edge(tc, ansn, &adv[i]);
+        if (tc_edge) {
+          tc_edge->delta_added = true;
+          changes = true;
+        }
+      }
+      i++;
     }
+  }
 
-    /*
-     * Update the etx.
-     */
-    if (olsr_calc_tc_edge_entry_etx(tc_edge)) {
-      edge_change = 1;
+  for (i = 0; i < known; i++) {
+    if (!adv[i].lq) {
+      continue;
     }
-#if defined DEBUG && DEBUG
-    if (edge_change) {
-      OLSR_PRINTF(1, "TC:   chg edge entry %s\n", olsr_tc_edge_to_string(tc_edge));
+    tc_edge = olsr_lookup_tc_edge(tc, &adv[i].addr);
+    if (tc_edge) {
+      if (olsr_tc_update_edge(tc_edge, ansn, adv[i].lq)) {
+        changes = true;
+      }
+    } else {
+      tc_edge = olsr_tc_create_edge(tc, ansn, &adv[i]);
+      if (tc_edge) {
+        tc_edge->delta_added = true;
+        changes = true;
+      }
     }
-#endif /* defined DEBUG && DEBUG */
-
   }
 
-  return edge_change;
+  return changes;
 }
 
 /**
@@ -675,10 +945,30 @@ olsr_tc_update_edge(struct tc_entry *tc, uint16_t ansn, const unsigned char **cu
  */
 struct tc_edge_entry *
 olsr_lookup_tc_edge(struct tc_entry *tc, union olsr_ip_addr *edge_addr)
+{
+  olsr_node_id id;
+
+  id = olsr_lookup_node_id(edge_addr);
+  if (id == OLSR_NODE_ID_NONE) {
+    return NULL;
+  }
+
+  return olsr_lookup_tc_edge_by_id(tc, id);
+}
+
+/**
+ * Lookup an edge hanging off a TC entry by the node id of its destination.
+ *
+ * @param tc the entry to check
+ * @param id the node id of the destination to check for
+ * @return a pointer to the tc_edge found - or NULL
+ */
+struct tc_edge_entry *
+olsr_lookup_tc_edge_by_id(struct tc_entry *tc, olsr_node_id id)
 {
   struct avl_node *edge_node;
 
-  edge_node = avl_find(&tc->edge_tree, edge_addr);
+  edge_node = avl_find(&tc->edge_tree, &id);
 
   return (edge_node ? edge_tree2tc_edge(edge_node) : NULL);
 }
@@ -692,7 +982,7 @@ olsr_print_tc_table(void)
 {
   /* The whole function makes no sense without it. */
   struct tc_entry *tc;
-  const int ipwidth = olsr_cnf->ip_version == AF_INET ? (INET_ADDRSTRLEN - 1) : (INET6_ADDRSTRLEN - 1);
+  const int ipwidth = OLSR_IP_VERSION == AF_INET ? (INET_ADDRSTRLEN - 1) : (INET6_ADDRSTRLEN - 1);
 
   OLSR_PRINTF(1, "\n--- %s ------------------------------------------------- TOPOLOGY\n\n" "%-*s %-*s %-14s  %s\n",
               olsr_wallclock_string(), ipwidth, "Source IP addr", ipwidth, "Dest IP addr", "      LQ      ", "ETX");
@@ -704,7 +994,7 @@ olsr_print_tc_table(void)
       struct lqtextbuffer lqbuffer1, lqbuffer2;
 
       OLSR_PRINTF(1, "%-*s %-*s %-14s %s\n", ipwidth, olsr_ip_to_string(&addrbuf, &tc->addr), ipwidth,
-                  olsr_ip_to_string(&dstaddrbuf, &tc_edge->T_dest_addr), get_tc_edge_entry_text(tc_edge, '/', &lqbuffer1),
+                  olsr_ip_to_string(&dstaddrbuf, olsr_node_id_to_addr(tc_edge->T_dest_id)), get_tc_edge_entry_text(tc_edge, '/', &lqbuffer1),
                   get_linkcost_text(tc_edge->cost, false, &lqbuffer2));
 
     } OLSR_FOR_ALL_TC_EDGE_ENTRIES_END(tc, tc_edge);
@@ -735,10 +1025,10 @@ olsr_calculate_tc_border(uint8_t lower_border, union olsr_ip_addr *lower_border_
 
     lower_border--;
     for (i = 0; i < lower_border / 8; i++) {
-      lower_border_ip->v6.s6_addr[olsr_cnf->ipsize - i - 1] = 0;
+      lower_border_ip->v6.s6_addr[OLSR_IPSIZE - i - 1] = 0;
     }
-    lower_border_ip->v6.s6_addr[olsr_cnf->ipsize - lower_border / 8 - 1] &= (0xff << (lower_border & 7));
-    lower_border_ip->v6.s6_addr[olsr_cnf->ipsize - lower_border / 8 - 1] |= (1 << (lower_border & 7));
+    lower_border_ip->v6.s6_addr[OLSR_IPSIZE - lower_border / 8 - 1] &= (0xff << (lower_border & 7));
+    lower_border_ip->v6.s6_addr[OLSR_IPSIZE - lower_border / 8 - 1] |= (1 << (lower_border & 7));
   }
 
   if (upper_border == 0xff) {
@@ -749,10 +1039,10 @@ olsr_calculate_tc_border(uint8_t lower_border, union olsr_ip_addr *lower_border_
     upper_border--;
 
     for (i = 0; i < upper_border / 8; i++) {
-      upper_border_ip->v6.s6_addr[olsr_cnf->ipsize - i - 1] = 0;
+      upper_border_ip->v6.s6_addr[OLSR_IPSIZE - i - 1] = 0;
     }
-    upper_border_ip->v6.s6_addr[olsr_cnf->ipsize - upper_border / 8 - 1] &= (0xff << (upper_border & 7));
-    upper_border_ip->v6.s6_addr[olsr_cnf->ipsize - upper_border / 8 - 1] |= (1 << (upper_border & 7));
+    upper_border_ip->v6.s6_addr[OLSR_IPSIZE - upper_border / 8 - 1] &= (0xff << (upper_border & 7));
+    upper_border_ip->v6.s6_addr[OLSR_IPSIZE - upper_border / 8 - 1] |= (1 << (upper_border & 7));
   }
   return 1;
 }
@@ -777,6 +1067,9 @@ olsr_input_tc(union olsr_message * msg, struct interface * input_if __attribute_
   union olsr_ip_addr originator;
   const unsigned char *limit, *curr;
   struct tc_entry *tc;
+  struct tc_advertised_edge *adv;
+  struct olsr_addr_block block;
+  int count, stride;
   bool emptyTC;
 
   union olsr_ip_addr lower_border_ip, upper_border_ip;
@@ -789,7 +1082,7 @@ olsr_input_tc(union olsr_message * msg, struct interface * input_if __attribute_
 
   /* We are only interested in TC message types. */
   pkt_get_u8(&curr, &type);
-  if ((type != LQ_TC_MESSAGE) && (type != TC_MESSAGE)) {
+  if ((type != LQ_TC_MESSAGE) && (type != TC_MESSAGE) && (type != LQ_TC_COMPACT_MESSAGE)) {
     return false;
   }
 
@@ -818,6 +1111,14 @@ olsr_input_tc(union olsr_message * msg, struct interface * input_if __attribute_
   pkt_get_u8(&curr, &lower_border);
   pkt_get_u8(&curr, &upper_border);
 
+  /* The neighbors of a compact TC are one address block followed by their link qualities */
+  limit = (unsigned char *)msg + size;
+  if (type == LQ_TC_COMPACT_MESSAGE
+      && (!pkt_get_addr_block(&curr, limit, &block) || curr + block.count * olsr_sizeof_tc_lqdata() > limit)) {
+    OLSR_PRINTF(1, "Illegal compact TC from %s\n", olsr_ip_to_string(&buf, &originator));
+    return false;
+  }
+
   tc = olsr_lookup_tc_entry(&originator);
 
   if (vtime < (olsr_reltime)(olsr_cnf->min_tc_vtime*1000)) {
@@ -861,6 +1162,14 @@ olsr_input_tc(union olsr_message * msg, struct interface * input_if __attribute_
    */
   if (!tc) {
     tc = olsr_add_tc_entry(&originator);
+    if (!tc) {
+
+      /*
+       * Over budget. Do not store the originator, but keep flooding.
+       */
+      OLSR_PRINTF(2, "TC: no room for originator %s\n", olsr_ip_to_string(&buf, &originator));
+      return true;
+    }
   }
 
   /*
@@ -872,24 +1181,53 @@ olsr_input_tc(union olsr_message * msg, struct interface * input_if __attribute_
   tc->ignored = 0;
   tc->err_seq_valid = false;
 
+  /*
+   * Only a complete neighbor set is a base for incremental TCs.
+   */
+  tc->delta_base_ansn = ansn;
+  tc->delta_base_valid = lower_border == 0xff && upper_border == 0xff;
+
   OLSR_PRINTF(1, "Processing TC from %s, seq 0x%04x\n", olsr_ip_to_string(&buf, &originator), tc->msg_seq);
 
   /*
    * Now walk the edge advertisements contained in the packet.
    */
 
-  limit = (unsigned char *)msg + size;
-  borderSet = 0;
-  emptyTC = curr >= limit;
-  while (curr < limit) {
-    if (olsr_tc_update_edge(tc, ansn, &curr, &upper_border_ip)) {
-      changes_topology = true;
+  stride = OLSR_IPSIZE + (olsr_cnf->lq_level > 0 ? olsr_sizeof_tc_lqdata() : 0);
+  count = 0;
+  adv = NULL;
+  if (type == LQ_TC_COMPACT_MESSAGE) {
+    emptyTC = block.count == 0;
+    if (!emptyTC) {
+      adv = olsr_parser_arena_alloc(block.count * sizeof(*adv));
     }
-
-    if (!borderSet) {
-      borderSet = 1;
-      memcpy(&lower_border_ip, &upper_border_ip, sizeof(lower_border_ip));
+    for (count = 0; count < block.count; count++) {
+      olsr_addr_block_get(&block, count, &adv[count].addr);
+      adv[count].id = olsr_lookup_node_id(&adv[count].addr);
+      adv[count].lq = curr + count * olsr_sizeof_tc_lqdata();
     }
+  } else {
+    emptyTC = curr >= limit;
+    if (!emptyTC) {
+      adv = olsr_parser_arena_alloc(((limit - curr) / stride + 1) * sizeof(*adv));
+    }
+    while (curr < limit) {
+      pkt_get_ipaddress(&curr, &adv[count].addr);
+      adv[count].id = olsr_lookup_node_id(&adv[count].addr);
+      adv[count].lq = curr;
+      curr += stride - OLSR_IPSIZE;
+      count++;
+    }
+  }
+
+  /*
+   * The borders are the first and the last neighbor in the message.
+   */
+  borderSet = 0;
+  if (count > 0) {
+    borderSet = 1;
+    memcpy(&lower_border_ip, &adv[0].addr, sizeof(lower_border_ip));
+    memcpy(&upper_border_ip, &adv[count - 1].addr, sizeof(upper_border_ip));
   }
 
   /*
@@ -912,13 +1250,15 @@ olsr_input_tc(union olsr_message * msg, struct interface * input_if __attribute_
     borderSet = 1;
   }
 
-  if (borderSet) {
+  /*
+   * Add, update and revoke the edges. Old edges are only
+   * deleted if they are within the borders.
+   */
+  if (olsr_tc_merge_edges(tc, ansn, adv, count, borderSet ? &lower_border_ip : NULL, &upper_border_ip)) {
+    changes_topology = true;
+  }
 
-    /*
-     * Delete all old tc edges within borders.
-     */
-    olsr_delete_revoked_tc_edges(tc, ansn, &lower_border_ip, &upper_border_ip);
-  } else {
+  if (!borderSet) {
 
     /*
      * Kick the the edge garbage collection timer. In the meantime hopefully
@@ -942,6 +1282,115 @@ olsr_input_tc(union olsr_message * msg, struct interface * input_if __attribute_
   return true;
 }
 
+/*
+ * Process an incoming incremental LQ_TC message.
+ *
+ * The message only applies on top of the full TC with its base ansn.
+ * Without that base we cannot use it, but still flood it - the next
+ * full TC of the originator will resync us.
+ */
+bool
+olsr_input_tc_delta(union olsr_message * msg, struct interface * input_if __attribute__ ((unused)), union olsr_ip_addr * from_addr)
+{
+  struct ipaddr_str buf;
+  uint16_t size, msg_seq, ansn, base_ansn, removed;
+  uint8_t type, ttl, msg_hops;
+  olsr_reltime vtime;
+  union olsr_ip_addr originator;
+  const unsigned char *limit, *curr;
+  struct tc_entry *tc;
+  struct tc_advertised_edge *adv;
+  int count;
+
+  curr = (void *)msg;
+  if (!msg) {
+    return false;
+  }
+
+  pkt_get_u8(&curr, &type);
+  if (type != LQ_TC_DELTA_MESSAGE) {
+    return false;
+  }
+
+  /*
+   * Same rule as for full TCs, only accept it from symmetric neighbors.
+   */
+  if (check_neighbor_link(from_addr) != SYM_LINK) {
+    OLSR_PRINTF(2, "Received TC delta from NON SYM neighbor %s\n", olsr_ip_to_string(&buf, from_addr));
+    return false;
+  }
+
+  pkt_get_reltime(&curr, &vtime);
+  pkt_get_u16(&curr, &size);
+
+  pkt_get_ipaddress(&curr, &originator);
+
+  /* Copy header values */
+  pkt_get_u8(&curr, &ttl);
+  pkt_get_u8(&curr, &msg_hops);
+  pkt_get_u16(&curr, &msg_seq);
+  pkt_get_u16(&curr, &ansn);
+  pkt_get_u16(&curr, &base_ansn);
+  pkt_get_u16(&curr, &removed);
+  pkt_ignore_u16(&curr);
+
+  tc = olsr_lookup_tc_entry(&originator);
+  if (!tc || !tc->delta_base_valid || tc->delta_base_ansn != base_ansn) {
+    OLSR_PRINTF(2, "TC delta from %s without base 0x%04x\n", olsr_ip_to_string(&buf, &originator), base_ansn);
+    return true;
+  }
+
+  /* Ignore old and already seen messages */
+  if (!SEQNO_GREATER_THAN(msg_seq, tc->msg_seq)) {
+    return false;
+  }
+
+  if (vtime < (olsr_reltime)(olsr_cnf->min_tc_vtime*1000)) {
+    vtime = (olsr_reltime)(olsr_cnf->min_tc_vtime*1000);
+  }
+
+  tc->msg_hops = msg_hops;
+  tc->msg_seq = msg_seq;
+  tc->ansn = ansn;
+  tc->ignored = 0;
+  tc->err_seq_valid = false;
+
+  OLSR_PRINTF(1, "Processing TC delta from %s, seq 0x%04x\n", olsr_ip_to_string(&buf, &originator), tc->msg_seq);
+
+  /*
+   * Removed neighbors come first and carry no link quality data.
+   */
+  limit = (unsigned char *)msg + size;
+  count = 0;
+  adv = NULL;
+  if (curr < limit) {
+    adv = olsr_parser_arena_alloc(((limit - curr) / OLSR_IPSIZE + 1) * sizeof(*adv));
+  }
+  while (curr < limit) {
+    if (count >= removed && curr + OLSR_IPSIZE + olsr_sizeof_tc_lqdata() > limit) {
+      break;
+    }
+    pkt_get_ipaddress(&curr, &adv[count].addr);
+    adv[count].id = olsr_lookup_node_id(&adv[count].addr);
+    adv[count].lq = NULL;
+    if (count >= removed) {
+      adv[count].lq = curr;
+      curr += olsr_sizeof_tc_lqdata();
+    }
+    count++;
+  }
+
+  olsr_set_timer(&tc->validity_timer, vtime, OLSR_TC_VTIME_JITTER, OLSR_TIMER_ONESHOT, &olsr_expire_tc_entry, tc,
+                 tc_validity_timer_cookie);
+
+  if (olsr_tc_merge_delta(tc, ansn, adv, count)) {
+    changes_topology = true;
+  }
+
+  /* Forward the message */
+  return true;
+}
+
 /*
  * Local Variables:
  * c-basic-offset: 2
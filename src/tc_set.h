@@ -48,6 +48,7 @@
 #include "common/avl.h"
 #include "common/list.h"
 #include "scheduler.h"
+#include "node_id.h"
 
 /*
  * This file holds the definitions for the link state database.
@@ -58,11 +59,13 @@
 
 struct tc_edge_entry {
   struct avl_node edge_node;           /* edge_tree node in tc_entry */
-  union olsr_ip_addr T_dest_addr;      /* edge_node key */
+  olsr_node_id T_dest_id;              /* edge_node key, node id of the destination */
   struct tc_edge_entry *edge_inv;      /* shortcut, used during SPF calculation */
   struct tc_entry *tc;                 /* backpointer to owning tc entry */
   olsr_linkcost cost;                  /* metric used for SPF calculation */
+  uint32_t spf_slot;                   /* slot in the SPF graph view */
   uint16_t ansn;                       /* ansn of this edge, used for multipart msgs */
+  bool delta_added;                    /* added by an incremental TC, not part of its base */
   uint32_t linkquality[0];
 };
 
@@ -71,8 +74,8 @@ AVLNODE2STRUCT(edge_tree2tc_edge, struct tc_edge_entry, edge_node);
 struct tc_entry {
   struct avl_node vertex_node;         /* node keyed by ip address */
   union olsr_ip_addr addr;             /* vertex_node key */
-  struct avl_node cand_tree_node;      /* SPF candidate heap, node keyed by path_etx */
-  olsr_linkcost path_cost;             /* SPF calculated distance, cand_tree_node key */
+  olsr_node_id node_id;                /* node id of addr */
+  olsr_linkcost path_cost;             /* SPF calculated distance */
   struct list_node path_list_node;     /* SPF result list */
   struct avl_tree edge_tree;           /* subtree for edges */
   struct avl_tree prefix_tree;         /* subtree for prefixes */
@@ -88,6 +91,8 @@ struct tc_entry {
                                           (kindof emergency brake) */
   uint16_t err_seq;                    /* sequence number of an unplausible TC */
   bool err_seq_valid;                  /* do we have an error (unplauible seq/ansn) */
+  uint16_t delta_base_ansn;            /* ansn of the last complete TC */
+  bool delta_base_valid;               /* can we apply incremental TCs */
 };
 
 /*
@@ -100,7 +105,6 @@ struct tc_entry {
 #define OLSR_TC_VTIME_JITTER 5          /* percent */
 
 AVLNODE2STRUCT(vertex_tree2tc, struct tc_entry, vertex_node);
-AVLNODE2STRUCT(cand_tree2tc, struct tc_entry, cand_tree_node);
 LISTNODE2STRUCT(pathlist2tc, struct tc_entry, path_list_node);
 
 /*
@@ -140,6 +144,8 @@ LISTNODE2STRUCT(pathlist2tc, struct tc_entry, path_list_node);
 
 extern struct avl_tree tc_tree;
 extern struct tc_entry *tc_myself;
+extern struct olsr_cookie_info *tc_mem_cookie;
+extern struct olsr_cookie_info *tc_edge_mem_cookie;
 
 void olsr_init_tc(void);
 void olsr_delete_all_tc_entries(void);
@@ -153,9 +159,11 @@ void olsr_time_out_tc_set(void);
 
 /* tc msg input parser */
 bool olsr_input_tc(union olsr_message *, struct interface *, union olsr_ip_addr *from);
+bool olsr_input_tc_delta(union olsr_message *, struct interface *, union olsr_ip_addr *from);
 
 /* tc_entry manipulation */
 struct tc_entry *olsr_lookup_tc_entry(union olsr_ip_addr *);
+struct tc_entry *olsr_lookup_tc_entry_by_id(olsr_node_id);
 struct tc_entry *olsr_locate_tc_entry(union olsr_ip_addr *);
 void olsr_lock_tc_entry(struct tc_entry *);
 void olsr_unlock_tc_entry(struct tc_entry *);
@@ -164,6 +172,7 @@ void olsr_unlock_tc_entry(struct tc_entry *);
 bool olsr_delete_outdated_tc_edges(struct tc_entry *);
 char *olsr_tc_edge_to_string(struct tc_edge_entry *);
 struct tc_edge_entry *olsr_lookup_tc_edge(struct tc_entry *, union olsr_ip_addr *);
+struct tc_edge_entry *olsr_lookup_tc_edge_by_id(struct tc_entry *, olsr_node_id);
 struct tc_edge_entry *olsr_add_tc_edge_entry(struct tc_entry *, union olsr_ip_addr *, uint16_t);
 void olsr_delete_tc_entry(struct tc_entry *);
 void olsr_delete_tc_edge_entry(struct tc_edge_entry *);
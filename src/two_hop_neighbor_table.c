@@ -44,6 +44,8 @@
 #include "defs.h"
 #include "mid_set.h"
 #include "neighbor_table.h"
+#include "mpr.h"
+#include "lq_mpr.h"
 #include "net_olsr.h"
 #include "scheduler.h"
 
@@ -85,6 +87,7 @@ olsr_delete_neighbor_pointer(struct neighbor_2_entry *two_hop_entry, struct neig
       /* dequeue */
       DEQUEUE_ELEM(entry_to_delete);
 
+      olsr_lq_mpr_unlink_two_hop(two_hop_entry, entry_to_delete);
       free(entry_to_delete);
     } else {
       entry = entry->next;
@@ -104,6 +107,8 @@ olsr_delete_two_hop_neighbor_table(struct neighbor_2_entry *two_hop_neighbor)
 {
   struct neighbor_list_entry *one_hop_list;
 
+  olsr_lq_mpr_del_two_hop(two_hop_neighbor);
+
   one_hop_list = two_hop_neighbor->neighbor_2_nblist.next;
 
   /* Delete one hop links */
@@ -119,6 +124,7 @@ olsr_delete_two_hop_neighbor_table(struct neighbor_2_entry *two_hop_neighbor)
 
   /* dequeue */
   DEQUEUE_ELEM(two_hop_neighbor);
+  olsr_mpr_del_two_hop(two_hop_neighbor);
   free(two_hop_neighbor);
 }
 
@@ -136,6 +142,7 @@ olsr_insert_two_hop_neighbor_table(struct neighbor_2_entry *two_hop_neighbor)
 
   /* Queue */
   QUEUE_ELEM(two_hop_neighbortable[hash], two_hop_neighbor);
+  olsr_mpr_add_two_hop(two_hop_neighbor);
 }
 
 /**
@@ -210,7 +217,7 @@ olsr_print_two_hop_neighbor_table(void)
 {
   /* The whole function makes no sense without it. */
   int i;
-  const int ipwidth = olsr_cnf->ip_version == AF_INET ? (INET_ADDRSTRLEN - 1) : (INET6_ADDRSTRLEN - 1);
+  const int ipwidth = OLSR_IP_VERSION == AF_INET ? (INET_ADDRSTRLEN - 1) : (INET6_ADDRSTRLEN - 1);
 
   OLSR_PRINTF(1, "\n--- %s ----------------------- TWO-HOP NEIGHBORS\n\n" "IP addr (2-hop)  IP addr (1-hop)  Total cost\n",
               olsr_wallclock_string());
@@ -45,6 +45,7 @@
 #include "defs.h"
 #include "hashing.h"
 #include "lq_plugin.h"
+#include "common/list.h"
 
 #define	NB2S_COVERED 	0x1     /* node has been covered by a MPR */
 
@@ -53,15 +54,18 @@ struct neighbor_list_entry {
   olsr_linkcost second_hop_linkcost;
   olsr_linkcost path_linkcost;
   olsr_linkcost saved_path_linkcost;
+  bool lq_mpr;                         /* neighbor is an LQ MPR for this two hop neighbor */
   struct neighbor_list_entry *next;
   struct neighbor_list_entry *prev;
 };
 
 struct neighbor_2_entry {
   union olsr_ip_addr neighbor_2_addr;
-  uint8_t mpr_covered_count;           /*used in mpr calculation */
-  uint8_t processed;                   /*used in mpr calculation */
+  uint32_t mpr_index;                  /* bit in the reach sets of the neighbors */
   int16_t neighbor_2_pointer;          /* Neighbor count */
+  olsr_linkcost lq_direct;             /* direct link cost seen by the LQ MPR selection */
+  struct list_node lq_changed_node;    /* on the list of entries to reselect, see lq_mpr.c */
+  struct list_node lq_direct_node;     /* on the list of entries which are also neighbors */
   struct neighbor_list_entry neighbor_2_nblist;
   struct neighbor_2_entry *prev;
   struct neighbor_2_entry *next;
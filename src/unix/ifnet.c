@@ -495,6 +495,8 @@ add_hemu_if(struct olsr_if *iface)
   ifp->valtimes.tc = reltime_to_me(iface->cnf->tc_params.validity_time * MSEC_PER_SEC);
   ifp->valtimes.mid = reltime_to_me(iface->cnf->mid_params.validity_time * MSEC_PER_SEC);
   ifp->valtimes.hna = reltime_to_me(iface->cnf->hna_params.validity_time * MSEC_PER_SEC);
+  ifp->hello_factor = 1;
+  ifp->tc_factor = 1;
 
   ifp->mode = iface->cnf->mode;
 
@@ -759,19 +761,16 @@ chk_if_up(struct olsr_if *iface, int debuglvl __attribute__ ((unused)))
   /* initialize backpointer */
   ifp->olsr_if = iface;
 
-  ifp->immediate_send_tc = (iface->cnf->tc_params.emission_interval < iface->cnf->hello_params.emission_interval);
   if (olsr_cnf->max_jitter == 0) {
-    /* max_jitter determines the max time to store to-be-send-messages, correlated with random() */
-    olsr_cnf->max_jitter =
-      ifp->immediate_send_tc ? iface->cnf->tc_params.emission_interval : iface->cnf->hello_params.emission_interval;
+    /* max_jitter determines the max time to store forwarded messages, correlated with random() */
+    olsr_cnf->max_jitter = iface->cnf->tc_params.emission_interval < iface->cnf->hello_params.emission_interval
+      ? iface->cnf->tc_params.emission_interval : iface->cnf->hello_params.emission_interval;
   }
 
   ifp->gen_properties = NULL;
   ifp->int_next = ifnet;
   ifnet = ifp;
 
-  set_buffer_timer(ifp);
-
   /* Register socket */
   add_olsr_socket(ifp->olsr_socket, &olsr_input, NULL, NULL, SP_PR_READ);
   add_olsr_socket(ifp->send_socket, &olsr_input, NULL, NULL, SP_PR_READ);
@@ -839,6 +838,8 @@ chk_if_up(struct olsr_if *iface, int debuglvl __attribute__ ((unused)))
   ifp->valtimes.tc = reltime_to_me(iface->cnf->tc_params.validity_time * MSEC_PER_SEC);
   ifp->valtimes.mid = reltime_to_me(iface->cnf->mid_params.validity_time * MSEC_PER_SEC);
   ifp->valtimes.hna = reltime_to_me(iface->cnf->hna_params.validity_time * MSEC_PER_SEC);
+  ifp->hello_factor = 1;
+  ifp->tc_factor = 1;
 
   ifp->mode = iface->cnf->mode;
 
@@ -595,6 +595,8 @@ add_hemu_if(struct olsr_if *iface)
   ifp->valtimes.tc = reltime_to_me(iface->cnf->tc_params.validity_time * MSEC_PER_SEC);
   ifp->valtimes.mid = reltime_to_me(iface->cnf->mid_params.validity_time * MSEC_PER_SEC);
   ifp->valtimes.hna = reltime_to_me(iface->cnf->hna_params.validity_time * MSEC_PER_SEC);
+  ifp->hello_factor = 1;
+  ifp->tc_factor = 1;
 
   ifp->mode = iface->cnf->mode;
 
@@ -769,11 +771,10 @@ chk_if_up(struct olsr_if *iface, int debuglvl __attribute__ ((unused)))
   New->olsr_if = iface;
 
 
-  New->immediate_send_tc = (iface->cnf->tc_params.emission_interval < iface->cnf->hello_params.emission_interval);
   if (olsr_cnf->max_jitter == 0) {
-    /* max_jitter determines the max time to store to-be-send-messages, correlated with random() */
-    olsr_cnf->max_jitter =
-      New->immediate_send_tc ? iface->cnf->tc_params.emission_interval : iface->cnf->hello_params.emission_interval;
+    /* max_jitter determines the max time to store forwarded messages, correlated with random() */
+    olsr_cnf->max_jitter = iface->cnf->tc_params.emission_interval < iface->cnf->hello_params.emission_interval
+      ? iface->cnf->tc_params.emission_interval : iface->cnf->hello_params.emission_interval;
   }
 
   New->gen_properties = NULL;
@@ -889,6 +890,8 @@ chk_if_up(struct olsr_if *iface, int debuglvl __attribute__ ((unused)))
   New->valtimes.tc = reltime_to_me(iface->cnf->tc_params.validity_time * MSEC_PER_SEC);
   New->valtimes.mid = reltime_to_me(iface->cnf->mid_params.validity_time * MSEC_PER_SEC);
   New->valtimes.hna = reltime_to_me(iface->cnf->hna_params.validity_time * MSEC_PER_SEC);
+  New->hello_factor = 1;
+  New->tc_factor = 1;
 
   New->mode = iface->cnf->mode;
 